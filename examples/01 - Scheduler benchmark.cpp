@@ -0,0 +1,169 @@
+/*
+ * This example shows how long an update of the scheduler takes with 10k
+ * scheduled callbacks. It compares the instance's persistent schedule with
+ * the former approach, which rebuilt and sorted the list of callbacks on
+ * every update. The latter is reproduced here, as it no longer exists in
+ * the library.
+ *
+ * How to compile:
+ * c++ 01\ -\ Scheduler\ benchmark.cpp -std=c++17 -Wall -Wextra -lzuazo -ldl -lpthread
+ */
+
+#include <zuazo/Instance.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*
+ * Benchmark parameters
+ */
+constexpr size_t REGULAR_CALLBACK_COUNT = 8000;
+constexpr size_t PERIODIC_CALLBACK_COUNT = 2000;
+constexpr size_t UPDATE_COUNT = 1000;
+constexpr std::array<int, 3> RATES = { 25, 30, 60 };
+
+static Zuazo::Instance::Priority getPriority(size_t index) {
+	//Spread the callbacks among a few dozen priorities, as elements do
+	return static_cast<Zuazo::Instance::Priority>(index % 32) - 16;
+}
+
+/*
+ * Per update rebuild of the schedule, as it was done before
+ */
+class RebuiltSchedule {
+public:
+	using Callback = Zuazo::Instance::ScheduledCallback;
+	using Priority = Zuazo::Instance::Priority;
+
+	void addRegularCallback(const Callback& cbk, Priority prior) {
+		m_regular.emplace_back(prior, &cbk);
+	}
+
+	void addPeriodicCallback(const Callback& cbk, Priority prior, Zuazo::Duration period) {
+		m_periodic[period].emplace_back(prior, &cbk);
+	}
+
+	void gotoTime(Zuazo::TimePoint tp) {
+		//Gather all the callbacks for this update and sort them
+		m_calls.clear();
+		m_calls.insert(m_calls.cend(), m_regular.cbegin(), m_regular.cend());
+		for(const auto& bucket : m_periodic) {
+			if(tp.time_since_epoch() % bucket.first == Zuazo::Duration::zero()) {
+				m_calls.insert(m_calls.cend(), bucket.second.cbegin(), bucket.second.cend());
+			}
+		}
+
+		std::stable_sort(
+			m_calls.begin(), m_calls.end(),
+			[] (const Entry& a, const Entry& b) -> bool {
+				return a.first > b.first;
+			}
+		);
+
+		for(const auto& call : m_calls) {
+			(*call.second)();
+		}
+	}
+
+	Zuazo::Duration getTimeForNextEvent(Zuazo::TimePoint tp) const {
+		auto result = Zuazo::Duration::max();
+		for(const auto& bucket : m_periodic) {
+			const auto elapsed = tp.time_since_epoch() % bucket.first;
+			result = std::min(result, bucket.first - elapsed);
+		}
+		return result;
+	}
+
+private:
+	using Entry = std::pair<Priority, const Callback*>;
+
+	std::vector<Entry>								m_regular;
+	std::map<Zuazo::Duration, std::vector<Entry>>	m_periodic;
+	std::vector<Entry>								m_calls;
+
+};
+
+int main() {
+	Zuazo::Instance::ApplicationInfo appInfo(
+		"Example 01",								//Application's name
+		Zuazo::Version(0, 1, 0),					//Application's version
+		Zuazo::Verbosity::geqWarning,				//Verbosity
+		{}											//Modules that are going to be used
+	);
+	Zuazo::Instance instance(std::move(appInfo));
+
+	/*
+	 * The callbacks only count their invocations. They are referenced
+	 * by address, so they must not be moved after being added
+	 */
+	uint64_t invocationCount = 0;
+	std::vector<Zuazo::Instance::ScheduledCallback> callbacks(
+		REGULAR_CALLBACK_COUNT + PERIODIC_CALLBACK_COUNT,
+		[&invocationCount] { ++invocationCount; }
+	);
+
+	/*
+	 * Updates only happen when step() is called, so that the loop
+	 * does not interfere with the measurements
+	 */
+	std::unique_lock<Zuazo::Instance> lock(instance);
+	instance.setClockMode(Zuazo::Instance::ClockMode::manual);
+
+	RebuiltSchedule rebuiltSchedule;
+	for(size_t i = 0; i < callbacks.size(); ++i) {
+		if(i < REGULAR_CALLBACK_COUNT) {
+			instance.addRegularCallback(callbacks[i], getPriority(i));
+			rebuiltSchedule.addRegularCallback(callbacks[i], getPriority(i));
+		} else {
+			const auto rate = Zuazo::Rate(RATES[i % RATES.size()], 1);
+			instance.addPeriodicCallback(callbacks[i], getPriority(i), rate);
+			rebuiltSchedule.addPeriodicCallback(callbacks[i], getPriority(i), Zuazo::getPeriod(rate));
+		}
+	}
+
+	/*
+	 * Persistent schedule of the instance
+	 */
+	invocationCount = 0;
+	auto begin = std::chrono::steady_clock::now();
+	for(size_t i = 0; i < UPDATE_COUNT; ++i) {
+		instance.step();
+	}
+	auto end = std::chrono::steady_clock::now();
+	const auto persistentTime = std::chrono::duration<double, std::micro>(end - begin) / UPDATE_COUNT;
+	const auto persistentInvocations = invocationCount;
+
+	/*
+	 * Former schedule, rebuilt on each update. Use the same time points
+	 */
+	invocationCount = 0;
+	Zuazo::TimePoint time;
+	begin = std::chrono::steady_clock::now();
+	for(size_t i = 0; i < UPDATE_COUNT; ++i) {
+		time += rebuiltSchedule.getTimeForNextEvent(time);
+		rebuiltSchedule.gotoTime(time);
+	}
+	end = std::chrono::steady_clock::now();
+	const auto rebuiltTime = std::chrono::duration<double, std::micro>(end - begin) / UPDATE_COUNT;
+	const auto rebuiltInvocations = invocationCount;
+
+	for(size_t i = 0; i < callbacks.size(); ++i) {
+		if(i < REGULAR_CALLBACK_COUNT) {
+			instance.removeRegularCallback(callbacks[i]);
+		} else {
+			instance.removePeriodicCallback(callbacks[i]);
+		}
+	}
+	lock.unlock();
+
+	std::cout << "Callbacks: " << callbacks.size() << " (" << REGULAR_CALLBACK_COUNT << " regular)\n";
+	std::cout << "Persistent schedule: " << persistentTime.count() << "us/update, " << persistentInvocations << " invocations\n";
+	std::cout << "Rebuilt schedule: " << rebuiltTime.count() << "us/update, " << rebuiltInvocations << " invocations\n";
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+/*
+ * This example shows how long control threads wait when changing a layer's
+ * opacity during playback, and how much they delay the updates. A simulated
+ * render callback keeps the instance locked for most of each 60Hz update.
+ * The setters are either called with the instance locked, or posted with
+ * addCommand(), which never waits for the update to finish.
+ *
+ * How to compile:
+ * c++ 02\ -\ Setter\ contention\ benchmark.cpp -std=c++17 -Wall -Wextra -lzuazo -ldl -lpthread
+ */
+
+#include <zuazo/Instance.h>
+#include <zuazo/VideoLayer.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Benchmark parameters
+ */
+constexpr std::array<size_t, 4> CONTROL_THREAD_COUNTS = { 1, 2, 4, 8 };
+constexpr size_t SETTER_CALL_COUNT = 2000;
+constexpr auto RENDER_TIME = std::chrono::milliseconds(10);
+constexpr auto SETTER_INTERVAL = std::chrono::microseconds(500);
+
+struct Result {
+	std::chrono::duration<double, std::micro>	averageWait;
+	std::chrono::duration<double, std::micro>	maximumWait;
+	size_t										updateCount;
+	size_t										deadlineMissCount;
+};
+
+static void spinFor(std::chrono::steady_clock::duration duration) {
+	const auto deadline = std::chrono::steady_clock::now() + duration;
+	while(std::chrono::steady_clock::now() < deadline);
+}
+
+static Result run(Zuazo::Instance& instance, Zuazo::VideoLayer& layer, size_t threadCount, bool useCommands) {
+	std::unique_lock<Zuazo::Instance> lock(instance);
+	instance.clearProfilingStatistics();
+	lock.unlock();
+
+	/*
+	 * Each control thread changes the opacity at a steady pace and
+	 * measures how long each of the calls takes to return
+	 */
+	std::vector<std::chrono::steady_clock::duration> waits(threadCount * SETTER_CALL_COUNT);
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for(size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back(
+			[&instance, &layer, &waits, i, useCommands] {
+				for(size_t j = 0; j < SETTER_CALL_COUNT; ++j) {
+					const auto opacity = static_cast<float>(j % 100) / 100.0f;
+
+					const auto begin = std::chrono::steady_clock::now();
+					if(useCommands) {
+						instance.addCommand([&layer, opacity] { layer.setOpacity(opacity); });
+					} else {
+						std::lock_guard<Zuazo::Instance> lock(instance);
+						layer.setOpacity(opacity);
+					}
+					const auto end = std::chrono::steady_clock::now();
+
+					waits[i*SETTER_CALL_COUNT + j] = end - begin;
+					std::this_thread::sleep_for(SETTER_INTERVAL);
+				}
+			}
+		);
+	}
+
+	for(auto& thread : threads) {
+		thread.join();
+	}
+
+	//Commands are executed in order, so once this one runs all the setters have been applied
+	std::promise<void> applied;
+	instance.addCommand([&applied] { applied.set_value(); });
+	applied.get_future().wait();
+
+	lock.lock();
+	Result result;
+	result.averageWait = std::chrono::steady_clock::duration::zero();
+	result.maximumWait = std::chrono::steady_clock::duration::zero();
+	for(const auto& wait : waits) {
+		result.averageWait += wait;
+		result.maximumWait = std::max(result.maximumWait, std::chrono::duration<double, std::micro>(wait));
+	}
+	result.averageWait /= waits.size();
+	result.updateCount = instance.getProfiledUpdateCount();
+	result.deadlineMissCount = instance.getDeadlineMissCount();
+
+	return result;
+}
+
+int main() {
+	Zuazo::Instance::ApplicationInfo appInfo(
+		"Example 02",								//Application's name
+		Zuazo::Version(0, 1, 0),					//Application's version
+		Zuazo::Verbosity::geqWarning,				//Verbosity
+		{}											//Modules that are going to be used
+	);
+	Zuazo::Instance instance(std::move(appInfo));
+
+	Zuazo::VideoLayer layer(instance.getVulkan());
+
+	/*
+	 * Simulate the rendering of the layer, which takes most of the
+	 * update's budget. Updates taking longer than the period are
+	 * counted as deadline misses
+	 */
+	volatile float renderedOpacity;
+	const Zuazo::Instance::ScheduledCallback render = [&layer, &renderedOpacity] {
+		renderedOpacity = layer.getOpacity();
+		spinFor(RENDER_TIME);
+	};
+
+	std::unique_lock<Zuazo::Instance> lock(instance);
+	instance.addPeriodicCallback(render, Zuazo::Instance::consumerPriority, Zuazo::Rate(60, 1));
+	instance.setProfilingEnabled(true);
+	lock.unlock();
+
+	for(const auto threadCount : CONTROL_THREAD_COUNTS) {
+		for(const auto useCommands : { false, true }) {
+			const auto result = run(instance, layer, threadCount, useCommands);
+
+			std::cout 	<< threadCount << " control threads, "
+						<< (useCommands ? "addCommand()" : "locked instance") << ": "
+						<< "average wait " << result.averageWait.count() << "us, "
+						<< "maximum wait " << result.maximumWait.count() << "us, "
+						<< result.deadlineMissCount << "/" << result.updateCount << " updates late\n";
+		}
+	}
+
+	lock.lock();
+	instance.removePeriodicCallback(render);
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+ * This example shows how fast a composition can be processed when the
+ * instance runs on a virtual clock. A simulated 60Hz consumer performs a
+ * fixed amount of work for a given amount of frames, which are rendered as
+ * fast as possible instead of at the pace of the system clock. Results are
+ * reproducible, as every run processes the same frames at the same virtual
+ * time points. The checksum of all of them is printed to show it.
+ *
+ * How to compile:
+ * c++ 03\ -\ Virtual\ time\ throughput\ benchmark.cpp -std=c++17 -Wall -Wextra -lzuazo -ldl -lpthread
+ */
+
+#include <zuazo/Instance.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+/*
+ * Benchmark parameters
+ */
+constexpr size_t FRAME_COUNT = 600; //10s at 60Hz
+constexpr size_t FRAME_SIZE = 1920*1080;
+constexpr size_t RUN_COUNT = 3;
+
+int main() {
+	Zuazo::Instance::ApplicationInfo appInfo(
+		"Example 03",								//Application's name
+		Zuazo::Version(0, 1, 0),					//Application's version
+		Zuazo::Verbosity::geqWarning,				//Verbosity
+		{}											//Modules that are going to be used
+	);
+	Zuazo::Instance instance(std::move(appInfo));
+
+	std::vector<uint8_t> frame(FRAME_SIZE);
+	size_t frameCount;
+	uint64_t checksum;
+	std::promise<void> finished;
+
+	/*
+	 * The consumer "renders" a frame which depends on its index, so that 
+	 * the checksum reveals any difference among runs. In virtual time,
+	 * updates must be exactly one period apart. Once all the frames are 
+	 * processed, the clock is stopped
+	 */
+	const auto period = Zuazo::getPeriod(Zuazo::Rate(60, 1));
+	size_t irregularCount;
+	const Zuazo::Instance::ScheduledCallback consumer = [&] {
+		if(frameCount > 0 && instance.getDeltaT() != period) {
+			++irregularCount;
+		}
+
+		for(size_t i = 0; i < frame.size(); ++i) {
+			frame[i] = static_cast<uint8_t>(frameCount + i);
+			checksum = checksum*31 + frame[i];
+		}
+
+		if(++frameCount == FRAME_COUNT) {
+			instance.setClockMode(Zuazo::Instance::ClockMode::manual);
+			finished.set_value();
+		}
+	};
+
+	std::unique_lock<Zuazo::Instance> lock(instance);
+	instance.setClockMode(Zuazo::Instance::ClockMode::manual);
+	instance.addPeriodicCallback(consumer, Zuazo::Instance::consumerPriority, Zuazo::Rate(60, 1));
+	lock.unlock();
+
+	for(size_t i = 0; i < RUN_COUNT; ++i) {
+		lock.lock();
+		frameCount = 0;
+		irregularCount = 0;
+		checksum = 0;
+		finished = std::promise<void>();
+		auto future = finished.get_future();
+
+		const auto begin = std::chrono::steady_clock::now();
+		instance.setClockMode(Zuazo::Instance::ClockMode::virtualTime);
+		lock.unlock();
+
+		future.wait();
+		const auto end = std::chrono::steady_clock::now();
+
+		const auto elapsed = std::chrono::duration<double>(end - begin);
+		const auto virtualDuration = static_cast<double>(FRAME_COUNT) / 60.0;
+		std::cout 	<< "Run " << i << ": " << FRAME_COUNT << " frames in " << elapsed.count() << "s, "
+					<< FRAME_COUNT / elapsed.count() << " frames/s, "
+					<< virtualDuration / elapsed.count() << "x real time, "
+					<< irregularCount << " irregular updates, "
+					<< "checksum " << std::hex << checksum << std::dec << "\n";
+	}
+
+	lock.lock();
+	instance.removePeriodicCallback(consumer);
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+/*
+ * This example shows how much the on-disk pipeline cache shortens startup.
+ * The instance is created twice: first with no cache file (cold), which is
+ * saved when the instance is destroyed, and then loading it (warm). Each
+ * time, the staged frames and downloaders of a few common formats are
+ * created, which compiles their pipelines.
+ *
+ * Note that some drivers also keep a shader cache of their own, which
+ * makes cold starts look warm. For instance, Mesa's can be disabled by
+ * setting MESA_SHADER_CACHE_DISABLE=true.
+ *
+ * How to compile:
+ * c++ 04\ -\ Pipeline\ cache\ benchmark.cpp -std=c++17 -Wall -Wextra -lzuazo -ldl -lpthread
+ *
+ * Usage:
+ * ./a.out [cache path]
+ */
+
+#include <zuazo/Instance.h>
+#include <zuazo/Graphics/Downloader.h>
+#include <zuazo/Graphics/StagedFramePool.h>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/*
+ * Benchmark parameters
+ */
+constexpr std::array FORMATS = {
+	std::make_tuple(Zuazo::ColorFormat::B8G8R8A8, Zuazo::ColorModel::rgb, Zuazo::ColorSubsampling::rb444),
+	std::make_tuple(Zuazo::ColorFormat::G8_B8_R8, Zuazo::ColorModel::bt709, Zuazo::ColorSubsampling::rb420),
+	std::make_tuple(Zuazo::ColorFormat::G8_B8R8, Zuazo::ColorModel::bt709, Zuazo::ColorSubsampling::rb420),
+	std::make_tuple(Zuazo::ColorFormat::G8B8G8R8, Zuazo::ColorModel::bt709, Zuazo::ColorSubsampling::rb422),
+};
+
+constexpr std::array TRANSFER_FUNCTIONS = {
+	Zuazo::ColorTransferFunction::bt1886,
+	Zuazo::ColorTransferFunction::iec61966_2_1,
+};
+
+static std::chrono::duration<double, std::milli> measureStartup(const std::string& cachePath) {
+	const auto begin = std::chrono::steady_clock::now();
+
+	Zuazo::Instance::ApplicationInfo appInfo(
+		"Example 04",								//Application's name
+		Zuazo::Version(0, 1, 0),					//Application's version
+		Zuazo::Verbosity::geqWarning,				//Verbosity
+		{}											//Modules that are going to be used
+	);
+	appInfo.setPipelineCachePath(cachePath);
+	Zuazo::Instance instance(std::move(appInfo));
+	const auto& vulkan = instance.getVulkan();
+
+	/*
+	 * Create the frames and downloaders as elements would do when
+	 * opened. Combinations unsupported by the device are skipped
+	 */
+	std::vector<std::unique_ptr<Zuazo::Graphics::StagedFramePool>> stagedFramePools;
+	std::vector<std::unique_ptr<Zuazo::Graphics::Downloader>> downloaders;
+	for(const auto& format : FORMATS) {
+		for(const auto transferFunction : TRANSFER_FUNCTIONS) {
+			const Zuazo::Graphics::Frame::Descriptor frameDesc(
+				Zuazo::Resolution(1920, 1080),
+				Zuazo::AspectRatio(1, 1),
+				Zuazo::ColorPrimaries::bt709,
+				std::get<Zuazo::ColorModel>(format),
+				transferFunction,
+				std::get<Zuazo::ColorSubsampling>(format),
+				Zuazo::Math::Vec2<Zuazo::ColorChromaLocation>(Zuazo::ColorChromaLocation::midpoint, Zuazo::ColorChromaLocation::midpoint),
+				Zuazo::ColorRange::ituNarrow,
+				std::get<Zuazo::ColorFormat>(format)
+			);
+
+			try {
+				stagedFramePools.emplace_back(std::make_unique<Zuazo::Graphics::StagedFramePool>(vulkan, frameDesc));
+				stagedFramePools.back()->acquireFrame();
+			} catch(const std::exception& e) {
+				std::cerr << "Skipping staged frame: " << e.what() << "\n";
+			}
+
+			try {
+				downloaders.emplace_back(std::make_unique<Zuazo::Graphics::Downloader>(vulkan, frameDesc, Zuazo::DepthStencilFormat::none));
+			} catch(const std::exception& e) {
+				std::cerr << "Skipping downloader: " << e.what() << "\n";
+			}
+		}
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	//The cache is saved when the instance is destroyed, which is not measured
+	return end - begin;
+}
+
+int main(int argc, const char* argv[]) {
+	const std::string cachePath = (argc > 1) ? argv[1] : "zuazo_pipeline_cache.bin";
+
+	//Start cold
+	std::remove(cachePath.c_str());
+	const auto coldTime = measureStartup(cachePath);
+	const auto warmTime = measureStartup(cachePath);
+
+	std::cout << "Cold startup: " << coldTime.count() << "ms\n";
+	std::cout << "Warm startup: " << warmTime.count() << "ms\n";
+}
\ No newline at end of file
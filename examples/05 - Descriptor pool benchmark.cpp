@@ -0,0 +1,111 @@
+/*
+ * This example shows how many descriptor pools are created per second of
+ * playback. A simulated 60Hz source uploads a new frame on every update and
+ * keeps the last few ones alive, as consumers would. Every few seconds the
+ * resolution changes, so the frame pool is replaced by a new one. Once the
+ * frame pools are warm the rate should remain at zero, as descriptor sets
+ * are recycled instead of allocating new pools.
+ *
+ * How to compile:
+ * c++ 05\ -\ Descriptor\ pool\ benchmark.cpp -std=c++17 -Wall -Wextra -lzuazo -ldl -lpthread
+ */
+
+#include <zuazo/Instance.h>
+#include <zuazo/Graphics/StagedFramePool.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/*
+ * Benchmark parameters
+ */
+constexpr size_t DURATION_SECONDS = 10;
+constexpr size_t FRAMES_IN_FLIGHT = 3;
+constexpr size_t RESOLUTION_CHANGE_INTERVAL = 2*60; //In frames
+constexpr std::array RESOLUTIONS = {
+	Zuazo::Resolution(1920, 1080),
+	Zuazo::Resolution(1280, 720),
+};
+
+static Zuazo::Graphics::Frame::Descriptor createFrameDescriptor(Zuazo::Resolution resolution) {
+	return Zuazo::Graphics::Frame::Descriptor(
+		resolution,
+		Zuazo::AspectRatio(1, 1),
+		Zuazo::ColorPrimaries::bt709,
+		Zuazo::ColorModel::bt709,
+		Zuazo::ColorTransferFunction::bt1886,
+		Zuazo::ColorSubsampling::rb420,
+		Zuazo::Math::Vec2<Zuazo::ColorChromaLocation>(Zuazo::ColorChromaLocation::midpoint, Zuazo::ColorChromaLocation::midpoint),
+		Zuazo::ColorRange::ituNarrow,
+		Zuazo::ColorFormat::G8_B8_R8
+	);
+}
+
+int main() {
+	Zuazo::Instance::ApplicationInfo appInfo(
+		"Example 05",								//Application's name
+		Zuazo::Version(0, 1, 0),					//Application's version
+		Zuazo::Verbosity::geqWarning,				//Verbosity
+		{}											//Modules that are going to be used
+	);
+	Zuazo::Instance instance(std::move(appInfo));
+	const auto& vulkan = instance.getVulkan();
+
+	/*
+	 * Upload a frame on each update. The pool is replaced when the
+	 * resolution changes, which destroys all its frames
+	 */
+	size_t frameCount = 0;
+	std::unique_ptr<Zuazo::Graphics::StagedFramePool> framePool;
+	std::deque<std::shared_ptr<Zuazo::Graphics::StagedFrame>> frames;
+	const Zuazo::Instance::ScheduledCallback source = [&] {
+		if(frameCount % RESOLUTION_CHANGE_INTERVAL == 0) {
+			const auto resolution = RESOLUTIONS[(frameCount / RESOLUTION_CHANGE_INTERVAL) % RESOLUTIONS.size()];
+			frames.clear();
+			framePool = std::make_unique<Zuazo::Graphics::StagedFramePool>(vulkan, createFrameDescriptor(resolution));
+		}
+
+		auto frame = framePool->acquireFrame();
+		for(const auto& plane : frame->getPixelData()) {
+			std::fill(plane.begin(), plane.end(), static_cast<std::byte>(frameCount));
+		}
+		frame->flush();
+
+		frames.emplace_back(std::move(frame));
+		if(frames.size() > FRAMES_IN_FLIGHT) {
+			frames.pop_front();
+		}
+
+		++frameCount;
+	};
+
+	std::unique_lock<Zuazo::Instance> lock(instance);
+	instance.addPeriodicCallback(source, Zuazo::Instance::sourcePriority, Zuazo::Rate(60, 1));
+	lock.unlock();
+
+	/*
+	 * Sample the amount of created pools once per second
+	 */
+	auto previousCount = vulkan.getCreatedDescriptorPoolCount();
+	for(size_t i = 0; i < DURATION_SECONDS; ++i) {
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+
+		const auto count = vulkan.getCreatedDescriptorPoolCount();
+		std::cout << "Second " << i << ": " << count - previousCount << " descriptor pools created\n";
+		previousCount = count;
+	}
+
+	lock.lock();
+	instance.removePeriodicCallback(source);
+	frames.clear();
+	framePool.reset();
+
+	std::cout << "Total: " << vulkan.getCreatedDescriptorPoolCount() << " descriptor pools\n";
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+/*
+ * This example shows how fast rendered frames can be read back to host
+ * memory with a Downloader. Each frame is cleared on the GPU and read back
+ * through the downloader's ring, while the frame drawn ring size draws ago
+ * is copied out as an encoder would do. It is meant to be run on software
+ * drivers (such as lavapipe) too, by selecting them with VK_ICD_FILENAMES.
+ *
+ * How to compile:
+ * c++ 06\ -\ Downloader\ benchmark.cpp -std=c++17 -Wall -Wextra -lzuazo -ldl -lpthread
+ */
+
+#include <zuazo/Instance.h>
+#include <zuazo/Graphics/CommandBufferPool.h>
+#include <zuazo/Graphics/Downloader.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/*
+ * Benchmark parameters
+ */
+constexpr size_t FRAME_COUNT = 300;
+constexpr size_t RING_SIZE = Zuazo::Graphics::Downloader::DEFAULT_RING_SIZE;
+constexpr std::array RESOLUTIONS = {
+	Zuazo::Resolution(1920, 1080),
+	Zuazo::Resolution(3840, 2160),
+};
+constexpr std::array FORMATS = {
+	std::make_tuple(Zuazo::ColorFormat::B8G8R8A8, Zuazo::ColorModel::rgb, Zuazo::ColorSubsampling::rb444),
+	std::make_tuple(Zuazo::ColorFormat::G8_B8_R8, Zuazo::ColorModel::bt709, Zuazo::ColorSubsampling::rb420),
+};
+
+static void run(const Zuazo::Graphics::Vulkan& vulkan, const Zuazo::Graphics::Frame::Descriptor& frameDesc) {
+	Zuazo::Graphics::Downloader downloader(vulkan, frameDesc, Zuazo::DepthStencilFormat::none, RING_SIZE);
+	Zuazo::Graphics::CommandBufferPool commandBufferPool(
+		vulkan,
+		vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+		vulkan.getGraphicsQueueIndex(),
+		vk::CommandBufferLevel::ePrimary
+	);
+
+	const auto resolution = frameDesc.getResolution();
+	const vk::Rect2D renderArea({0, 0}, {resolution.width, resolution.height});
+	const auto clearValues = Zuazo::Graphics::RenderPass::getClearValues(Zuazo::DepthStencilFormat::none);
+	std::vector<std::byte> encoderInput;
+
+	size_t byteCount = 0;
+	const auto begin = std::chrono::steady_clock::now();
+	for(size_t i = 0; i < FRAME_COUNT + RING_SIZE - 1; ++i) {
+		if(i < FRAME_COUNT) {
+			//Render a frame. Only the clear is recorded
+			auto cmd = commandBufferPool.acquireCommandBuffer();
+			cmd->begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+			downloader.beginRenderPass(cmd->get(), renderArea, clearValues, vk::SubpassContents::eInline);
+			downloader.getRenderPass().finalize(*cmd);
+			downloader.endRenderPass(cmd->get());
+			cmd->end();
+
+			downloader.draw(std::move(cmd));
+		}
+
+		if(i >= RING_SIZE - 1) {
+			//Copy out the oldest download of the ring
+			const auto id = i - (RING_SIZE - 1);
+			downloader.waitCompletion(id, Zuazo::Graphics::Vulkan::NO_TIMEOUT);
+
+			for(const auto& plane : downloader.getPixelData(id)) {
+				encoderInput.resize(plane.size());
+				std::memcpy(encoderInput.data(), plane.data(), plane.size());
+				byteCount += plane.size();
+			}
+		}
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	const auto elapsed = std::chrono::duration<double>(end - begin);
+	std::cout 	<< resolution << " " << frameDesc.getColorFormat() << ": "
+				<< FRAME_COUNT / elapsed.count() << " frames/s, "
+				<< byteCount / elapsed.count() / 1e6 << " MB/s\n";
+}
+
+int main() {
+	Zuazo::Instance::ApplicationInfo appInfo(
+		"Example 06",								//Application's name
+		Zuazo::Version(0, 1, 0),					//Application's version
+		Zuazo::Verbosity::geqWarning,				//Verbosity
+		{}											//Modules that are going to be used
+	);
+	Zuazo::Instance instance(std::move(appInfo));
+	const auto& vulkan = instance.getVulkan();
+
+	//Keep the main loop from submitting the batches concurrently
+	std::lock_guard<Zuazo::Instance> lock(instance);
+
+	for(const auto& resolution : RESOLUTIONS) {
+		for(const auto& format : FORMATS) {
+			const Zuazo::Graphics::Frame::Descriptor frameDesc(
+				resolution,
+				Zuazo::AspectRatio(1, 1),
+				Zuazo::ColorPrimaries::bt709,
+				std::get<Zuazo::ColorModel>(format),
+				Zuazo::ColorTransferFunction::bt1886,
+				std::get<Zuazo::ColorSubsampling>(format),
+				Zuazo::Math::Vec2<Zuazo::ColorChromaLocation>(Zuazo::ColorChromaLocation::midpoint, Zuazo::ColorChromaLocation::midpoint),
+				Zuazo::ColorRange::ituNarrow,
+				std::get<Zuazo::ColorFormat>(format)
+			);
+
+			run(vulkan, frameDesc);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+/*
+ * This example shows the upload throughput of staged frames in formats the
+ * GPU usually can not sample directly, which are repacked on the CPU when
+ * flushed. Fully planar G8_B8_R8 is also measured as the baseline without
+ * repacking. Formats which the device supports natively are not repacked,
+ * so they will perform as the baseline. Each format is measured at 1080p
+ * and 4K.
+ *
+ * How to compile:
+ * c++ 07\ -\ Pixel\ repacking\ benchmark.cpp -std=c++17 -Wall -Wextra -lzuazo -ldl -lpthread
+ */
+
+#include <zuazo/Instance.h>
+#include <zuazo/Graphics/StagedFramePool.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <tuple>
+
+/*
+ * Benchmark parameters
+ */
+constexpr size_t FRAME_COUNT = 200;
+constexpr std::array RESOLUTIONS = {
+	Zuazo::Resolution(1920, 1080),
+	Zuazo::Resolution(3840, 2160),
+};
+constexpr std::array FORMATS = {
+	std::make_tuple(Zuazo::ColorFormat::G8_B8_R8, Zuazo::ColorSubsampling::rb420),					//Baseline
+	std::make_tuple(Zuazo::ColorFormat::G8B8G8R8, Zuazo::ColorSubsampling::rb422),					//YUY2
+	std::make_tuple(Zuazo::ColorFormat::B8G8R8G8, Zuazo::ColorSubsampling::rb422),					//UYVY
+	std::make_tuple(Zuazo::ColorFormat::G10X6B10X6G10X6R10X6_16, Zuazo::ColorSubsampling::rb422),	//Y210
+	std::make_tuple(Zuazo::ColorFormat::G8_B8R8, Zuazo::ColorSubsampling::rb420),					//NV12
+	std::make_tuple(Zuazo::ColorFormat::G10X6_B10X6R10X6_16, Zuazo::ColorSubsampling::rb420),		//P010
+};
+
+static void run(const Zuazo::Graphics::Vulkan& vulkan, const Zuazo::Graphics::Frame::Descriptor& frameDesc) {
+	Zuazo::Graphics::StagedFramePool framePool(vulkan, frameDesc);
+
+	size_t byteCount = 0;
+	std::chrono::steady_clock::duration flushTime = std::chrono::steady_clock::duration::zero();
+	for(size_t i = 0; i < FRAME_COUNT; ++i) {
+		auto frame = framePool.acquireFrame();
+		for(const auto& plane : frame->getPixelData()) {
+			std::fill(plane.begin(), plane.end(), static_cast<std::byte>(i));
+			byteCount += plane.size();
+		}
+
+		//Only measure the repacking and the submission of the upload
+		const auto begin = std::chrono::steady_clock::now();
+		frame->flush();
+		const auto end = std::chrono::steady_clock::now();
+		flushTime += end - begin;
+
+		frame->waitCompletion(Zuazo::Graphics::Vulkan::NO_TIMEOUT);
+	}
+
+	const auto elapsed = std::chrono::duration<double>(flushTime);
+	std::cout 	<< frameDesc.getResolution() << " " << frameDesc.getColorFormat() << ": "
+				<< FRAME_COUNT / elapsed.count() << " frames/s, "
+				<< byteCount / elapsed.count() / 1e6 << " MB/s\n";
+}
+
+int main() {
+	Zuazo::Instance::ApplicationInfo appInfo(
+		"Example 07",								//Application's name
+		Zuazo::Version(0, 1, 0),					//Application's version
+		Zuazo::Verbosity::geqWarning,				//Verbosity
+		{}											//Modules that are going to be used
+	);
+	Zuazo::Instance instance(std::move(appInfo));
+	const auto& vulkan = instance.getVulkan();
+	const auto supportedFormats = Zuazo::Graphics::StagedFrame::getSupportedFormats(vulkan);
+
+	//Keep the main loop from submitting the batches concurrently
+	std::lock_guard<Zuazo::Instance> lock(instance);
+
+	for(const auto& resolution : RESOLUTIONS) {
+		for(const auto& format : FORMATS) {
+			const auto colorFormat = std::get<Zuazo::ColorFormat>(format);
+			if(std::find(supportedFormats.cbegin(), supportedFormats.cend(), colorFormat) == supportedFormats.cend()) {
+				std::cout << resolution << " " << colorFormat << ": not supported\n";
+				continue;
+			}
+
+			const Zuazo::Graphics::Frame::Descriptor frameDesc(
+				resolution,
+				Zuazo::AspectRatio(1, 1),
+				Zuazo::ColorPrimaries::bt709,
+				Zuazo::ColorModel::bt709,
+				Zuazo::ColorTransferFunction::bt1886,
+				std::get<Zuazo::ColorSubsampling>(format),
+				Zuazo::Math::Vec2<Zuazo::ColorChromaLocation>(Zuazo::ColorChromaLocation::midpoint, Zuazo::ColorChromaLocation::midpoint),
+				Zuazo::ColorRange::ituNarrow,
+				colorFormat
+			);
+
+			run(vulkan, frameDesc);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+/*
+ * This example shows how recording the layers of a renderer scales with the
+ * amount of recording threads. A minimal offscreen renderer draws a few
+ * hundred video layers into a Downloader with 0 (serial) to 16 recording
+ * threads. For each of them, the time spent in RendererBase::draw() is
+ * measured and the downloaded image is compared with the serial one, as
+ * both must be byte-identical.
+ *
+ * How to compile:
+ * c++ 08\ -\ Parallel\ recording\ benchmark.cpp -std=c++17 -Wall -Wextra -lzuazo -ldl -lpthread
+ */
+
+#include <zuazo/Instance.h>
+#include <zuazo/RendererBase.h>
+#include <zuazo/VideoLayer.h>
+#include <zuazo/Graphics/CommandBufferPool.h>
+#include <zuazo/Graphics/Downloader.h>
+#include <zuazo/Graphics/StagedFramePool.h>
+#include <zuazo/Graphics/UniformBuffer.h>
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+ * Benchmark parameters
+ */
+constexpr size_t LAYER_COUNT = 512;
+constexpr size_t FRAME_COUNT = 100;
+constexpr std::array<size_t, 6> RECORDING_THREAD_COUNTS = { 0, 1, 2, 4, 8, 16 };
+constexpr Zuazo::Resolution RESOLUTION(1920, 1080);
+
+/*
+ * Renderer drawing into a Downloader. The projection matrix is written
+ * once, as neither the camera nor the viewport change
+ */
+class OffscreenRenderer : public Zuazo::RendererBase {
+public:
+	OffscreenRenderer(const Zuazo::Graphics::Vulkan& vulkan, const Zuazo::Graphics::Downloader& downloader)
+		: m_vulkan(vulkan)
+		, m_uniformBuffer(vulkan, getUniformBufferSizes())
+		, m_descriptorSet(vulkan.allocateDescriptorSet(getDescriptorSetLayout(vulkan), getDescriptorPoolSizes()))
+	{
+		const Zuazo::Math::Vec2f size(RESOLUTION.width, RESOLUTION.height);
+		setViewportSize(size);
+		setRenderPass(downloader.getRenderPass().get());
+
+		const auto projectionMatrix = getCamera().calculateMatrix(size);
+		m_uniformBuffer.writeDescirptorSet(vulkan, *m_descriptorSet);
+		m_uniformBuffer.write(vulkan, DESCRIPTOR_BINDING_PROJECTION_MATRIX, &projectionMatrix, sizeof(projectionMatrix));
+		m_uniformBuffer.flush(vulkan);
+		m_uniformBuffer.waitCompletion(vulkan);
+		setDescriptorSet(*m_descriptorSet);
+
+		//Secondary command buffers need the same state as the primary one
+		setSecondaryCommandBufferCallback(
+			[this] (const Zuazo::RendererBase&, Zuazo::Graphics::CommandBuffer& cmd) {
+				recordState(cmd);
+			}
+		);
+	}
+
+	void recordState(Zuazo::Graphics::CommandBuffer& cmd) const {
+		const vk::Viewport viewport(
+			0.0f, 0.0f,
+			static_cast<float>(RESOLUTION.width), static_cast<float>(RESOLUTION.height),
+			0.0f, 1.0f
+		);
+		const vk::Rect2D scissor({0, 0}, {RESOLUTION.width, RESOLUTION.height});
+
+		cmd.setViewport(0, viewport);
+		cmd.setScissor(0, scissor);
+		cmd.bindDescriptorSets(
+			vk::PipelineBindPoint::eGraphics,
+			getBasePipelineLayout(m_vulkan),
+			DESCRIPTOR_SET,
+			*m_descriptorSet,
+			{}
+		);
+	}
+
+private:
+	const Zuazo::Graphics::Vulkan&				m_vulkan;
+	Zuazo::Graphics::UniformBuffer				m_uniformBuffer;
+	Zuazo::Graphics::Vulkan::PooledDescriptorSet m_descriptorSet;
+
+};
+
+struct FrameResult {
+	std::chrono::steady_clock::duration	recordingTime;
+	uint64_t							id;
+};
+
+static FrameResult drawFrame(	OffscreenRenderer& renderer,
+								Zuazo::Graphics::Downloader& downloader,
+								const Zuazo::Graphics::CommandBufferPool& commandBufferPool )
+{
+	const vk::Rect2D renderArea({0, 0}, {RESOLUTION.width, RESOLUTION.height});
+	const auto clearValues = Zuazo::Graphics::RenderPass::getClearValues(Zuazo::DepthStencilFormat::none);
+	const auto contents = renderer.getSubpassContents();
+
+	auto cmd = commandBufferPool.acquireCommandBuffer();
+	cmd->begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+	downloader.beginRenderPass(cmd->get(), renderArea, clearValues, contents);
+	if(contents == vk::SubpassContents::eInline) {
+		renderer.recordState(*cmd);
+	}
+
+	const auto begin = std::chrono::steady_clock::now();
+	renderer.draw(*cmd);
+	const auto end = std::chrono::steady_clock::now();
+
+	downloader.getRenderPass().finalize(*cmd);
+	downloader.endRenderPass(cmd->get());
+	cmd->end();
+
+	const auto id = downloader.draw(std::move(cmd));
+	downloader.waitCompletion(id, Zuazo::Graphics::Vulkan::NO_TIMEOUT);
+	return FrameResult{ end - begin, id };
+}
+
+static std::vector<std::byte> copyPixelData(const Zuazo::Graphics::Downloader& downloader, uint64_t id) {
+	std::vector<std::byte> result;
+	for(const auto& plane : downloader.getPixelData(id)) {
+		result.insert(result.cend(), plane.cbegin(), plane.cend());
+	}
+	return result;
+}
+
+int main() {
+	Zuazo::Instance::ApplicationInfo appInfo(
+		"Example 08",								//Application's name
+		Zuazo::Version(0, 1, 0),					//Application's version
+		Zuazo::Verbosity::geqWarning,				//Verbosity
+		{}											//Modules that are going to be used
+	);
+	Zuazo::Instance instance(std::move(appInfo));
+	const auto& vulkan = instance.getVulkan();
+
+	//Keep the main loop from submitting the batches concurrently
+	std::lock_guard<Zuazo::Instance> lock(instance);
+
+	const Zuazo::Graphics::Frame::Descriptor frameDesc(
+		RESOLUTION,
+		Zuazo::AspectRatio(1, 1),
+		Zuazo::ColorPrimaries::bt709,
+		Zuazo::ColorModel::rgb,
+		Zuazo::ColorTransferFunction::iec61966_2_1,
+		Zuazo::ColorSubsampling::rb444,
+		Zuazo::Math::Vec2<Zuazo::ColorChromaLocation>(Zuazo::ColorChromaLocation::midpoint, Zuazo::ColorChromaLocation::midpoint),
+		Zuazo::ColorRange::full,
+		Zuazo::ColorFormat::B8G8R8A8
+	);
+
+	/*
+	 * Upload a gradient to be shown by all the layers
+	 */
+	Zuazo::Graphics::StagedFramePool framePool(vulkan, frameDesc);
+	const auto frame = framePool.acquireFrame();
+	for(const auto& plane : frame->getPixelData()) {
+		for(size_t i = 0; i < plane.size(); ++i) {
+			plane[i] = static_cast<std::byte>(i / 7);
+		}
+	}
+	frame->flush();
+	frame->waitCompletion(Zuazo::Graphics::Vulkan::NO_TIMEOUT);
+
+	/*
+	 * Spread the layers on a grid, each one at a different depth and
+	 * with some transparency, so that they overlap each other
+	 */
+	std::vector<std::unique_ptr<Zuazo::VideoLayer>> layers;
+	std::vector<Zuazo::RendererBase::LayerRef> layerRefs;
+	layers.reserve(LAYER_COUNT);
+	layerRefs.reserve(LAYER_COUNT);
+	for(size_t i = 0; i < LAYER_COUNT; ++i) {
+		const float x = static_cast<float>(i % 32) * 60.0f - 960.0f;
+		const float y = static_cast<float>(i / 32) * 67.5f - 540.0f;
+		const float z = static_cast<float>(i) * 0.1f;
+
+		auto layer = std::make_unique<Zuazo::VideoLayer>(vulkan, Zuazo::Math::Vec2f(120.0f, 67.5f));
+		layer->setTransform(Zuazo::Math::Transformf(Zuazo::Math::Vec3f(x, y, z)));
+		layer->setOpacity((i % 2) ? 0.5f : 1.0f);
+		layer->setVideo(frame);
+
+		layerRefs.emplace_back(*layer);
+		layers.emplace_back(std::move(layer));
+	}
+
+	Zuazo::Graphics::Downloader downloader(vulkan, frameDesc, Zuazo::DepthStencilFormat::none);
+	Zuazo::Graphics::CommandBufferPool commandBufferPool(
+		vulkan,
+		vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+		vulkan.getGraphicsQueueIndex(),
+		vk::CommandBufferLevel::ePrimary
+	);
+	OffscreenRenderer renderer(vulkan, downloader);
+	renderer.setLayers(layerRefs);
+
+	/*
+	 * Pipelines are compiled in the background. Draw until all of them
+	 * are available, so that every layer is drawn when measuring
+	 */
+	do {
+		drawFrame(renderer, downloader, commandBufferPool);
+	} while(vulkan.getPendingPipelineCount() > 0);
+	drawFrame(renderer, downloader, commandBufferPool);
+
+	std::vector<std::byte> reference;
+	std::chrono::duration<double, std::micro> serialTime = std::chrono::steady_clock::duration::zero();
+	for(const auto threadCount : RECORDING_THREAD_COUNTS) {
+		renderer.setRecordingThreadCount(threadCount);
+
+		std::chrono::steady_clock::duration recordingTime = std::chrono::steady_clock::duration::zero();
+		uint64_t lastId = 0;
+		for(size_t i = 0; i < FRAME_COUNT; ++i) {
+			const auto result = drawFrame(renderer, downloader, commandBufferPool);
+			recordingTime += result.recordingTime;
+			lastId = result.id;
+		}
+
+		const auto averageTime = std::chrono::duration<double, std::micro>(recordingTime) / FRAME_COUNT;
+		const auto pixelData = copyPixelData(downloader, lastId);
+		if(threadCount == 0) {
+			reference = pixelData;
+			serialTime = averageTime;
+		}
+
+		std::cout 	<< threadCount << " recording threads: "
+					<< averageTime.count() << "us/frame, "
+					<< serialTime / averageTime << "x, "
+					<< (pixelData == reference ? "identical" : "DIFFERENT") << "\n";
+	}
+}
\ No newline at end of file
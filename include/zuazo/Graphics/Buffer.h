@@ -22,16 +22,17 @@ public:
 
 	vk::Buffer						getBuffer() const noexcept;
 	vk::DeviceMemory				getDeviceMemory() const noexcept;
+	const Vulkan::Allocation&		getMemory() const noexcept;
 
 private:
 	vk::UniqueBuffer				m_buffer;
-	vk::UniqueDeviceMemory			m_memory;
+	Vulkan::Allocation				m_memory;
 
 	static vk::UniqueBuffer			createBuffer(	const Vulkan& vulkan,
 													size_t size,
 													vk::BufferUsageFlags usage );
 
-	static vk::UniqueDeviceMemory 	allocateMemory(	const Vulkan& vulkan,
+	static Vulkan::Allocation		allocateMemory(	const Vulkan& vulkan,
 													vk::Buffer buffer,
 													vk::MemoryPropertyFlags properties );
 };
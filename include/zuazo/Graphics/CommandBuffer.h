@@ -31,6 +31,13 @@ public:
 	void											addDependencies(Utils::BufferView<const Dependency> dep);
 	Utils::BufferView<const Dependency>				getDependencies() const noexcept;
 
+	/**
+	 * Binds recorded since begin(). Binding the graphics pipeline which is already 
+	 * bound is skipped, so the pipeline must not be bound bypassing this class.
+	 */
+	size_t											getPipelineBindCount() const noexcept;
+	size_t											getDescriptorSetBindCount() const noexcept;
+
 	void											begin(const vk::CommandBufferBeginInfo& beginInfo) noexcept;
 	void											end() noexcept;
 
@@ -148,6 +155,10 @@ private:
 
 	std::vector<Dependency>							m_dependencies;
 
+	vk::Pipeline									m_graphicsPipeline;
+	size_t											m_pipelineBindCount;
+	size_t											m_descriptorSetBindCount;
+
 	static vk::UniqueCommandBuffer					createCommandBuffer(const Vulkan& vulkan,
 																		vk::CommandBufferLevel level,
 																		vk::CommandPool pool);
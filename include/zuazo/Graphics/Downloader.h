@@ -1,7 +1,9 @@
 #pragma once
-/* //TODO
+
 #include "Vulkan.h"
-#include "TargetFrame.h"
+#include "Frame.h"
+#include "RenderPass.h"
+#include "CommandBuffer.h"
 #include "ColorTransfer.h"
 #include "../Utils/Pimpl.h"
 #include "../Utils/Limit.h"
@@ -12,13 +14,25 @@
 
 namespace Zuazo::Graphics {
 
+/**
+ * Renders into a ring of targets and reads them back to host memory. Each
+ * draw is identified by the value returned by draw(). Its pixel data may be
+ * read once it has completed, and it remains valid until ring size further 
+ * draws are issued. Planes are tightly packed, without any row padding.
+ * Drawing only blocks when the oldest download in the ring has not been 
+ * completed by the GPU yet. Draws are submitted with the rest of the tick's
+ * batched work. waitCompletion() sends the batch if it is still pending.
+ */
 class Downloader {
 public:
 	using PixelData = Utils::BufferView<const Utils::BufferView<const std::byte>>;
 
+	static constexpr size_t DEFAULT_RING_SIZE = 3;
+
 	Downloader(	const Vulkan& vulkan, 
 				const Frame::Descriptor& frameDesc,
-				DepthStencilFormat depthStencilFmt );
+				DepthStencilFormat depthStencilFmt,
+				size_t ringSize = DEFAULT_RING_SIZE );
 	Downloader(const Downloader& other) = delete;
 	Downloader(Downloader&& other) noexcept;
 	~Downloader();
@@ -28,25 +42,25 @@ public:
 
 	const Vulkan&									getVulkan() const noexcept;
 	const Frame::Descriptor& 						getFrameDescriptor() const noexcept;	
+	DepthStencilFormat								getDepthStencilFormat() const noexcept;
 	const ColorTransferWrite&						getColorTransfer() const noexcept;
+	const RenderPass&								getRenderPass() const noexcept;
+	size_t											getRingSize() const noexcept;
 
-	const Framebuffer&								getFramebuffer() const noexcept;
 	void											beginRenderPass(vk::CommandBuffer cmd, 
 																	vk::Rect2D renderArea,
 																	Utils::BufferView<const vk::ClearValue> clearValues,
 																	vk::SubpassContents contents ) const noexcept;
 	void											endRenderPass(vk::CommandBuffer cmd) const noexcept;
 
-	void											draw(std::shared_ptr<const CommandBuffer> cmd);
-	bool											waitCompletion(uint64_t timeo) const;
-	PixelData										getPixelData() const noexcept;
+	uint64_t										draw(std::shared_ptr<const CommandBuffer> cmd);
+	uint64_t										getDrawCount() const noexcept;
+	bool											waitCompletion(	uint64_t id, 
+																	uint64_t timeo ) const;
+	PixelData										getPixelData(uint64_t id) const noexcept;
 
 	static Utils::Discrete<ColorFormat> 			getSupportedFormats(const Vulkan& vulkan);
 	static Utils::Discrete<ColorFormat> 			getSupportedSrgbFormats(const Vulkan& vulkan);
-	static Utils::Discrete<DepthStencilFormat> 		getSupportedFormatsDepthStencil(const Vulkan& vulkan);
-	static RenderPass								getRenderPass(	const Vulkan& vulkan, 
-																	const Frame::Descriptor& frameDesc,
-																	DepthStencilFormat depthStencilFmt );
 
 private:
 	struct Impl;
@@ -54,5 +68,4 @@ private:
 
 };
 
-}
-*/
\ No newline at end of file
+}
\ No newline at end of file
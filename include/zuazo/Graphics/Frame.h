@@ -2,6 +2,7 @@
 
 #include "Vulkan.h"
 #include "Image.h"
+#include "CommandBuffer.h"
 #include "VulkanConversions.h"
 #include "../ScalingMode.h"
 #include "../Utils/BufferView.h"
@@ -49,16 +50,42 @@ public:
 
 	vk::DescriptorSetLayout					getDescriptorSetLayout(ScalingFilter filter) const noexcept;
 	uint32_t								getSamplingMode(ScalingFilter filter) const noexcept;
+	void									bind(	CommandBuffer& cmd,
+													vk::PipelineLayout layout,
+													uint32_t index,
+													ScalingFilter filter ) const noexcept;
+	/**
+	 * Records straight into the command buffer, so the bind is not counted by
+	 * a CommandBuffer owning it. Prefer the overload above.
+	 */
 	void									bind(	vk::CommandBuffer cmd,
 													vk::PipelineLayout layout,
 													uint32_t index,
 													ScalingFilter filter ) const noexcept;
 
+	/**
+	 * Index of the frame in the bindless table. The slot for each filter is only
+	 * taken on the first call, so frames which are never sampled through the 
+	 * table do not fill it. Requires bindless support.
+	 */
+	uint32_t								getBindlessIndex(ScalingFilter filter) const;
+
 	void									setUserPointer(std::shared_ptr<void> usrPtr);
 	void*									getUserPointer() const noexcept;
 
 	static std::shared_ptr<const Cache>		createCache(const Vulkan& vulkan,
 														const Image::Plane& plane );
+	static void								bindBindless(	CommandBuffer& cmd,
+															vk::PipelineLayout layout,
+															uint32_t index ) noexcept;
+	/**
+	 * Records straight into the command buffer, so the bind is not counted by
+	 * a CommandBuffer owning it. Prefer the overload above.
+	 */
+	static void								bindBindless(	const Vulkan& vulkan,
+															vk::CommandBuffer cmd,
+															vk::PipelineLayout layout,
+															uint32_t index ) noexcept;
 
 private:
 	struct Impl;
@@ -2,6 +2,7 @@
 
 #include "Vulkan.h"
 #include "Image.h"
+#include "CommandBuffer.h"
 #include "ColorTransfer.h"
 #include "../Utils/Pimpl.h"
 
@@ -28,6 +29,13 @@ public:
 
 	vk::UniqueFramebuffer				createFramebuffer(	const Vulkan& vulkan, 
 															const Image& target) const;
+	void								finalize(CommandBuffer& cmd) const noexcept;
+
+	/**
+	 * Records straight into the command buffer. If it is owned by a CommandBuffer,
+	 * the conversion pipeline bound here is not known by it, so its bind tracking
+	 * must not be relied upon afterwards. Prefer the overload above.
+	 */
 	void								finalize(	const Vulkan& vulkan, 
 													vk::CommandBuffer cmd ) const noexcept;
 
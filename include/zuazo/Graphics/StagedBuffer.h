@@ -51,10 +51,9 @@ private:
 	Utils::BufferView<std::byte>		m_data;
 
 	vk::UniqueCommandPool				m_commandPool;
-	vk::UniqueFence						m_uploadComplete;
 
 	std::map<Key, vk::CommandBuffer> 	m_uploadCommands;
-	mutable vk::Fence					m_waitFence;
+	mutable uint64_t					m_waitBatch;
 
 	vk::CommandBuffer					createCommandBuffer(const Vulkan& vulkan,
 															Utils::Area area,
@@ -20,6 +20,17 @@ public:
 				std::shared_ptr<const Descriptor> desc,
 				std::shared_ptr<const Cache> cache = nullptr,
 				std::shared_ptr<void> usrPtr = nullptr  );
+	/**
+	 * Uses the given host memory as the staging storage, so that the pixel data 
+	 * does not need to be copied into it. It must be aligned to the host memory 
+	 * import alignment of Vulkan, hold at least getHostMemorySize() bytes, and 
+	 * remain valid until usrPtr is released
+	 */
+	StagedFrame(const Vulkan& vulkan,
+				std::shared_ptr<const Descriptor> desc,
+				Utils::BufferView<std::byte> hostMemory,
+				std::shared_ptr<const Cache> cache = nullptr,
+				std::shared_ptr<void> usrPtr = nullptr  );
 	StagedFrame(const StagedFrame& other) = delete;
 	StagedFrame(StagedFrame&& other) noexcept;
 	virtual ~StagedFrame(); 
@@ -34,6 +45,7 @@ public:
 
 	static std::shared_ptr<const Cache>			createCache(const Vulkan& vulkan, 
 															const Frame::Descriptor& frameDesc );
+	static size_t								getHostMemorySize(const Cache& cache) noexcept;
 
 	static Utils::Discrete<ColorFormat>			getSupportedFormats(const Vulkan& vulkan);
 
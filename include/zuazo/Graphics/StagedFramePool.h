@@ -30,6 +30,15 @@ public:
 
 	std::shared_ptr<StagedFrame>					acquireFrame() const;
 
+	/**
+	 * Creates a frame backed by the given host memory, without copying
+	 * it. These frames are not recycled, as their storage belongs to the
+	 * caller. The memory must remain valid until usrPtr is released
+	 */
+	size_t											getHostMemorySize() const noexcept;
+	std::shared_ptr<StagedFrame>					wrapFrame(	Utils::BufferView<std::byte> hostMemory,
+																std::shared_ptr<void> usrPtr ) const;
+
 private:
 	struct Impl;
 	Utils::Pimpl<Impl>								m_impl;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Vulkan.h"
+#include "Buffer.h"
+#include "../Utils/BufferView.h"
+
+#include <vector>
+
+namespace Zuazo::Graphics {
+
+/**
+ * Host visible uniform memory split into a region per frame in flight. Data
+ * is written directly into the mapped memory and bound with dynamic offsets,
+ * so that per-tick updates require neither a staging copy nor a submission.
+ * advance() must be called once per tick after enqueuing the work using the 
+ * current region. It only blocks when the next region is still in use by the
+ * GPU, i.e. when more than frameCount ticks are in flight. Other usages, such 
+ * as eVertexBuffer, allow using it for per-instance data. Slices are aligned to
+ * the given alignment, raised to the minimum offset alignment of the usage.
+ * flush() makes the data written so far visible to the GPU without moving to
+ * the next region, for data which is rewritten less often than once per tick.
+ */
+class UniformRing {
+public:
+	struct Slice {
+		Utils::BufferView<std::byte>		data;
+		uint32_t							offset; //Dynamic offset
+	};
+
+	static constexpr size_t DEFAULT_FRAME_COUNT = 3;
+
+	UniformRing() noexcept;
+	UniformRing(const Vulkan& vulkan,
+				size_t frameSize,
+				size_t frameCount = DEFAULT_FRAME_COUNT,
+				vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eUniformBuffer,
+				size_t alignment = 1 );
+	UniformRing(const UniformRing& other) = delete;
+	UniformRing(UniformRing&& other) noexcept = default;
+	~UniformRing() = default;
+
+	UniformRing&							operator=(const UniformRing& other) = delete;
+	UniformRing&							operator=(UniformRing&& other) noexcept = default;
+
+	vk::Buffer								getBuffer() const noexcept;
+	size_t									getFrameSize() const noexcept;
+	size_t									getFrameCount() const noexcept;
+	size_t									getAlignment() const noexcept;
+
+	Slice									allocate(size_t size);
+	uint32_t								write(	const void* data,
+													size_t size );
+	void									flush(const Vulkan& vulkan);
+	void									advance(const Vulkan& vulkan);
+
+	void									writeDescriptorSet(	const Vulkan& vulkan,
+																vk::DescriptorSet descriptorSet,
+																uint32_t binding,
+																size_t range ) const;
+
+private:
+	size_t									m_alignment;
+	size_t									m_frameSize;
+	Buffer									m_buffer;
+	Utils::BufferView<std::byte>			m_data;
+
+	std::vector<uint64_t>					m_frameBatches;
+	size_t									m_frame;
+	size_t									m_frameUsage;
+	size_t									m_flushedUsage;
+
+	static size_t							getAlignment(	const Vulkan& vulkan,
+															vk::BufferUsageFlags usage,
+															size_t alignment ) noexcept;
+	static size_t							getFrameSize(	const Vulkan& vulkan,
+															size_t frameSize,
+															size_t alignment ) noexcept;
+	static Buffer							createBuffer(	const Vulkan& vulkan,
+															size_t size,
+															vk::BufferUsageFlags usage );
+	static Utils::BufferView<std::byte>		mapBuffer(	const Vulkan& vulkan,
+														size_t size,
+														const Buffer& buffer );
+
+};
+
+}
\ No newline at end of file
@@ -19,20 +19,40 @@
 
 namespace Zuazo::Graphics {
 
+class DeviceMemoryAllocator;
+class DescriptorAllocator;
+class BindlessDescriptorTable;
+
 class Vulkan {
 public:
 	using LogCallback = std::function<void(Severity, std::string)>;
 	using DeviceScoreFunc = std::function<uint32_t(const vk::DispatchLoaderDynamic&, vk::PhysicalDevice)>;
 	using PresentationSupportCallback = std::function<bool(vk::Instance, vk::PhysicalDevice, uint32_t)>;
+	using GraphicsPipelineFactory = std::function<vk::UniquePipeline()>;
 
 	using FormatSupport = std::unordered_map<vk::Format, vk::FormatProperties>;
 
 	using DeviceFeatures = vk::StructureChain<	vk::PhysicalDeviceFeatures2, 
-												vk::PhysicalDeviceSamplerYcbcrConversionFeatures >;
-
-	struct AggregatedAllocation {
-		vk::UniqueDeviceMemory memory;
-		std::vector<Utils::Area> areas;
+												vk::PhysicalDeviceSamplerYcbcrConversionFeatures,
+												vk::PhysicalDeviceDescriptorIndexingFeaturesEXT,
+												vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR >;
+
+	class Allocation;
+	struct AggregatedAllocation;
+	class PooledDescriptorSet;
+	class BindlessSlot;
+
+	/**
+	 * Usage of a memory type. Fragmentation is the fraction of the free space
+	 * which is not part of the largest free range.
+	 */
+	struct MemoryStatistics {
+		size_t							blockCount;
+		size_t							allocationCount;
+		size_t							blockBytes;
+		size_t							usedBytes;
+		size_t							largestFreeRange;
+		float							fragmentation;
 	};
 
 	static constexpr uint64_t NO_TIMEOUT = std::numeric_limits<uint64_t>::max();
@@ -53,7 +73,8 @@ public:
 			std::vector<vk::ExtensionProperties> requiredDeviceExtensions,
 			LogCallback logCallback,
 			const PresentationSupportCallback& presentationSupportCbk,
-			const DeviceScoreFunc& scoreFunc );
+			const DeviceScoreFunc& scoreFunc,
+			std::string pipelineCachePath = "" );
 	Vulkan(const Vulkan& other) = delete;
 	Vulkan(Vulkan&& other) noexcept;
 	~Vulkan();
@@ -75,10 +96,12 @@ public:
 	uint32_t							getPresentationQueueIndex() const noexcept;
 	vk::Queue							getPresentationQueue() const noexcept;
 	vk::PipelineCache					getPipelineCache() const noexcept;
+	bool								savePipelineCache() const;
 
 	const vk::PhysicalDeviceProperties&	getPhysicalDeviceProperties() const noexcept;
 	const FormatSupport&				getFormatSupport() const noexcept;
 	const DeviceFeatures&				getDeviceFeatures() const noexcept;
+	bool								getTimelineSemaphoreSupport() const noexcept;
 	const std::vector<vk::Format>&		listSupportedFormatsOptimal(vk::FormatFeatureFlags flags) const;
 	const std::vector<vk::Format>&		listSupportedFormatsLinear(vk::FormatFeatureFlags flags) const;
 
@@ -90,6 +113,7 @@ public:
 	vk::UniqueBuffer					createBuffer(const vk::BufferCreateInfo& createInfo) const;
 	vk::UniqueDescriptorPool			createDescriptorPool(const vk::DescriptorPoolCreateInfo& createInfo) const;
 	vk::UniqueSemaphore					createSemaphore() const;
+	vk::UniqueSemaphore					createTimelineSemaphore(uint64_t initialValue = 0) const;
 	vk::UniqueFence						createFence(bool signaled = false) const;
 
 	vk::UniqueRenderPass				createRenderPass(const vk::RenderPassCreateInfo& createInfo) const;
@@ -110,6 +134,15 @@ public:
 	vk::Pipeline						createGraphicsPipeline(size_t id) const;
 	vk::Pipeline						createGraphicsPipeline(	size_t id,
 																const vk::GraphicsPipelineCreateInfo& createInfo ) const;
+	/**
+	 * Returns the cached pipeline for the given id if present. Otherwise, the factory is
+	 * invoked on a background thread and a null handle is returned, so that the caller 
+	 * can skip drawing until it is ready instead of stalling. If a previous background
+	 * compilation failed, it is compiled synchronously so that the error is thrown.
+	 */
+	vk::Pipeline						createGraphicsPipelineAsync(size_t id,
+																	GraphicsPipelineFactory factory ) const;
+	size_t								getPendingPipelineCount() const noexcept;
 
 	vk::UniqueDescriptorSetLayout		createDescriptorSetLayout(const vk::DescriptorSetLayoutCreateInfo& createInfo) const;
 	vk::DescriptorSetLayout				createDescriptorSetLayout(size_t id) const;
@@ -133,14 +166,55 @@ public:
 															vk::CommandPoolResetFlags flags ) const;
 
 	vk::UniqueDeviceMemory				allocateMemory(const vk::MemoryAllocateInfo& allocInfo) const;
-	vk::UniqueDeviceMemory				allocateMemory(	const vk::MemoryRequirements& requirements,
-														vk::MemoryPropertyFlags properties ) const;
+	/**
+	 * Sub-allocates memory from larger blocks. Buffers and linear images must use 
+	 * eLinear tiling, so that they are kept apart from optimal images when required 
+	 * by bufferImageGranularity. Host visible memory is mapped persistently, so it
+	 * must be mapped with mapMemory() instead of by hand.
+	 */
+	Allocation							allocateMemory(	const vk::MemoryRequirements& requirements,
+														vk::MemoryPropertyFlags properties,
+														vk::ImageTiling tiling = vk::ImageTiling::eLinear ) const;
 	AggregatedAllocation				allocateMemory(	Utils::BufferView<const vk::MemoryRequirements> requirements,
-														vk::MemoryPropertyFlags properties ) const;
+														vk::MemoryPropertyFlags properties,
+														vk::ImageTiling tiling = vk::ImageTiling::eLinear ) const;
+	std::vector<MemoryStatistics>		getMemoryStatistics() const;
+	size_t								trimMemory() const;
+
+	/**
+	 * Imports memory allocated by the host, so that it can be used without copying 
+	 * it. It is available when the alignment is non-zero. Both the address and the 
+	 * size of the memory must be a multiple of it. The imported memory must outlive
+	 * the returned object
+	 */
+	size_t								getHostMemoryImportAlignment() const noexcept;
+	vk::UniqueDeviceMemory				importHostMemory(	Utils::BufferView<std::byte> memory,
+															uint32_t memoryTypeBits,
+															vk::MemoryPropertyFlags properties ) const;
 
 	std::vector<vk::UniqueDescriptorSet>allocateDescriptorSets(const vk::DescriptorSetAllocateInfo& allocInfo) const;
 	vk::UniqueDescriptorSet				allocateDescriptorSet(	vk::DescriptorPool pool, 
 																vk::DescriptorSetLayout layout) const;
+	/**
+	 * Allocates a descriptor set from pools shared among all the sets of the
+	 * same layout. setSizes are the descriptors required by a single set and
+	 * they must be the same for every call with the same layout. Recycled sets
+	 * keep their previous contents, so they must be written again
+	 */
+	PooledDescriptorSet					allocateDescriptorSet(	vk::DescriptorSetLayout layout,
+																Utils::BufferView<const vk::DescriptorPoolSize> setSizes ) const;
+	size_t								getCreatedDescriptorPoolCount() const noexcept;
+
+	/**
+	 * Bindless mode, available when descriptor indexing is supported. A single
+	 * descriptor set holds an array of combined image samplers, so that draws
+	 * using different images only need to pass a different index
+	 */
+	bool								getBindlessSupport() const noexcept;
+	vk::DescriptorSetLayout				getBindlessDescriptorSetLayout() const noexcept;
+	vk::DescriptorSet					getBindlessDescriptorSet() const noexcept;
+	BindlessSlot						allocateBindlessSlot(	vk::ImageView imageView,
+																vk::Sampler sampler ) const;
 
 	vk::MemoryRequirements				getMemoryRequirements(vk::Buffer buf) const;
 	vk::MemoryRequirements				getMemoryRequirements(vk::Image img) const;
@@ -176,11 +250,34 @@ public:
 														bool waitAll = false,
 														uint64_t timeout = NO_TIMEOUT) const;
 	void								resetFences(Utils::BufferView<const vk::Fence> fences) const;
+	bool								waitSemaphore(	vk::Semaphore semaphore,
+														uint64_t value,
+														uint64_t timeout = NO_TIMEOUT ) const;
+	uint64_t							getSemaphoreCounterValue(vk::Semaphore semaphore) const;
 
 	void								submit(	vk::Queue queue,
 												Utils::BufferView<const vk::SubmitInfo> subInfo,
 												vk::Fence fence ) const;
 
+	/**
+	 * Batched submissions are sent with a single vkQueueSubmit per queue when
+	 * submitAll() is called, which the Instance does once per tick. Graphics 
+	 * command buffers may wait for the transfer command buffers of the same 
+	 * batch. The returned batch can be waited with waitBatch(), which sends it
+	 * beforehand if it is still pending. Direct submissions also send it first,
+	 * so that they are ordered after it. Work enqueued before calling 
+	 * getPendingBatch() belongs to that batch or to a previous one. 
+	 * getSubmitCount() includes both batched and direct submissions.
+	 */
+	uint64_t							submitTransferBatched(Utils::BufferView<const vk::CommandBuffer> cmds) const;
+	uint64_t							submitGraphicsBatched(	Utils::BufferView<const vk::CommandBuffer> cmds,
+																bool waitTransfer = false ) const;
+	bool								waitBatch(	uint64_t batch,
+													uint64_t timeout = NO_TIMEOUT ) const;
+	void								submitAll() const;
+	uint64_t							getPendingBatch() const noexcept;
+	size_t								getSubmitCount() const noexcept;
+
 
 	void								begin(	vk::CommandBuffer cmd,
 												const vk::CommandBufferBeginInfo& beginInfo ) const;
@@ -291,6 +388,11 @@ public:
 															uint32_t firstSet, 
 															Utils::BufferView<const vk::DescriptorSet> descriptorSets, 
 															Utils::BufferView<const uint32_t> dynamicOffsets) const noexcept;
+	void								pushConstants(	vk::CommandBuffer cmd,
+														vk::PipelineLayout layout,
+														vk::ShaderStageFlags stages,
+														uint32_t offset,
+														Utils::BufferView<const std::byte> data ) const noexcept;
 	void								setViewport(vk::CommandBuffer cmd,
 													uint32_t first,
 													Utils::BufferView<const vk::Viewport> viewports ) const noexcept;
@@ -335,4 +437,107 @@ private:
 
 };
 
+
+
+class Vulkan::Allocation {
+	friend DeviceMemoryAllocator;
+public:
+	Allocation() noexcept;
+	Allocation(const Allocation& other) = delete;
+	Allocation(Allocation&& other) noexcept;
+	~Allocation();
+
+	Allocation&							operator=(const Allocation& other) = delete;
+	Allocation&							operator=(Allocation&& other) noexcept;
+
+	operator bool() const noexcept;
+
+	vk::DeviceMemory					getDeviceMemory() const noexcept;
+	size_t								getOffset() const noexcept;
+	size_t								getSize() const noexcept;
+	vk::MappedMemoryRange				getRange() const noexcept;
+
+	void								reset() noexcept;
+
+private:
+	DeviceMemoryAllocator*				m_allocator;
+	vk::DeviceMemory					m_memory;
+	size_t								m_offset;
+	size_t								m_size;
+
+	Allocation(	DeviceMemoryAllocator& allocator,
+				vk::DeviceMemory memory,
+				size_t offset,
+				size_t size ) noexcept;
+
+};
+
+/**
+ * Several resources sharing a single allocation. Areas are relative to it.
+ */
+struct Vulkan::AggregatedAllocation {
+	Allocation							memory;
+	std::vector<Utils::Area>			areas;
+};
+
+
+
+class Vulkan::PooledDescriptorSet {
+	friend DescriptorAllocator;
+public:
+	PooledDescriptorSet() noexcept;
+	PooledDescriptorSet(const PooledDescriptorSet& other) = delete;
+	PooledDescriptorSet(PooledDescriptorSet&& other) noexcept;
+	~PooledDescriptorSet();
+
+	PooledDescriptorSet&				operator=(const PooledDescriptorSet& other) = delete;
+	PooledDescriptorSet&				operator=(PooledDescriptorSet&& other) noexcept;
+
+	operator bool() const noexcept;
+	vk::DescriptorSet					operator*() const noexcept;
+
+	vk::DescriptorSet					get() const noexcept;
+	vk::DescriptorSetLayout				getLayout() const noexcept;
+
+	void								reset() noexcept;
+
+private:
+	DescriptorAllocator*				m_allocator;
+	vk::DescriptorSetLayout				m_layout;
+	vk::DescriptorSet					m_descriptorSet;
+
+	PooledDescriptorSet(DescriptorAllocator& allocator,
+						vk::DescriptorSetLayout layout,
+						vk::DescriptorSet descriptorSet ) noexcept;
+
+};
+
+
+
+class Vulkan::BindlessSlot {
+	friend BindlessDescriptorTable;
+public:
+	BindlessSlot() noexcept;
+	BindlessSlot(const BindlessSlot& other) = delete;
+	BindlessSlot(BindlessSlot&& other) noexcept;
+	~BindlessSlot();
+
+	BindlessSlot&						operator=(const BindlessSlot& other) = delete;
+	BindlessSlot&						operator=(BindlessSlot&& other) noexcept;
+
+	operator bool() const noexcept;
+
+	uint32_t							getIndex() const noexcept;
+
+	void								reset() noexcept;
+
+private:
+	BindlessDescriptorTable*			m_table;
+	uint32_t							m_index;
+
+	BindlessSlot(	BindlessDescriptorTable& table,
+					uint32_t index ) noexcept;
+
+};
+
 }
\ No newline at end of file
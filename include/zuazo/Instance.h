@@ -8,9 +8,12 @@
 #include "DepthStencilFormat.h"
 #include "Graphics/Vulkan.h"
 #include "Chrono.h"
+#include "JitterHistogram.h"
 #include "Utils/Pimpl.h"
 #include "Utils/Limit.h"
+#include "Utils/BufferView.h"
 
+#include <array>
 #include <functional>
 #include <vector>
 #include <limits>
@@ -21,6 +24,10 @@ namespace Zuazo {
 
 class ZuazoBase;
 
+namespace Signal {
+class Layout;
+}
+
 class Instance {
 public:
 	using DeviceScoreFunc = Graphics::Vulkan::DeviceScoreFunc;
@@ -29,6 +36,44 @@ public:
 	class Module;
 	class ApplicationInfo;
 
+	/**
+	 * ClockMode defines how the time advances. In realTime mode, updates are synchronized 
+	 * with the system clock. In virtualTime mode, each update is performed as soon as the 
+	 * previous one finishes, so that a composition can be rendered as fast as possible. 
+	 * In manual mode, time only advances when step() is called.
+	 */
+	enum class ClockMode {
+		realTime,
+		virtualTime,
+		manual
+	};
+
+	/**
+	 * Scheduling policy for the main loop's thread. fifo and roundRobin are real-time 
+	 * policies, which usually require special privileges.
+	 */
+	enum class ThreadPolicy {
+		normal,
+		fifo,
+		roundRobin
+	};
+
+	using JitterHistogram = Zuazo::JitterHistogram;
+
+	/**
+	 * Execution time statistics of a scheduled callback. They are only collected while 
+	 * profiling is enabled. p99Time is approximate.
+	 */
+	struct CallbackStatistics {
+		size_t								invocationCount;
+		Duration							minimumTime;
+		Duration							averageTime;
+		Duration							p99Time;
+		Duration							maximumTime;
+	};
+
+	static constexpr Duration jitterHistogramResolution = JITTER_HISTOGRAM_RESOLUTION;
+
 	/**
 	 * Priority defines in which order Events will be updated, high priority meaning that
 	 * it will be updated early, whilst low priority means that it will be updated late.
@@ -45,7 +90,10 @@ public:
 
 		playerPriority = consumerPriority - 2048,
 		presentPriority = consumerPriority - 1024,
+		submitPriority = consumerPriority - 512,
+		signalEvaluationPriority = processorPriority - 1024,
 		eventHandlingPriority = sourcePriority + 1024,
+		commandHandlingPriority = eventHandlingPriority + 1024,
 	};
 
 	Instance(	ApplicationInfo applicationInfo, 
@@ -71,11 +119,117 @@ public:
 	void								addPeriodicCallback(	const ScheduledCallback& cbk, 
 																Priority prior, 
 																Duration period );
+	void								addPeriodicCallback(	const ScheduledCallback& cbk, 
+																Priority prior, 
+																Rate rate );
 	void								removePeriodicCallback(const ScheduledCallback& cbk);
 
-	void								addEvent(size_t emitterId, ScheduledCallback cbk);
+	/**
+	 * The outputs of the scheduled layouts are evaluated at most once per update, when
+	 * first pulled after signalEvaluationPriority (i.e. after the processors have been
+	 * updated), so only the ones upstream of the consumers updated in that tick are
+	 * evaluated. Further pulls return the evaluated element without invoking the pull
+	 * callback again. Pulls before signalEvaluationPriority return the evaluation of 
+	 * the previous update. Opened elements are scheduled automatically. The instance 
+	 * must be locked when calling these.
+	 */
+	void								scheduleLayout(Signal::Layout& layout);
+	void								unscheduleLayout(Signal::Layout& layout);
+
+	/**
+	 * Sets the amount of worker threads used to execute scheduled callbacks of the same 
+	 * priority concurrently. 0 (the default) means that all callbacks are executed serially 
+	 * in the main loop. Only enable it when callbacks sharing a priority are independent
+	 * from each other, as nothing is synchronized among them:
+	 * - They run while the main loop holds the instance's lock, so they must not lock
+	 *   it, nor add or remove callbacks, layouts or events other than with addEvent().
+	 * - They must not pull the same outputs, as scheduled outputs are evaluated on 
+	 *   their first pull. Consumers sharing a source therefore need different priorities.
+	 * - They must not share elements, layers or renderers.
+	 * The instance must be locked when calling this.
+	 */
+	void								setWorkerThreadCount(size_t count);
+	size_t								getWorkerThreadCount() const noexcept;
+
+	/**
+	 * Enables collecting execution time statistics of each scheduled callback and counting
+	 * the updates which took longer than the fastest periodic callback's period (deadline
+	 * misses). Disabling it discards the collected data. The instance must be locked when 
+	 * calling all these methods.
+	 */
+	void								setProfilingEnabled(bool ena);
+	bool								getProfilingEnabled() const noexcept;
+	CallbackStatistics					getCallbackStatistics(const ScheduledCallback& cbk) const noexcept;
+	size_t								getProfiledUpdateCount() const noexcept;
+	size_t								getDeadlineMissCount() const noexcept;
+	void								clearProfilingStatistics() noexcept;
+
+	/**
+	 * Amount of vkQueueSubmit calls issued during the last update, including 
+	 * the batched ones. It can be called without locking the instance.
+	 */
+	size_t								getSubmitsPerTick() const noexcept;
+
+	/**
+	 * Enqueues an event to be processed in the next update. It can be called from any 
+	 * thread without locking the instance. When coalesce is set, only the latest of the 
+	 * coalesced events pending for the same emitter will be processed.
+	 */
+	void								addEvent(size_t emitterId, ScheduledCallback cbk, bool coalesce = false);
+	/**
+	 * Discards the events pending for the emitter. It does not wait: a removal mark is 
+	 * enqueued and the discarded callbacks are destroyed without being invoked in the 
+	 * next update. Events are processed with the instance locked, so when this is called 
+	 * with the instance locked none of the emitter's events is running nor will run 
+	 * afterwards, and the emitter may be destroyed right away. Without the lock, an event 
+	 * taken before the mark may still be running when this returns.
+	 */
 	void								removeEvent(size_t emitterId);
 
+	/**
+	 * Enqueues a command which will be executed at the beginning of the next update, 
+	 * with the instance locked. This can be called from any thread without locking the 
+	 * instance, so that control threads (for instance, the ones changing a layer's opacity)
+	 * are never blocked by the main loop and vice versa.
+	 */
+	void								addCommand(ScheduledCallback cmd);
+
+	/**
+	 * Changes how the time advances (see ClockMode). The instance must be locked when
+	 * calling setClockMode() and step(), as the main loop reads the mode with it locked.
+	 * getClockMode() may be called from any thread.
+	 */
+	void								setClockMode(ClockMode mode);
+	ClockMode							getClockMode() const noexcept;
+	void								step();
+
+	/**
+	 * Waiting for a deadline on a condition variable may wake up quite late. When a 
+	 * spin duration is set, the main loop sleeps until that much time before the deadline
+	 * and spins the rest. Zero (the default) disables spinning.
+	 */
+	void								setSpinDuration(Duration duration);
+	Duration							getSpinDuration() const noexcept;
+
+	/**
+	 * Sets the scheduling policy of the main loop's thread. For real-time policies the 
+	 * priority is the static priority, for the normal policy it is the nice value.
+	 * Returns false if the OS rejected it.
+	 */
+	bool								setLoopThreadScheduling(ThreadPolicy policy, int priority);
+	/**
+	 * Sets the CPUs where the main loop's thread may run. An empty list allows all of them.
+	 * Returns false if the OS rejected it.
+	 */
+	bool								setLoopThreadAffinity(Utils::BufferView<const size_t> cpus);
+
+	/**
+	 * Returns a snapshot of the main loop's wake-up jitter histogram. Both methods may be 
+	 * called from any thread, with or without the instance locked.
+	 */
+	JitterHistogram						getJitterHistogram() const;
+	void								clearJitterHistogram();
+
 	TimePoint							getTime() const noexcept;
 	TimePoint							getEpoch() const noexcept;
 	Duration							getDeltaT() const noexcept;
@@ -154,6 +308,14 @@ public:
 	const InstanceLogFunc&				getInstanceLogFunc() const noexcept;
 	const ElementLogFunc&				getElementLogFunc() const noexcept;
 
+	/**
+	 * Vulkan pipelines are saved to this file when the instance is destroyed and
+	 * loaded from it on startup, which avoids compiling them again. The cache is 
+	 * discarded if it was created by another device or driver version. Empty 
+	 * (the default) disables it.
+	 */
+	void								setPipelineCachePath(std::string path);
+	const std::string&					getPipelineCachePath() const noexcept;
 
 	static void 						defaultInstanceLogFunc(	const Instance& inst, 
 																Severity severity, 
@@ -170,6 +332,7 @@ private:
 	Modules								m_modules;
 	InstanceLogFunc						m_instanceLogFunc;
 	ElementLogFunc						m_elementLogFunc;
+	std::string							m_pipelineCachePath;
 };
 
 
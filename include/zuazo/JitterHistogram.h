@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Chrono.h"
+
+#include <array>
+#include <cstddef>
+
+namespace Zuazo {
+
+/**
+ * Histogram of the main loop's wake-up delays, relative to the scheduled time. Each 
+ * bucket spans JITTER_HISTOGRAM_RESOLUTION, the last one also counting all longer delays.
+ */
+using JitterHistogram = std::array<size_t, 64>;
+
+constexpr Duration JITTER_HISTOGRAM_RESOLUTION = std::chrono::duration_cast<Duration>(std::chrono::microseconds(50));
+
+}
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "Math/Transform.h"
 
 #include <functional>
+#include <memory>
 
 namespace Zuazo {
 
@@ -23,6 +24,23 @@ public:
 	using HasAlphaCallback = std::function<bool(const LayerBase&)>;
 	using DrawCallback = std::function<void(const LayerBase&, const RendererBase&, Graphics::CommandBuffer&)>;
 	using RenderPassCallback = std::function<void(LayerBase&, vk::RenderPass)>;
+	using BatchKeyCallback = std::function<size_t(const LayerBase&, const RendererBase&)>;
+	using FrameIndexCallback = std::function<uint32_t(const LayerBase&)>;
+	using DrawInstancedCallback = std::function<void(const LayerBase&, const RendererBase&, Graphics::CommandBuffer&, vk::Buffer, size_t, uint32_t)>;
+	using StateKeyCallback = std::function<size_t(const LayerBase&, const RendererBase&)>;
+	using RenderPassState = std::shared_ptr<void>;
+
+	static constexpr size_t MAX_RENDER_PASS_STATES = 4;
+
+	/**
+	 * Per-instance data of a batched draw. frameIndex is meant to be a 
+	 * bindless descriptor index.
+	 */
+	struct InstanceData {
+		Math::Mat4x4f						modelMatrix;
+		float								opacity;
+		uint32_t							frameIndex;
+	};
 
 
 	LayerBase(	TransformCallback transformCbk = {},
@@ -56,9 +74,43 @@ public:
 	bool								hasChanged(const RendererBase& renderer) const;
 	void								draw(const RendererBase& renderer, Graphics::CommandBuffer& cmd) const;
 
+	/**
+	 * Records the layer's model matrix and opacity as push constants, so that
+	 * changing them does not require updating a uniform buffer. Only for layers
+	 * which have enabled setUsePushConstants(), as their pipeline layouts must 
+	 * include RendererBase::getPushConstantRanges() in order to be compatible 
+	 * with RendererBase::getPushConstantPipelineLayout().
+	 */
+	bool								getUsePushConstants() const noexcept;
+	void								pushConstants(	const Graphics::Vulkan& vulkan,
+														vk::CommandBuffer cmd,
+														vk::PipelineLayout layout ) const noexcept;
+
+	/**
+	 * Consecutive layers sharing a non-zero batch key, blending mode and rendering layer 
+	 * are drawn by the first of them with a single instanced draw. The key must therefore
+	 * identify all the pipeline state and resources other than the instance data. The 
+	 * instance buffer holds an InstanceData per layer, starting at the given offset.
+	 */
+	size_t								getBatchKey(const RendererBase& renderer) const;
+	InstanceData						getInstanceData() const;
+	void								drawInstanced(	const RendererBase& renderer, 
+														Graphics::CommandBuffer& cmd,
+														vk::Buffer instanceBuffer,
+														size_t instanceOffset,
+														uint32_t instanceCount ) const;
+
 	void								setRenderPass(vk::RenderPass pass);
 	vk::RenderPass						getRenderPass() const noexcept;
 
+	/**
+	 * Identifies the pipeline and descriptors bound by the draw callback. Renderers 
+	 * sort layers whose order does not alter the result by it, so that the same state 
+	 * is bound consecutively. 0 (the default without a state key callback) means 
+	 * unknown, in which case renderers keep the layer's relative order.
+	 */
+	size_t								getStateKey(const RendererBase& renderer) const;
+
 protected:
 	void								setTransformCallback(TransformCallback cbk);
 	const TransformCallback&			getTransformCallback() const noexcept;
@@ -84,6 +136,36 @@ protected:
 	void								setRenderPassCallback(RenderPassCallback cbk);
 	const RenderPassCallback&			getRenderPassCallback() const noexcept;
 
+	void								setBatchKeyCallback(BatchKeyCallback cbk);
+	const BatchKeyCallback&				getBatchKeyCallback() const noexcept;
+
+	void								setFrameIndexCallback(FrameIndexCallback cbk);
+	const FrameIndexCallback&			getFrameIndexCallback() const noexcept;
+
+	void								setDrawInstancedCallback(DrawInstancedCallback cbk);
+	const DrawInstancedCallback&		getDrawInstancedCallback() const noexcept;
+
+	void								setStateKeyCallback(StateKeyCallback cbk);
+	const StateKeyCallback&				getStateKeyCallback() const noexcept;
+
+	/**
+	 * Opts in to push constants. Renderers bind their descriptor set with 
+	 * RendererBase::getPushConstantPipelineLayout() before drawing these
+	 * layers and with RendererBase::getBasePipelineLayout() otherwise. 
+	 * Disabled by default.
+	 */
+	void								setUsePushConstants(bool use) noexcept;
+
+	/**
+	 * State (such as pipelines) associated to the current render pass. The most recently
+	 * used MAX_RENDER_PASS_STATES are kept. When switching to a render pass with cached 
+	 * state the render pass callback is not invoked, so layers shared among renderers
+	 * with different render passes do not rebuild it every time. Layers which do not 
+	 * set it are notified on each switch.
+	 */
+	void								setRenderPassState(RenderPassState state);
+	const RenderPassState&				getRenderPassState() const noexcept;
+
 private:
 	struct Impl;
 	Utils::Pimpl<Impl>					m_impl;
@@ -30,10 +30,21 @@ public:
 		DESCRIPTOR_BINDING_COUNT,
 	};
 
+	/**
+	 * Per-layer data sent as push constants by the layers which opt in to 
+	 * them. It fits within the 128 bytes guaranteed by maxPushConstantsSize.
+	 */
+	struct PushConstants {
+		Math::Mat4x4f							modelMatrix;
+		float									opacity;
+	};
+
 	using UniformBufferSizes = Utils::BufferView<const std::pair<uint32_t, size_t>>;
+	using PushConstantRanges = Utils::BufferView<const vk::PushConstantRange>;
 	using DescriptorPoolSizes = Utils::BufferView<const vk::DescriptorPoolSize>;
 	using ViewportSizeCallback = std::function<void(RendererBase&, Math::Vec2f)>;
 	using RenderPassCallback = std::function<void(RendererBase&, vk::RenderPass)>;
+	using SecondaryCommandBufferCallback = std::function<void(const RendererBase&, Graphics::CommandBuffer&)>;
 
 	static constexpr uint32_t DESCRIPTOR_SET = 0;
 
@@ -63,18 +74,66 @@ public:
 	void									setLayers(Utils::BufferView<const LayerRef> layers);
 	Utils::BufferView<const LayerRef>		getLayers() const;
 
+	vk::DescriptorSet						getDescriptorSet() const noexcept;
+
+	/**
+	 * Returns true if the rendered image would differ from the last one drawn, either
+	 * because any layer has changed or because the viewport, render pass, depth-stencil
+	 * format or camera have. Otherwise renderers may skip drawing and present their
+	 * previous TargetFrame again, which does not advance their output's change token.
+	 * Renderers which are also ZuazoBase-s may check it in their has changed callback 
+	 * with ZuazoBase::setUpdateOnChange() enabled.
+	 */
 	bool									layersHaveChanged() const;
 	void									draw(Graphics::CommandBuffer& cmd);
 
+	/**
+	 * Sets the amount of worker threads used to record the layers into secondary command 
+	 * buffers, which are then executed in order by the primary one. 0 (the default) records 
+	 * them serially in the draw() caller's thread. Parallel recording is only used when a 
+	 * secondary command buffer callback is set and there are enough layers. In that case
+	 * getSubpassContents() returns eSecondaryCommandBuffers, so the render pass must be 
+	 * begun with it, and draw callbacks of different layers are invoked concurrently.
+	 */
+	void									setRecordingThreadCount(size_t count);
+	size_t									getRecordingThreadCount() const noexcept;
+	vk::SubpassContents						getSubpassContents() const noexcept;
+
+	/**
+	 * Pipeline and descriptor set binds recorded by the last draw() call. Opaque 
+	 * scene layers are sorted by their state key when depth testing is available, 
+	 * so that redundant pipeline binds can be skipped.
+	 */
+	size_t									getPipelineBindCount() const noexcept;
+	size_t									getDescriptorSetBindCount() const noexcept;
+
 	static UniformBufferSizes				getUniformBufferSizes() noexcept;
 	static DescriptorPoolSizes				getDescriptorPoolSizes() noexcept;
+	static PushConstantRanges				getPushConstantRanges() noexcept;
 	static vk::DescriptorSetLayout			getDescriptorSetLayout(const Graphics::Vulkan& vulkan);
 	static vk::PipelineLayout				getBasePipelineLayout(const Graphics::Vulkan& vulkan);
+	static vk::PipelineLayout				getPushConstantPipelineLayout(const Graphics::Vulkan& vulkan);
 
 protected:
 	void									setViewportSize(Math::Vec2f size);
 	void									setRenderPass(vk::RenderPass pass);
 
+	/**
+	 * The descriptor set bound at DESCRIPTOR_SET. Required in order to draw layers 
+	 * using push constants, as it is rebound with getPushConstantPipelineLayout() 
+	 * for them. Otherwise layers must keep their pipeline layouts compatible with 
+	 * getBasePipelineLayout(), i.e. without push constants.
+	 */
+	void									setDescriptorSet(vk::DescriptorSet descriptorSet) noexcept;
+
+	/**
+	 * Invoked from the recording threads at the beginning of each secondary command 
+	 * buffer. It must record the state which is not inherited from the primary command 
+	 * buffer, such as the viewport, the scissor and the renderer's descriptor set.
+	 */
+	void									setSecondaryCommandBufferCallback(SecondaryCommandBufferCallback cbk);
+	const SecondaryCommandBufferCallback&	getSecondaryCommandBufferCallback() const noexcept;
+
 	void									setDepthStencilFormatCallback(DepthStencilFormatCallback cbk);
 	const DepthStencilFormatCallback&		getDepthStencilFormatCallback() const;
 
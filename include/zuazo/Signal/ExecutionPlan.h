@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Layout.h"
+#include "PadBase.h"
+#include "../Utils/BufferView.h"
+
+#include <vector>
+
+namespace Zuazo::Signal {
+
+/**
+ * ExecutionPlan schedules the outputs of a set of layouts, so that each output's
+ * pull callback is invoked at most once per update, on its first pull. Outputs 
+ * which are not pulled in an update (as none of their consumers was due) are not
+ * evaluated at all. The dependency graph is built from the sources of the inputs
+ * of each layout and it is only recompiled when connections or pads of its 
+ * layouts change.
+ *
+ * beginUpdate() must be called on every update before the consumers pull the
+ * scheduled outputs, otherwise they keep returning the previous evaluation. 
+ * Instance owns a plan with all the opened elements and takes care of this.
+ *
+ * Layouts are grouped in stages, where the layouts of a stage only depend on
+ * previous stages. Layouts which are part of a cycle (or depend on one) are not
+ * scheduled, so their outputs keep being evaluated recursively on demand.
+ *
+ * Layouts must be removed from the plan before being destroyed.
+ */
+class ExecutionPlan {
+public:
+	using Stage = Utils::BufferView<Layout* const>;
+
+	ExecutionPlan() = default;
+	ExecutionPlan(const ExecutionPlan& other) = delete;
+	ExecutionPlan(ExecutionPlan&& other) = default;
+	~ExecutionPlan();
+
+	ExecutionPlan&							operator=(const ExecutionPlan& other) = delete;
+	ExecutionPlan&							operator=(ExecutionPlan&& other) = default;
+
+	void									addLayout(Layout& layout);
+	void									removeLayout(Layout& layout) noexcept;
+	const std::vector<Layout*>&				getLayouts() const noexcept;
+
+	void									compile();
+	bool									isCompiled() const noexcept;
+
+	size_t									getStageCount() const noexcept;
+	Stage									getStage(size_t i) const noexcept;
+	size_t									getUnscheduledCount() const noexcept;
+
+	void									beginUpdate();
+
+private:
+	std::vector<Layout*>					m_layouts;
+
+	bool									m_compiled = false;
+	std::vector<size_t>						m_topologyVersions;
+	std::vector<Layout*>					m_order;
+	std::vector<size_t>						m_stageOffsets;
+
+	void									unschedule() noexcept;
+	static void								setScheduled(Layout& layout, bool sch) noexcept;
+
+};
+
+}
+
+#include "ExecutionPlan.inl"
\ No newline at end of file
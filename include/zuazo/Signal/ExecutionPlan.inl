@@ -0,0 +1,177 @@
+#include "ExecutionPlan.h"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <cassert>
+
+namespace Zuazo::Signal {
+
+inline ExecutionPlan::~ExecutionPlan() {
+	unschedule();
+}
+
+
+
+inline void ExecutionPlan::addLayout(Layout& layout) {
+	assert(std::find(m_layouts.cbegin(), m_layouts.cend(), &layout) == m_layouts.cend());
+	m_layouts.push_back(&layout);
+	m_compiled = false;
+}
+
+inline void ExecutionPlan::removeLayout(Layout& layout) noexcept {
+	const auto ite = std::find(m_layouts.cbegin(), m_layouts.cend(), &layout);
+	assert(ite != m_layouts.cend());
+
+	//Its outputs will be pulled on demand from now on
+	unschedule();
+	m_layouts.erase(ite);
+	m_compiled = false;
+}
+
+inline const std::vector<Layout*>& ExecutionPlan::getLayouts() const noexcept {
+	return m_layouts;
+}
+
+
+
+inline void ExecutionPlan::compile() {
+	unschedule();
+
+	//Remember the topology of each layout, so that changes can be detected
+	m_topologyVersions.clear();
+	m_topologyVersions.reserve(m_layouts.size());
+	std::transform(
+		m_layouts.cbegin(), m_layouts.cend(),
+		std::back_inserter(m_topologyVersions),
+		[] (const Layout* layout) -> size_t {
+			return layout->getTopologyVersion();
+		}
+	);
+	m_compiled = true;
+
+	//Index all the layouts, so that they can be used as nodes
+	std::unordered_map<const Layout*, size_t> indices;
+	indices.reserve(m_layouts.size());
+	for(size_t i = 0; i < m_layouts.size(); ++i) {
+		indices.emplace(m_layouts[i], i);
+	}
+
+	//Add an edge from the layout of each source to the layout of its consumer.
+	//Sources outside this plan are ignored, as they are evaluated on demand
+	std::vector<std::vector<size_t>> successors(m_layouts.size());
+	std::vector<size_t> inDegrees(m_layouts.size(), 0);
+	for(size_t i = 0; i < m_layouts.size(); ++i) {
+		for(const PadBase& pad : m_layouts[i]->m_pads) {
+			const auto* source = pad.getSourcePad();
+
+			if(source) {
+				const auto ite = indices.find(&source->getLayout());
+				if(ite != indices.cend() && ite->second != i) {
+					successors[ite->second].push_back(i);
+					++inDegrees[i];
+				}
+			}
+		}
+	}
+
+	//Kahn's algorithm, a level at a time. Each level forms a stage
+	std::vector<size_t> current;
+	std::vector<size_t> next;
+	for(size_t i = 0; i < m_layouts.size(); ++i) {
+		if(inDegrees[i] == 0) {
+			current.push_back(i);
+		}
+	}
+
+	while(!current.empty()) {
+		m_stageOffsets.push_back(m_order.size());
+
+		for(const auto i : current) {
+			m_order.push_back(m_layouts[i]);
+
+			for(const auto j : successors[i]) {
+				assert(inDegrees[j] > 0);
+				if(--inDegrees[j] == 0) {
+					next.push_back(j);
+				}
+			}
+		}
+
+		current.clear();
+		std::swap(current, next);
+	}
+
+	m_stageOffsets.push_back(m_order.size()); //Sentinel
+
+	//Layouts not present in the order are part of a cycle. Leave them as they were
+	for(auto* layout : m_order) {
+		setScheduled(*layout, true);
+	}
+}
+
+inline bool ExecutionPlan::isCompiled() const noexcept {
+	//Only the layouts of this plan are taken into account. Connecting an input 
+	//changes the topology of its layout, whilst destroying an output changes 
+	//the topology of the layouts of its consumers
+	return m_compiled && std::equal(
+		m_layouts.cbegin(), m_layouts.cend(),
+		m_topologyVersions.cbegin(), m_topologyVersions.cend(),
+		[] (const Layout* layout, size_t version) -> bool {
+			return layout->getTopologyVersion() == version;
+		}
+	);
+}
+
+
+
+inline size_t ExecutionPlan::getStageCount() const noexcept {
+	return m_stageOffsets.empty() ? 0 : m_stageOffsets.size() - 1;
+}
+
+inline ExecutionPlan::Stage ExecutionPlan::getStage(size_t i) const noexcept {
+	assert(i < getStageCount());
+	return Stage(
+		m_order.data() + m_stageOffsets[i],
+		m_order.data() + m_stageOffsets[i + 1]
+	);
+}
+
+inline size_t ExecutionPlan::getUnscheduledCount() const noexcept {
+	return m_layouts.size() - m_order.size();
+}
+
+
+
+inline void ExecutionPlan::beginUpdate() {
+	if(!isCompiled()) {
+		compile();
+	}
+
+	//Outputs are evaluated lazily when pulled, so that only the ones
+	//upstream of the consumers updated in this tick are evaluated
+	for(auto* layout : m_order) {
+		for(PadBase& pad : layout->m_pads) {
+			pad.resetEvaluation();
+		}
+	}
+}
+
+
+
+inline void ExecutionPlan::unschedule() noexcept {
+	for(auto* layout : m_order) {
+		setScheduled(*layout, false);
+	}
+
+	m_order.clear();
+	m_stageOffsets.clear();
+}
+
+inline void ExecutionPlan::setScheduled(Layout& layout, bool sch) noexcept {
+	for(PadBase& pad : layout.m_pads) {
+		pad.setScheduled(sch);
+	}
+}
+
+}
\ No newline at end of file
@@ -51,9 +51,13 @@ public:
 	
 private:
 	Element						m_lastElement;
+	size_t						m_lastChangeToken;
 
+	const PadBase*				getSourcePad() const noexcept override;
+	bool						sourceHasChanged() const noexcept override;
 
 	const Element&				pullFromSource() const noexcept;
+	size_t						getSourceChangeToken() const noexcept;
 };
 
 template<typename T>
@@ -11,6 +11,8 @@ namespace Zuazo::Signal {
 template <typename T>
 inline Input<T>::Input(const Layout& layout, std::string name) noexcept
 	: PadBase(layout, std::move(name))
+	, m_lastElement()
+	, m_lastChangeToken(0)
 {
 }
 
@@ -29,6 +31,7 @@ inline void Input<T>::operator<<(Source& src) noexcept {
 template <typename T>
 inline void Input<T>::setSource(Source* src) noexcept {
 	setSubject(static_cast<Zuazo::Utils::Subject*>(src));
+	PadBase::invalidateTopology();
 }
 
 template <typename T>
@@ -51,11 +54,13 @@ inline const PadProxy<Input<T>>& Input<T>::getProxy() const noexcept {
 template <typename T>
 inline void Input<T>::reset() noexcept {
 	m_lastElement = Element();
+	m_lastChangeToken = 0;
 }
 
 template <typename T>
 inline const typename Input<T>::Element& Input<T>::pull() noexcept {
 	m_lastElement = pullFromSource();
+	m_lastChangeToken = getSourceChangeToken();
 	return m_lastElement;
 }
 
@@ -66,18 +71,37 @@ inline const typename Input<T>::Element& Input<T>::getLastElement() const noexce
 
 template <typename T>
 inline bool Input<T>::hasChanged() const noexcept {
+	//Unscheduled sources only produce new elements when pulled, so their last 
+	//element would be stale. Scheduled ones are evaluated at most once per 
+	//update, so pulling them again when consumed does not invoke the callback
 	const auto& newElement = pullFromSource();
-	return m_lastElement != newElement;
+	return m_lastElement != newElement || m_lastChangeToken != getSourceChangeToken();
 }
 
 
 
+template <typename T>
+inline const PadBase* Input<T>::getSourcePad() const noexcept {
+	return getSource();
+}
+
+template <typename T>
+inline bool Input<T>::sourceHasChanged() const noexcept {
+	return hasChanged();
+}
+
 template <typename T>
 inline const typename Input<T>::Element& Input<T>::pullFromSource() const noexcept {
 	auto* source = getSource();
 	return source ? source->pull() : Source::NO_SIGNAL;
 }
 
+template <typename T>
+inline size_t Input<T>::getSourceChangeToken() const noexcept {
+	const auto* source = getSource();
+	return source ? source->getChangeToken() : 0;
+}
+
 
 /*
  * PadProxy<Input<T>>
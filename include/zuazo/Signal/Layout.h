@@ -8,11 +8,14 @@
 namespace Zuazo::Signal {
 
 class PadBase;
+class ExecutionPlan;
 
 template<typename T>
 class PadProxy;
 
 class Layout {
+	friend PadBase;
+	friend ExecutionPlan;
 public:
 	using PadRef = std::reference_wrapper<PadBase>;
 	
@@ -23,8 +26,8 @@ public:
 	Layout(Layout&& other) = default;
 	virtual ~Layout() = default;
 
-	Layout&													operator=(const Layout& other) = default;
-	Layout&													operator=(Layout&& other) = default;
+	Layout&													operator=(const Layout& other);
+	Layout&													operator=(Layout&& other);
 
 	void                    								setName(std::string name) noexcept;
 	const std::string&      								getName() const noexcept;
@@ -39,6 +42,17 @@ public:
 	template<typename T>
 	const PadProxy<T>*										getPad(std::string_view name) const noexcept;
 
+	/**
+	 * Returns true if any of the inputs has a new element since it was last
+	 * pulled. Sources are pulled in order to compare with their current element.
+	 * Scheduled sources are evaluated at most once per update, so the pull is 
+	 * not repeated when the inputs are pulled afterwards. Unscheduled ones (e.g.
+	 * part of a cycle) are evaluated again. Layouts whose outputs only depend on
+	 * their inputs may use it to skip their update, leaving their last output
+	 * untouched.
+	 */
+	bool													inputsHaveChanged() const noexcept;
+
 protected:
 	void													registerPad(PadRef pad);
 	template<typename T>
@@ -53,6 +67,10 @@ protected:
 private:
 	std::string												m_name;
 	std::vector<PadRef>										m_pads;
+	mutable size_t											m_topologyVersion;
+
+	size_t													getTopologyVersion() const noexcept;
+	void													invalidateTopology() const noexcept;
 
 	template<typename T>
 	T*														findPad(std::string_view name) const noexcept;
@@ -15,6 +15,8 @@ namespace Zuazo::Signal {
 
 inline Layout::Layout(std::string name)
 	: m_name(std::move(name))
+	, m_pads()
+	, m_topologyVersion(0)
 {
 }
 
@@ -22,10 +24,28 @@ template<typename InputIt>
 inline Layout::Layout(std::string name, InputIt beginPads, InputIt endPads)
 	: m_name(std::move(name))
 	, m_pads(beginPads, endPads)
+	, m_topologyVersion(0)
 {
 }
 
 
+inline Layout& Layout::operator=(const Layout& other) {
+	m_name = other.m_name;
+	m_pads = other.m_pads;
+	invalidateTopology(); //Do not copy the version, as it must only increase
+
+	return *this;
+}
+
+inline Layout& Layout::operator=(Layout&& other) {
+	m_name = std::move(other.m_name);
+	m_pads = std::move(other.m_pads);
+	invalidateTopology(); //Do not copy the version, as it must only increase
+
+	return *this;
+}
+
+
 
 inline void Layout::setName(std::string name) noexcept {
 	m_name = std::move(name);
@@ -60,9 +80,20 @@ inline const PadProxy<T>* Layout::getPad(std::string_view name) const noexcept {
 }
 
 
+inline bool Layout::inputsHaveChanged() const noexcept {
+	return std::any_of(
+		m_pads.cbegin(), m_pads.cend(),
+		[] (const PadBase& pad) -> bool {
+			return pad.sourceHasChanged();
+		}
+	);
+}
+
+
 
 inline void Layout::registerPad(PadRef pad) {
 	m_pads.push_back(pad);
+	invalidateTopology();
 }
 
 template<typename T>
@@ -73,6 +104,7 @@ inline void Layout::registerPad(PadProxy<T>& pad) {
 template<typename InputIt>
 inline void Layout::registerPad(InputIt begin, InputIt end) {
 	m_pads.insert(m_pads.cend(), begin, end);
+	invalidateTopology();
 }
 
 inline void Layout::removePad(PadRef pad) noexcept {
@@ -83,6 +115,7 @@ inline void Layout::removePad(PadRef pad) noexcept {
 		}
 	);
 	m_pads.erase(ite);
+	invalidateTopology();
 }
 
 template<typename T>
@@ -91,6 +124,20 @@ inline void Layout::removePad(PadProxy<T>& pad) {
 }
 
 
+/*
+ * The topology version is increased every time a pad or a connection of 
+ * this layout changes, so that ExecutionPlans know when to recompile
+ */
+
+inline size_t Layout::getTopologyVersion() const noexcept {
+	return m_topologyVersion;
+}
+
+inline void Layout::invalidateTopology() const noexcept {
+	++m_topologyVersion;
+}
+
+
 template <typename T>
 inline T* Layout::findPad(std::string_view str) const noexcept {
 	T* result = nullptr;
@@ -29,7 +29,7 @@ public:
 					PullCallback pullCbk = {} ) noexcept;
 	Output(const Output& other) = default;
 	Output(Output&& other) noexcept = default;
-	virtual ~Output() = default;
+	virtual ~Output();
 
 	Output&						operator=(const Output& other) noexcept = default;
 	Output&						operator=(Output&& other) noexcept = default;
@@ -45,11 +45,14 @@ public:
 	void						setMaxRecursion(size_t rec) noexcept;
 	size_t						getMaxRecursion() const noexcept;
 	size_t						getRecursion() const noexcept;
+	bool						isScheduled() const noexcept;
 
 	void						reset() noexcept;
 	void						push(Element element) noexcept;
+	void						invalidate() noexcept;
 	const Element&				pull() noexcept;
 	const Element&				getLastElement() const noexcept;
+	size_t						getChangeToken() const noexcept;
 
 	static const Element		NO_SIGNAL;
 
@@ -57,7 +60,13 @@ private:
 	PullCallback				m_pullCallback;
 	size_t						m_maxRecursion;
 	size_t						m_recursion;
+	bool						m_scheduled;
+	bool						m_evaluated;
 	T							m_lastElement;
+	size_t						m_changeToken;
+
+	void						setScheduled(bool sch) noexcept override;
+	void						resetEvaluation() noexcept override;
 
 };
 
@@ -87,10 +96,12 @@ public:
 	using PadBase::getLayout;
 	using Output<T>::getName;
 	using Output<T>::getLastElement;
+	using Output<T>::getChangeToken;
 
 	using Output<T>::setMaxRecursion;
 	using Output<T>::getMaxRecursion;
 	using Output<T>::getRecursion;
+	using Output<T>::isScheduled;
 
 	Consumers					getConsumers() const;
 
@@ -19,10 +19,21 @@ inline Output<T>::Output(	const Layout& layout,
 	, m_pullCallback(std::move(pullCbk))
 	, m_maxRecursion(1)
 	, m_recursion(0)
+	, m_scheduled(false)
+	, m_evaluated(false)
 	, m_lastElement()
+	, m_changeToken(0)
 {
 }
 
+template <typename T>
+inline Output<T>::~Output() {
+	//Consumers get disconnected, so their layouts change
+	for(auto* observer : getObservers()) {
+		static_cast<Consumer&>(*observer).invalidateTopology();
+	}
+}
+
 
 
 template <typename T>
@@ -81,6 +92,10 @@ inline size_t Output<T>::getRecursion() const noexcept {
 	return m_recursion;
 }
 
+template <typename T>
+inline bool Output<T>::isScheduled() const noexcept {
+	return m_scheduled;
+}
 
 
 
@@ -91,13 +106,28 @@ inline void Output<T>::reset() noexcept {
 
 template <typename T>
 void Output<T>::push(Element element) noexcept {
-	m_lastElement = std::move(element);
+	//Only advance the change token when the element actually changes, so that
+	//pushing the last element again (reusing the previous output) does not
+	//cause any work downstream
+	if(element != m_lastElement) {
+		m_lastElement = std::move(element);
+		++m_changeToken;
+	}
+}
+
+template <typename T>
+inline void Output<T>::invalidate() noexcept {
+	//For elements which have been modified in place
+	++m_changeToken;
 }
 
 template <typename T>
 inline const typename Output<T>::Element& Output<T>::pull() noexcept {
-	//Only invoke the callback if not exceeding the maximum recursion
-	if(m_pullCallback && m_recursion < m_maxRecursion) {
+	//Only invoke the callback if not exceeding the maximum recursion. Scheduled 
+	//outputs are only evaluated on their first pull of each update, so that
+	//consumers sharing them do not evaluate them again
+	if(m_pullCallback && !(m_scheduled && m_evaluated) && m_recursion < m_maxRecursion) {
+		m_evaluated = true;
 		++m_recursion;
 		m_pullCallback(*this);
 		--m_recursion;
@@ -111,6 +141,24 @@ inline const typename Output<T>::Element& Output<T>::getLastElement() const noex
 	return m_lastElement;
 }
 
+template <typename T>
+inline size_t Output<T>::getChangeToken() const noexcept {
+	return m_changeToken;
+}
+
+
+
+template <typename T>
+inline void Output<T>::setScheduled(bool sch) noexcept {
+	m_scheduled = sch;
+	m_evaluated = false;
+}
+
+template <typename T>
+inline void Output<T>::resetEvaluation() noexcept {
+	m_evaluated = false;
+}
+
 
 /*
  * PadProxy<Output<T>>
@@ -5,11 +5,14 @@
 namespace Zuazo::Signal {
 
 class Layout;
+class ExecutionPlan;
 
 template<typename T>
 class PadProxy;
 
 class PadBase {
+	friend Layout;
+	friend ExecutionPlan;
 public:
 	PadBase(const Layout& layout, std::string name) noexcept;
 	PadBase(const PadBase& other) = default; 
@@ -34,9 +37,18 @@ public:
 
 	void                					setName(std::string name) noexcept;
 	const std::string&						getName() const noexcept;
+
+protected:
+	void									invalidateTopology() const noexcept;
+
 private:
 	std::reference_wrapper<const Layout>	m_layout;
 	std::string								m_name;
+
+	virtual const PadBase*					getSourcePad() const noexcept;
+	virtual bool							sourceHasChanged() const noexcept;
+	virtual void							setScheduled(bool sch) noexcept;
+	virtual void							resetEvaluation() noexcept;
 	
 };
 
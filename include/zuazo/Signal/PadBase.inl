@@ -1,5 +1,7 @@
 #include "PadBase.h"
 
+#include "Layout.h"
+
 namespace Zuazo::Signal {
 
 inline PadBase::PadBase(const Layout& layout, std::string name) noexcept
@@ -60,4 +62,26 @@ inline const std::string& PadBase::getName() const noexcept {
 	return m_name;
 }
 
+
+
+inline void PadBase::invalidateTopology() const noexcept {
+	getLayout().invalidateTopology();
+}
+
+
+
+inline const PadBase* PadBase::getSourcePad() const noexcept {
+	return nullptr;
+}
+
+inline bool PadBase::sourceHasChanged() const noexcept {
+	return false;
+}
+
+inline void PadBase::setScheduled(bool) noexcept {
+}
+
+inline void PadBase::resetEvaluation() noexcept {
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "LayerBase.h"
+#include "Video.h"
+#include "ScalingFilter.h"
+#include "Graphics/Vulkan.h"
+#include "Math/Vector.h"
+#include "Utils/Pimpl.h"
+
+namespace Zuazo {
+
+/**
+ * Draws a video frame stretched onto a rectangle of the given size, centered
+ * at the origin of the layer's transform. The pipeline is kept for each of the
+ * render passes it is drawn with, so the layer may be shared among renderers
+ * with different render passes. When bindless mode is supported the frame is
+ * sampled through the bindless table, so changing it only updates an index.
+ */
+class VideoLayer : public LayerBase {
+public:
+	explicit VideoLayer(const Graphics::Vulkan& vulkan,
+						Math::Vec2f size = Math::Vec2f(1.0f, 1.0f) );
+	VideoLayer(const VideoLayer& other) = delete;
+	VideoLayer(VideoLayer&& other);
+	virtual ~VideoLayer();
+
+	VideoLayer&							operator=(const VideoLayer& other) = delete;
+	VideoLayer&							operator=(VideoLayer&& other);
+
+	const Graphics::Vulkan&				getVulkan() const noexcept;
+
+	void								setSize(Math::Vec2f size);
+	Math::Vec2f							getSize() const noexcept;
+
+	void								setScalingFilter(ScalingFilter filter);
+	ScalingFilter						getScalingFilter() const noexcept;
+
+	void								setVideo(Video video);
+	const Video&						getVideo() const noexcept;
+
+private:
+	struct Impl;
+	Utils::Pimpl<Impl>					m_impl;
+
+};
+
+}
\ No newline at end of file
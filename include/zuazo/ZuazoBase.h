@@ -20,6 +20,7 @@ public:
 	using CloseCallback = std::function<void(ZuazoBase&)>;
 	using AsyncCloseCallback = std::function<void(ZuazoBase&, std::unique_lock<Instance>&)>;
 	using UpdateCallback = std::function<void()>;
+	using HasChangedCallback = std::function<bool(const ZuazoBase&)>;
 
 	ZuazoBase(	Instance& instance, 
 				std::string name,
@@ -51,6 +52,8 @@ public:
 	void							setPostUpdateCallback(UpdateCallback cbk) noexcept;
 	const UpdateCallback&			getPostUpdateCallback() const noexcept;
 
+	Instance::CallbackStatistics	getUpdateStatistics() const noexcept;
+
 protected:
 	void							setUpdateCallback(UpdateCallback cbk) noexcept;
 	const UpdateCallback&			getUpdateCallback() const noexcept;
@@ -64,12 +67,27 @@ protected:
 	void							setCloseCallback(CloseCallback cbk) noexcept;
 	const CloseCallback&			getCloseCallback() const noexcept;
 
+	/**
+	 * When enabled, the update callbacks are skipped unless any of the inputs has
+	 * changed or the has changed callback returns true. Unchanged elements keep their
+	 * last outputs without advancing their change tokens, so the elements downstream 
+	 * can also skip their update. Renderers should check RendererBase::layersHaveChanged()
+	 * in the has changed callback.
+	 */
+	void							setUpdateOnChange(bool ena) noexcept;
+	bool							getUpdateOnChange() const noexcept;
+
+	void							setHasChangedCallback(HasChangedCallback cbk) noexcept;
+	const HasChangedCallback&		getHasChangedCallback() const noexcept;
+
 	void        					update() const noexcept;
 	void							enableRegularUpdate(Instance::Priority prior) const;
 	void							disableRegularUpdate() const noexcept;
 
 	void							enablePeriodicUpdate(	Instance::Priority prior, 
 															Duration period ) const;
+	void							enablePeriodicUpdate(	Instance::Priority prior, 
+															Rate rate ) const;
 	void							disablePeriodicUpdate() const noexcept;
 
 private:
@@ -5,6 +5,16 @@
 #define frame_descriptor_set(x) 															\
 	layout(set = x, binding = frame_SAMPLER_BINDING) uniform sampler2D frame_sampler(x);	\
 
+/*
+ * Bindless mode. Requires GL_EXT_nonuniform_qualifier. The index of each 
+ * frame is obtained with Frame::getBindlessIndex() and it should be wrapped
+ * with nonuniformEXT() unless it is uniform across the draw
+ */
+#define frame_bindless_descriptor_set(x)																	\
+	layout(set = x, binding = frame_BINDLESS_SAMPLER_BINDING) uniform sampler2D frame_bindless_samplers[];	\
+
+#define frame_bindless_sampler(index) frame_bindless_samplers[index]
+
 /*
  * Sampling interpolation operations
  */
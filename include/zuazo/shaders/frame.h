@@ -13,6 +13,7 @@
 #endif
 
 ZUAZO_IF_CPP(constexpr uint32_t, const uint) frame_SAMPLER_BINDING = 0;
+ZUAZO_IF_CPP(constexpr uint32_t, const uint) frame_BINDLESS_SAMPLER_BINDING = 0;
 
 ZUAZO_IF_CPP(constexpr int32_t, const int) frame_SAMPLE_MODE_PASSTHOUGH = 0;
 ZUAZO_IF_CPP(constexpr int32_t, const int) frame_SAMPLE_MODE_BILINEAR = 1;
@@ -0,0 +1,25 @@
+/*
+ * This header file will be included from GLSL shaders, so C++ content
+ * is discriminaded by the macro definition __cplusplus
+ */
+#ifdef __cplusplus
+	#pragma once
+	#define ZUAZO_IF_CPP(x, y) x
+
+	#include <cstdint>
+
+#else
+	#define ZUAZO_IF_CPP(x, y) y
+#endif
+
+ZUAZO_IF_CPP(constexpr uint32_t, const uint) vl_RENDERER_DESCRIPTOR_SET = 0;
+ZUAZO_IF_CPP(constexpr uint32_t, const uint) vl_LAYER_DESCRIPTOR_SET = 1;
+ZUAZO_IF_CPP(constexpr uint32_t, const uint) vl_FRAME_DESCRIPTOR_SET = 2;
+
+ZUAZO_IF_CPP(constexpr uint32_t, const uint) vl_PROJECTION_MATRIX_BINDING = 0;
+
+ZUAZO_IF_CPP(constexpr uint32_t, const uint) vl_LAYER_DATA_BINDING = 0;
+
+ZUAZO_IF_CPP(constexpr int32_t, const int) vl_SAMPLE_MODE_ID = 0;
+
+ZUAZO_IF_CPP(constexpr uint32_t, const uint) vl_VERTEX_COUNT = 4;
\ No newline at end of file
@@ -0,0 +1,40 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : enable
+
+#include "video_layer.h"
+
+/*
+ * This shader needs to be executed for 4
+ * vertices as a triangle strip. It emits 
+ * an unit square centered at the origin, 
+ * which is scaled to the layer's size by
+ * the model matrix.
+ */
+
+//Vertex I/O
+layout(location = 0) out vec2 out_uv;
+
+//Uniform buffers
+layout(set = vl_RENDERER_DESCRIPTOR_SET, binding = vl_PROJECTION_MATRIX_BINDING) uniform ProjectionMatrixBlock {
+	mat4 projectionMatrix;
+};
+
+layout(set = vl_LAYER_DESCRIPTOR_SET, binding = vl_LAYER_DATA_BINDING) uniform LayerDataBlock {
+	mat4 modelMatrix;
+	float opacity;
+	uint frameIndex; //Only used in bindless mode
+};
+
+
+void main() {
+	const ivec2 BIT_MASK = ivec2(1, 2); //Selects the first and second bits
+
+	//x: (gl_VertexIndex & 1) ? 1.0f : 0.0f
+	//y: (gl_VertexIndex & 2) ? 1.0f : 0.0f
+	const vec2 corner = vec2(ivec2(gl_VertexIndex) & BIT_MASK) / vec2(BIT_MASK);
+	const vec2 pos = corner - vec2(0.5f);
+
+	gl_Position = projectionMatrix * modelMatrix * vec4(pos, 0.0f, 1.0f);
+	out_uv = vec2(corner.x, 1.0f - corner.y); //Images are stored top to bottom
+}
\ No newline at end of file
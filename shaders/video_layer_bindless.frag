@@ -0,0 +1,31 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+#include "video_layer.h"
+#include "frame.glsl"
+
+//Specialization Constants
+layout (constant_id = vl_SAMPLE_MODE_ID) const int SAMPLE_MODE = frame_SAMPLE_MODE_PASSTHOUGH;
+
+//Vertex I/O
+layout(location = 0) in vec2 in_uv;
+layout(location = 0) out vec4 out_color;
+
+//Uniform buffers
+layout(set = vl_LAYER_DESCRIPTOR_SET, binding = vl_LAYER_DATA_BINDING) uniform LayerDataBlock {
+	mat4 modelMatrix;
+	float opacity;
+	uint frameIndex; //Only used in bindless mode
+};
+
+//Samplers. The index is uniform across the draw
+frame_bindless_descriptor_set(vl_FRAME_DESCRIPTOR_SET)
+
+
+void main() {
+	//Blending expects pre-multiplied alpha, so opacity scales all the components
+	out_color = frame_premultiply_alpha(frame_texture(SAMPLE_MODE, frame_bindless_sampler(frameIndex), in_uv));
+	out_color *= opacity;
+}
\ No newline at end of file
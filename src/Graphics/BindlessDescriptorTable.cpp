@@ -0,0 +1,222 @@
+#include "BindlessDescriptorTable.h"
+
+#include <zuazo/Exception.h>
+#include <zuazo/shaders/frame.h>
+
+#include <array>
+#include <cassert>
+
+namespace Zuazo::Graphics {
+
+/*
+ * Vulkan::BindlessSlot
+ */
+
+Vulkan::BindlessSlot::BindlessSlot() noexcept
+	: m_table(nullptr)
+	, m_index(0)
+{
+}
+
+Vulkan::BindlessSlot::BindlessSlot(	BindlessDescriptorTable& table,
+									uint32_t index ) noexcept
+	: m_table(&table)
+	, m_index(index)
+{
+}
+
+Vulkan::BindlessSlot::BindlessSlot(BindlessSlot&& other) noexcept
+	: m_table(other.m_table)
+	, m_index(other.m_index)
+{
+	other.m_table = nullptr;
+}
+
+Vulkan::BindlessSlot::~BindlessSlot() {
+	reset();
+}
+
+Vulkan::BindlessSlot& Vulkan::BindlessSlot::operator=(BindlessSlot&& other) noexcept {
+	if(this != &other) {
+		reset();
+
+		m_table = other.m_table;
+		m_index = other.m_index;
+
+		other.m_table = nullptr;
+	}
+
+	return *this;
+}
+
+
+
+Vulkan::BindlessSlot::operator bool() const noexcept {
+	return m_table != nullptr;
+}
+
+uint32_t Vulkan::BindlessSlot::getIndex() const noexcept {
+	assert(m_table);
+	return m_index;
+}
+
+
+
+void Vulkan::BindlessSlot::reset() noexcept {
+	if(m_table) {
+		m_table->release(m_index);
+		m_table = nullptr;
+	}
+}
+
+
+
+/*
+ * BindlessDescriptorTable
+ */
+
+BindlessDescriptorTable::BindlessDescriptorTable(	const vk::DispatchLoaderDynamic& disp,
+													vk::Device device,
+													uint32_t capacity )
+	: m_dispatcher(disp)
+	, m_device(device)
+	, m_capacity(capacity)
+	, m_descriptorSetLayout(createDescriptorSetLayout())
+	, m_descriptorPool(createDescriptorPool())
+	, m_descriptorSet(allocateDescriptorSet())
+	, m_mutex()
+	, m_nextIndex(0)
+	, m_freeIndices()
+{
+}
+
+
+
+vk::DescriptorSetLayout BindlessDescriptorTable::getDescriptorSetLayout() const noexcept {
+	return *m_descriptorSetLayout;
+}
+
+vk::DescriptorSet BindlessDescriptorTable::getDescriptorSet() const noexcept {
+	return m_descriptorSet;
+}
+
+uint32_t BindlessDescriptorTable::getCapacity() const noexcept {
+	return m_capacity;
+}
+
+
+
+Vulkan::BindlessSlot BindlessDescriptorTable::allocate(	vk::ImageView imageView,
+														vk::Sampler sampler )
+{
+	//Updates to the same descriptor set need to be externally synchronized
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	uint32_t index;
+	if(!m_freeIndices.empty()) {
+		index = m_freeIndices.back();
+		m_freeIndices.pop_back();
+	} else if(m_nextIndex < m_capacity) {
+		index = m_nextIndex++;
+	} else {
+		throw Exception("Bindless descriptor table is full");
+	}
+
+	const std::array<vk::DescriptorImageInfo, 1> descriptorImageInfos = {
+		vk::DescriptorImageInfo(
+			sampler,												//Sampler
+			imageView,												//Image view
+			vk::ImageLayout::eShaderReadOnlyOptimal					//Layout
+		)
+	};
+
+	const std::array<vk::WriteDescriptorSet, 1> writeDescriptorSets = {
+		vk::WriteDescriptorSet( //Image descriptor
+			m_descriptorSet,										//Descriptor set
+			frame_BINDLESS_SAMPLER_BINDING,							//Binding
+			index, 													//Index
+			descriptorImageInfos.size(), 							//Descriptor count
+			vk::DescriptorType::eCombinedImageSampler,				//Descriptor type
+			descriptorImageInfos.data(), 							//Images
+			nullptr, 												//Buffers
+			nullptr													//Texel buffers
+		)
+	};
+
+	m_device.updateDescriptorSets(writeDescriptorSets, {}, m_dispatcher.get());
+
+	return Vulkan::BindlessSlot(*this, index);
+}
+
+void BindlessDescriptorTable::release(uint32_t index) noexcept {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	//The descriptor is left as it is. As the binding is partially bound,
+	//it does not need to be valid while it is not used
+	assert(index < m_nextIndex);
+	m_freeIndices.push_back(index);
+}
+
+
+
+vk::UniqueDescriptorSetLayout BindlessDescriptorTable::createDescriptorSetLayout() const {
+	const std::array bindings = {
+		vk::DescriptorSetLayoutBinding(
+			frame_BINDLESS_SAMPLER_BINDING,							//Binding
+			vk::DescriptorType::eCombinedImageSampler,				//Type
+			m_capacity,												//Count
+			vk::ShaderStageFlagBits::eAllGraphics,					//Shader stage
+			nullptr													//Immutable samplers
+		)
+	};
+
+	const std::array<vk::DescriptorBindingFlagsEXT, bindings.size()> bindingFlags = {
+		vk::DescriptorBindingFlagBitsEXT::ePartiallyBound |
+		vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind |
+		vk::DescriptorBindingFlagBitsEXT::eUpdateUnusedWhilePending
+	};
+
+	const vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo(
+		bindingFlags.size(), bindingFlags.data()
+	);
+
+	const auto createInfo = vk::DescriptorSetLayoutCreateInfo(
+		vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPoolEXT,
+		bindings.size(), bindings.data()
+	).setPNext(&bindingFlagsCreateInfo);
+
+	return m_device.createDescriptorSetLayoutUnique(createInfo, nullptr, m_dispatcher.get());
+}
+
+vk::UniqueDescriptorPool BindlessDescriptorTable::createDescriptorPool() const {
+	const std::array<vk::DescriptorPoolSize, 1> poolSizes = {
+		vk::DescriptorPoolSize(
+			vk::DescriptorType::eCombinedImageSampler,				//Descriptor type
+			m_capacity												//Descriptor count
+		)
+	};
+
+	const vk::DescriptorPoolCreateInfo createInfo(
+		vk::DescriptorPoolCreateFlagBits::eUpdateAfterBindEXT,		//Flags
+		1,															//Descriptor set count
+		poolSizes.size(), poolSizes.data()							//Pool sizes
+	);
+
+	return m_device.createDescriptorPoolUnique(createInfo, nullptr, m_dispatcher.get());
+}
+
+vk::DescriptorSet BindlessDescriptorTable::allocateDescriptorSet() const {
+	const auto layout = *m_descriptorSetLayout;
+	const vk::DescriptorSetAllocateInfo allocInfo(
+		*m_descriptorPool,											//Pool
+		1, &layout													//Layouts
+	);
+
+	//It will be freed alongside the pool
+	vk::DescriptorSet result;
+	const auto res = m_device.allocateDescriptorSets(&allocInfo, &result, m_dispatcher.get());
+	vk::createResultValue(res, VULKAN_HPP_NAMESPACE_STRING"::Device::allocateDescriptorSets");
+	return result;
+}
+
+}
\ No newline at end of file
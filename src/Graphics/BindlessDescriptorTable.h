@@ -0,0 +1,53 @@
+#pragma once
+
+#include <zuazo/Graphics/Vulkan.h>
+
+#include <vector>
+#include <mutex>
+
+namespace Zuazo::Graphics {
+
+/**
+ * A single descriptor set holding a large array of combined image samplers,
+ * which can be indexed from shaders. The array is partially bound and it is 
+ * updated after bind, so slots can be written and recycled while the set is 
+ * bound in pending command buffers, as long as those slots are not used by them.
+ */
+class BindlessDescriptorTable {
+public:
+	BindlessDescriptorTable(const vk::DispatchLoaderDynamic& disp,
+							vk::Device device,
+							uint32_t capacity );
+	BindlessDescriptorTable(const BindlessDescriptorTable& other) = delete;
+	~BindlessDescriptorTable() = default;
+
+	BindlessDescriptorTable&				operator=(const BindlessDescriptorTable& other) = delete;
+
+	vk::DescriptorSetLayout					getDescriptorSetLayout() const noexcept;
+	vk::DescriptorSet						getDescriptorSet() const noexcept;
+	uint32_t								getCapacity() const noexcept;
+
+	Vulkan::BindlessSlot					allocate(	vk::ImageView imageView,
+														vk::Sampler sampler );
+	void									release(uint32_t index) noexcept;
+
+private:
+	std::reference_wrapper<const vk::DispatchLoaderDynamic> m_dispatcher;
+	vk::Device								m_device;
+	uint32_t								m_capacity;
+
+	vk::UniqueDescriptorSetLayout			m_descriptorSetLayout;
+	vk::UniqueDescriptorPool				m_descriptorPool;
+	vk::DescriptorSet						m_descriptorSet;
+
+	std::mutex								m_mutex;
+	uint32_t								m_nextIndex;
+	std::vector<uint32_t>					m_freeIndices;
+
+	vk::UniqueDescriptorSetLayout			createDescriptorSetLayout() const;
+	vk::UniqueDescriptorPool				createDescriptorPool() const;
+	vk::DescriptorSet						allocateDescriptorSet() const;
+
+};
+
+}
\ No newline at end of file
@@ -20,7 +20,11 @@ vk::Buffer Buffer::getBuffer() const noexcept {
 }
 
 vk::DeviceMemory Buffer::getDeviceMemory() const noexcept {
-	return *m_memory;
+	return m_memory.getDeviceMemory();
+}
+
+const Vulkan::Allocation& Buffer::getMemory() const noexcept {
+	return m_memory;
 }
 
 
@@ -40,16 +44,16 @@ vk::UniqueBuffer Buffer::createBuffer(	const Vulkan& vulkan,
 	return vulkan.createBuffer(createInfo);
 }
 
-vk::UniqueDeviceMemory Buffer::allocateMemory(	const Vulkan& vulkan,
-												vk::Buffer buffer,
-												vk::MemoryPropertyFlags properties )
+Vulkan::Allocation Buffer::allocateMemory(	const Vulkan& vulkan,
+											vk::Buffer buffer,
+											vk::MemoryPropertyFlags properties )
 {
 
 	const auto requirements = vulkan.getMemoryRequirements(buffer);
 
-	auto deviceMemory = vulkan.allocateMemory(requirements, properties);
-	vulkan.bindMemory(buffer, *deviceMemory, 0);
-	return deviceMemory;
+	auto allocation = vulkan.allocateMemory(requirements, properties);
+	vulkan.bindMemory(buffer, allocation.getDeviceMemory(), allocation.getOffset());
+	return allocation;
 }
 
 }
\ No newline at end of file
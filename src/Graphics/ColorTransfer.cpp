@@ -4,6 +4,7 @@
 #include <zuazo/Utils/StaticId.h>
 
 #include <unordered_map>
+#include <mutex>
 #include <cstring>
 
 #include "../../shaders/color_transfer.h"
@@ -420,12 +421,17 @@ struct ColorTransferRead::Impl {
 	{
 		using Index = std::tuple<uint32_t, vk::Sampler>;
 		static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids;
+		static std::mutex idsMutex;
 
 		const Index index(planeCount, sampler.getSampler());
-		const auto& id = ids[index];  //TODO thread safe
+		const Utils::StaticId* id;
+		{
+			std::lock_guard<std::mutex> lock(idsMutex);
+			id = &ids[index];
+		}
 
 		//Try to retrive the layout from cache
-		auto result = vulkan.createDescriptorSetLayout(id);
+		auto result = vulkan.createDescriptorSetLayout(*id);
 		if(!result) {
 			const std::vector<vk::Sampler> samplers(planeCount, sampler.getSampler());
 
@@ -444,7 +450,7 @@ struct ColorTransferRead::Impl {
 				bindings.size(), bindings.data()
 			);
 
-			result = vulkan.createDescriptorSetLayout(id, createInfo);
+			result = vulkan.createDescriptorSetLayout(*id, createInfo);
 		}
 		assert(result);
 
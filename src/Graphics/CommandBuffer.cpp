@@ -10,6 +10,9 @@ CommandBuffer::CommandBuffer(	const Vulkan& vulkan,
 	: m_vulkan(vulkan)
 	, m_commandPool(std::move(commandPool))
 	, m_commandBuffer(std::move(commandBuffer))
+	, m_graphicsPipeline()
+	, m_pipelineBindCount(0)
+	, m_descriptorSetBindCount(0)
 {
 }
 
@@ -19,6 +22,9 @@ CommandBuffer::CommandBuffer(	const Vulkan& vulkan,
 	: m_vulkan(vulkan)
 	, m_commandPool(std::move(commandPool))
 	, m_commandBuffer(createCommandBuffer(vulkan, level, **m_commandPool))
+	, m_graphicsPipeline()
+	, m_pipelineBindCount(0)
+	, m_descriptorSetBindCount(0)
 {
 }
 
@@ -42,10 +48,22 @@ Utils::BufferView<const CommandBuffer::Dependency> CommandBuffer::getDependencie
 }
 
 
+size_t CommandBuffer::getPipelineBindCount() const noexcept {
+	return m_pipelineBindCount;
+}
+
+size_t CommandBuffer::getDescriptorSetBindCount() const noexcept {
+	return m_descriptorSetBindCount;
+}
+
+
 
 void CommandBuffer::begin(const vk::CommandBufferBeginInfo& beginInfo) noexcept {
 	getVulkan().begin(get(), beginInfo);
 	m_dependencies.clear();
+	m_graphicsPipeline = vk::Pipeline();
+	m_pipelineBindCount = 0;
+	m_descriptorSetBindCount = 0;
 }
 
 void CommandBuffer::end() noexcept {
@@ -56,6 +74,7 @@ void CommandBuffer::end() noexcept {
 
 void CommandBuffer::execute(Utils::BufferView<const vk::CommandBuffer> buf) noexcept {
 	getVulkan().execute(get(), buf);
+	m_graphicsPipeline = vk::Pipeline(); //Bound state is undefined afterwards
 }
 
 
@@ -204,7 +223,16 @@ void CommandBuffer::nextSubpass(vk::SubpassContents contents) noexcept {
 void CommandBuffer::bindPipeline(	vk::PipelineBindPoint bindPoint, 
 									vk::Pipeline pipeline ) noexcept
 {
+	if(bindPoint == vk::PipelineBindPoint::eGraphics) {
+		if(pipeline == m_graphicsPipeline) {
+			return; //Already bound
+		}
+
+		m_graphicsPipeline = pipeline;
+	}
+
 	getVulkan().bindPipeline(get(), bindPoint, pipeline);
+	++m_pipelineBindCount;
 }
 
 void CommandBuffer::bindVertexBuffers(	uint32_t firstBinding, 
@@ -228,6 +256,7 @@ void CommandBuffer::bindDescriptorSets(	vk::PipelineBindPoint pipelineBindPoint,
 										Utils::BufferView<const uint32_t> dynamicOffsets ) noexcept
 {
 	getVulkan().bindDescriptorSets(get(), pipelineBindPoint, layout, firstSet, descriptorSets, dynamicOffsets);
+	++m_descriptorSetBindCount;
 }
 
 void CommandBuffer::setViewport(uint32_t first,
@@ -0,0 +1,197 @@
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Zuazo::Graphics {
+
+/*
+ * Vulkan::PooledDescriptorSet
+ */
+
+Vulkan::PooledDescriptorSet::PooledDescriptorSet() noexcept
+	: m_allocator(nullptr)
+	, m_layout()
+	, m_descriptorSet()
+{
+}
+
+Vulkan::PooledDescriptorSet::PooledDescriptorSet(	DescriptorAllocator& allocator,
+													vk::DescriptorSetLayout layout,
+													vk::DescriptorSet descriptorSet ) noexcept
+	: m_allocator(&allocator)
+	, m_layout(layout)
+	, m_descriptorSet(descriptorSet)
+{
+}
+
+Vulkan::PooledDescriptorSet::PooledDescriptorSet(PooledDescriptorSet&& other) noexcept
+	: m_allocator(other.m_allocator)
+	, m_layout(other.m_layout)
+	, m_descriptorSet(other.m_descriptorSet)
+{
+	other.m_allocator = nullptr;
+	other.m_descriptorSet = vk::DescriptorSet();
+}
+
+Vulkan::PooledDescriptorSet::~PooledDescriptorSet() {
+	reset();
+}
+
+Vulkan::PooledDescriptorSet& Vulkan::PooledDescriptorSet::operator=(PooledDescriptorSet&& other) noexcept {
+	if(this != &other) {
+		reset();
+
+		m_allocator = other.m_allocator;
+		m_layout = other.m_layout;
+		m_descriptorSet = other.m_descriptorSet;
+
+		other.m_allocator = nullptr;
+		other.m_descriptorSet = vk::DescriptorSet();
+	}
+
+	return *this;
+}
+
+
+
+Vulkan::PooledDescriptorSet::operator bool() const noexcept {
+	return static_cast<bool>(m_descriptorSet);
+}
+
+vk::DescriptorSet Vulkan::PooledDescriptorSet::operator*() const noexcept {
+	return m_descriptorSet;
+}
+
+
+
+vk::DescriptorSet Vulkan::PooledDescriptorSet::get() const noexcept {
+	return m_descriptorSet;
+}
+
+vk::DescriptorSetLayout Vulkan::PooledDescriptorSet::getLayout() const noexcept {
+	return m_layout;
+}
+
+
+
+void Vulkan::PooledDescriptorSet::reset() noexcept {
+	if(m_allocator) {
+		assert(m_descriptorSet);
+		m_allocator->release(m_layout, m_descriptorSet);
+		m_allocator = nullptr;
+		m_descriptorSet = vk::DescriptorSet();
+	}
+}
+
+
+
+/*
+ * DescriptorAllocator
+ */
+
+DescriptorAllocator::DescriptorAllocator(	const vk::DispatchLoaderDynamic& disp,
+											vk::Device device )
+	: m_dispatcher(disp)
+	, m_device(device)
+	, m_mutex()
+	, m_entries()
+	, m_createdPoolCount(0)
+{
+}
+
+
+
+Vulkan::PooledDescriptorSet DescriptorAllocator::allocate(	vk::DescriptorSetLayout layout,
+															Utils::BufferView<const vk::DescriptorPoolSize> setSizes )
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto& entry = m_entries[static_cast<VkDescriptorSetLayout>(layout)];
+	if(entry.pools.empty()) {
+		//First time using this layout
+		entry.setSizes.assign(setSizes.cbegin(), setSizes.cend());
+		entry.remaining = 0;
+	}
+
+	//All the sets of a layout require the same descriptors
+	assert(std::equal(
+		setSizes.cbegin(), setSizes.cend(),
+		entry.setSizes.cbegin(), entry.setSizes.cend()
+	));
+
+	vk::DescriptorSet descriptorSet;
+	if(!entry.freeSets.empty()) {
+		//Recycle a released one
+		descriptorSet = entry.freeSets.back();
+		entry.freeSets.pop_back();
+	} else {
+		if(entry.remaining == 0) {
+			createPool(entry);
+		}
+		assert(entry.remaining > 0);
+
+		const vk::DescriptorSetAllocateInfo allocInfo(
+			*entry.pools.back(),									//Pool
+			1, &layout												//Layouts
+		);
+
+		//Sets are not freed individually, as they are recycled
+		const auto result = m_device.allocateDescriptorSets(&allocInfo, &descriptorSet, m_dispatcher.get());
+		vk::createResultValue(result, VULKAN_HPP_NAMESPACE_STRING"::Device::allocateDescriptorSets");
+		--entry.remaining;
+	}
+
+	return Vulkan::PooledDescriptorSet(*this, layout, descriptorSet);
+}
+
+void DescriptorAllocator::release(	vk::DescriptorSetLayout layout,
+									vk::DescriptorSet descriptorSet ) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const auto ite = m_entries.find(static_cast<VkDescriptorSetLayout>(layout));
+	assert(ite != m_entries.cend());
+	ite->second.freeSets.push_back(descriptorSet);
+}
+
+
+
+size_t DescriptorAllocator::getCreatedPoolCount() const noexcept {
+	return m_createdPoolCount.load(std::memory_order_relaxed);
+}
+
+
+
+void DescriptorAllocator::createPool(Entry& entry) {
+	//Double the capacity each time, so that the pool count grows logarithmically
+	const auto capacity = static_cast<uint32_t>(std::min(
+		static_cast<size_t>(INITIAL_POOL_CAPACITY) << entry.pools.size(),
+		static_cast<size_t>(MAX_POOL_CAPACITY)
+	));
+
+	std::vector<vk::DescriptorPoolSize> poolSizes;
+	poolSizes.reserve(entry.setSizes.size());
+	std::transform(
+		entry.setSizes.cbegin(), entry.setSizes.cend(),
+		std::back_inserter(poolSizes),
+		[capacity] (const vk::DescriptorPoolSize& size) -> vk::DescriptorPoolSize {
+			return vk::DescriptorPoolSize(
+				size.type,											//Descriptor type
+				size.descriptorCount * capacity						//Descriptor count
+			);
+		}
+	);
+
+	const vk::DescriptorPoolCreateInfo createInfo(
+		{},															//Flags
+		capacity,													//Descriptor set count
+		poolSizes.size(), poolSizes.data()							//Pool sizes
+	);
+
+	entry.pools.push_back(m_device.createDescriptorPoolUnique(createInfo, nullptr, m_dispatcher.get()));
+	entry.remaining = capacity;
+	m_createdPoolCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <zuazo/Graphics/Vulkan.h>
+#include <zuazo/Utils/BufferView.h>
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+namespace Zuazo::Graphics {
+
+/**
+ * Allocates descriptor sets out of pools shared by all the sets with the same
+ * layout. Pools grow geometrically when exhausted and they are never freed
+ * before the allocator, so that resources which come and go (such as frames) 
+ * do not create and destroy descriptor pools. Released sets are recycled as
+ * they are, so their content must be rewritten after allocating them.
+ */
+class DescriptorAllocator {
+public:
+	DescriptorAllocator(const vk::DispatchLoaderDynamic& disp,
+						vk::Device device );
+	DescriptorAllocator(const DescriptorAllocator& other) = delete;
+	~DescriptorAllocator() = default;
+
+	DescriptorAllocator&					operator=(const DescriptorAllocator& other) = delete;
+
+	Vulkan::PooledDescriptorSet				allocate(	vk::DescriptorSetLayout layout,
+														Utils::BufferView<const vk::DescriptorPoolSize> setSizes );
+	void									release(vk::DescriptorSetLayout layout,
+													vk::DescriptorSet descriptorSet ) noexcept;
+
+	size_t									getCreatedPoolCount() const noexcept;
+
+private:
+	struct Entry {
+		std::vector<vk::DescriptorPoolSize>		setSizes;
+		std::vector<vk::UniqueDescriptorPool>	pools;
+		uint32_t								remaining; //Sets which can still be allocated from the last pool
+		std::vector<vk::DescriptorSet>			freeSets;
+	};
+
+	using EntryMap = std::unordered_map<VkDescriptorSetLayout, Entry>;
+
+	static constexpr uint32_t				INITIAL_POOL_CAPACITY = 16;
+	static constexpr uint32_t				MAX_POOL_CAPACITY = 1024;
+
+	std::reference_wrapper<const vk::DispatchLoaderDynamic> m_dispatcher;
+	vk::Device								m_device;
+
+	std::mutex								m_mutex;
+	EntryMap								m_entries;
+	std::atomic<size_t>						m_createdPoolCount;
+
+	void									createPool(Entry& entry);
+
+};
+
+}
\ No newline at end of file
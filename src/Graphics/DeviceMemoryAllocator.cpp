@@ -0,0 +1,434 @@
+#include "DeviceMemoryAllocator.h"
+
+#include <zuazo/Utils/CPU.h>
+#include <zuazo/Utils/Functions.h>
+#include <zuazo/Exception.h>
+
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+
+namespace Zuazo::Graphics {
+
+/*
+ * Vulkan::Allocation
+ */
+
+Vulkan::Allocation::Allocation() noexcept
+	: m_allocator(nullptr)
+	, m_memory()
+	, m_offset(0)
+	, m_size(0)
+{
+}
+
+Vulkan::Allocation::Allocation(	DeviceMemoryAllocator& allocator,
+								vk::DeviceMemory memory,
+								size_t offset,
+								size_t size ) noexcept
+	: m_allocator(&allocator)
+	, m_memory(memory)
+	, m_offset(offset)
+	, m_size(size)
+{
+}
+
+Vulkan::Allocation::Allocation(Allocation&& other) noexcept
+	: m_allocator(other.m_allocator)
+	, m_memory(other.m_memory)
+	, m_offset(other.m_offset)
+	, m_size(other.m_size)
+{
+	other.m_allocator = nullptr;
+	other.m_memory = vk::DeviceMemory();
+}
+
+Vulkan::Allocation::~Allocation() {
+	reset();
+}
+
+Vulkan::Allocation& Vulkan::Allocation::operator=(Allocation&& other) noexcept {
+	if(this != &other) {
+		reset();
+
+		m_allocator = other.m_allocator;
+		m_memory = other.m_memory;
+		m_offset = other.m_offset;
+		m_size = other.m_size;
+
+		other.m_allocator = nullptr;
+		other.m_memory = vk::DeviceMemory();
+	}
+
+	return *this;
+}
+
+
+
+Vulkan::Allocation::operator bool() const noexcept {
+	return static_cast<bool>(m_memory);
+}
+
+
+
+vk::DeviceMemory Vulkan::Allocation::getDeviceMemory() const noexcept {
+	return m_memory;
+}
+
+size_t Vulkan::Allocation::getOffset() const noexcept {
+	return m_offset;
+}
+
+size_t Vulkan::Allocation::getSize() const noexcept {
+	return m_size;
+}
+
+vk::MappedMemoryRange Vulkan::Allocation::getRange() const noexcept {
+	return vk::MappedMemoryRange(m_memory, m_offset, m_size);
+}
+
+
+
+void Vulkan::Allocation::reset() noexcept {
+	if(m_allocator) {
+		assert(m_memory);
+		m_allocator->release(m_memory, m_offset, m_size);
+		m_allocator = nullptr;
+		m_memory = vk::DeviceMemory();
+	}
+}
+
+
+
+/*
+ * DeviceMemoryAllocator
+ */
+
+DeviceMemoryAllocator::DeviceMemoryAllocator(	const vk::DispatchLoaderDynamic& disp,
+												vk::Device device,
+												const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+												const vk::PhysicalDeviceLimits& limits )
+	: m_dispatcher(disp)
+	, m_device(device)
+	, m_memoryProperties(memoryProperties)
+	, m_nonCoherentAtomSize(limits.nonCoherentAtomSize)
+	, m_separateTilings(limits.bufferImageGranularity > 1)
+	, m_mutex()
+	, m_pools(memoryProperties.memoryTypeCount * (m_separateTilings ? 2 : 1))
+	, m_blocks()
+{
+}
+
+DeviceMemoryAllocator::~DeviceMemoryAllocator() {
+	//All the allocations should have been released by now
+	assert(std::all_of(
+		m_blocks.cbegin(), m_blocks.cend(),
+		[] (const BlockMap::value_type& block) -> bool {
+			return block.second->allocationCount == 0;
+		}
+	));
+}
+
+
+
+Vulkan::Allocation DeviceMemoryAllocator::allocate(	const vk::MemoryRequirements& requirements,
+													uint32_t memoryType,
+													vk::ImageTiling tiling )
+{
+	assert(memoryType < m_memoryProperties.memoryTypeCount);
+	size_t size = requirements.size;
+	size_t alignment = std::max(requirements.alignment, vk::DeviceSize(1));
+
+	if(isHostVisible(memoryType)) {
+		//Ensure that the allocation can be flushed without touching its neighbours
+		alignment = std::max(alignment, m_nonCoherentAtomSize);
+		size = Utils::alignUpper(size, m_nonCoherentAtomSize);
+	}
+
+	const auto poolIndex = getPoolIndex(memoryType, tiling);
+	const auto blockSize = getBlockSize(memoryType);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto& pool = m_pools[poolIndex];
+
+	//Big allocations get their own block
+	if(size > blockSize / 2) {
+		auto& block = createBlock(poolIndex, size, true);
+		block.freeRanges.clear();
+		block.usedBytes = size;
+		block.allocationCount = 1;
+		updatePoolOrder(block);
+		return Vulkan::Allocation(*this, *block.memory, 0, size);
+	}
+
+	//Try the fullest blocks first, so that the emptier ones get a chance to drain
+	size_t offset;
+	for(auto* block : pool) {
+		if(!block->dedicated && tryAllocate(*block, size, alignment, offset)) {
+			updatePoolOrder(*block);
+			return Vulkan::Allocation(*this, *block->memory, offset, size);
+		}
+	}
+
+	//Did not fit anywhere. Create a new block
+	auto& block = createBlock(poolIndex, blockSize, false);
+	const auto success = tryAllocate(block, size, alignment, offset);
+	assert(success); Utils::ignore(success);
+	updatePoolOrder(block);
+	return Vulkan::Allocation(*this, *block.memory, offset, size);
+}
+
+void DeviceMemoryAllocator::release(vk::DeviceMemory memory,
+									size_t offset,
+									size_t size ) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const auto ite = m_blocks.find(static_cast<VkDeviceMemory>(memory));
+	assert(ite != m_blocks.cend());
+	auto& block = *(ite->second);
+
+	assert(block.allocationCount > 0);
+	assert(block.usedBytes >= size);
+	--block.allocationCount;
+	block.usedBytes -= size;
+
+	if(block.dedicated) {
+		destroyBlock(block);
+	} else {
+		insertFreeRange(block, offset, size);
+		updatePoolOrder(block);
+
+		if(block.allocationCount == 0) {
+			//Keep a single empty block per pool
+			const auto& pool = m_pools[block.pool];
+			const auto emptyCount = std::count_if(
+				pool.cbegin(), pool.cend(),
+				[] (const Block* b) -> bool {
+					return !b->dedicated && b->allocationCount == 0;
+				}
+			);
+
+			if(emptyCount > 1) {
+				destroyBlock(block);
+			}
+		}
+	}
+}
+
+std::byte* DeviceMemoryAllocator::map(vk::DeviceMemory memory) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::byte* result = nullptr;
+
+	const auto ite = m_blocks.find(static_cast<VkDeviceMemory>(memory));
+	if(ite != m_blocks.cend()) {
+		auto& block = *(ite->second);
+
+		//Blocks are mapped as a whole, as a memory object can only be mapped once
+		if(!block.mapping) {
+			block.mapping = static_cast<std::byte*>(m_device.mapMemory(
+				*block.memory,
+				0, VK_WHOLE_SIZE,
+				{},
+				m_dispatcher.get()
+			));
+		}
+
+		result = block.mapping;
+	}
+
+	return result;
+}
+
+
+
+std::vector<Vulkan::MemoryStatistics> DeviceMemoryAllocator::getStatistics() const {
+	std::vector<Vulkan::MemoryStatistics> result(m_memoryProperties.memoryTypeCount, Vulkan::MemoryStatistics{});
+	std::vector<size_t> freeBytes(result.size(), 0);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for(const auto& entry : m_blocks) {
+		const auto& block = *(entry.second);
+		const auto memoryType = getMemoryType(block.pool);
+		auto& statistics = result[memoryType];
+
+		++statistics.blockCount;
+		statistics.allocationCount += block.allocationCount;
+		statistics.blockBytes += block.size;
+		statistics.usedBytes += block.usedBytes;
+
+		for(const auto& range : block.freeRanges) {
+			statistics.largestFreeRange = std::max(statistics.largestFreeRange, range.second);
+			freeBytes[memoryType] += range.second;
+		}
+	}
+
+	for(size_t i = 0; i < result.size(); ++i) {
+		if(freeBytes[i] > 0) {
+			result[i].fragmentation = 1.0f - static_cast<float>(result[i].largestFreeRange) / freeBytes[i];
+		}
+	}
+
+	return result;
+}
+
+size_t DeviceMemoryAllocator::trim() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t result = 0;
+
+	std::vector<Block*> emptyBlocks;
+	for(const auto& entry : m_blocks) {
+		if(entry.second->allocationCount == 0) {
+			emptyBlocks.push_back(entry.second.get());
+		}
+	}
+
+	for(auto* block : emptyBlocks) {
+		result += block->size;
+		destroyBlock(*block);
+	}
+
+	return result;
+}
+
+
+
+size_t DeviceMemoryAllocator::getPoolIndex(uint32_t memoryType, vk::ImageTiling tiling) const noexcept {
+	return m_separateTilings ?
+		memoryType * 2 + (tiling == vk::ImageTiling::eOptimal ? 1 : 0) :
+		memoryType ;
+}
+
+uint32_t DeviceMemoryAllocator::getMemoryType(size_t poolIndex) const noexcept {
+	return static_cast<uint32_t>(m_separateTilings ? poolIndex / 2 : poolIndex);
+}
+
+size_t DeviceMemoryAllocator::getBlockSize(uint32_t memoryType) const noexcept {
+	//Do not let a single block take a significant part of small heaps
+	const auto heapIndex = m_memoryProperties.memoryTypes[memoryType].heapIndex;
+	const size_t heapSize = m_memoryProperties.memoryHeaps[heapIndex].size;
+	return std::min(DEFAULT_BLOCK_SIZE, heapSize / HEAP_BLOCK_FRACTION);
+}
+
+bool DeviceMemoryAllocator::isHostVisible(uint32_t memoryType) const noexcept {
+	const auto flags = m_memoryProperties.memoryTypes[memoryType].propertyFlags;
+	return static_cast<bool>(flags & vk::MemoryPropertyFlagBits::eHostVisible);
+}
+
+
+
+DeviceMemoryAllocator::Block& DeviceMemoryAllocator::createBlock(size_t poolIndex, size_t size, bool dedicated) {
+	const vk::MemoryAllocateInfo allocInfo(
+		size,									//Size
+		getMemoryType(poolIndex)				//Memory type index
+	);
+
+	auto block = std::make_unique<Block>();
+	block->memory = m_device.allocateMemoryUnique(allocInfo, nullptr, m_dispatcher.get());
+	block->size = size;
+	block->pool = poolIndex;
+	block->dedicated = dedicated;
+	block->mapping = nullptr;
+	block->usedBytes = 0;
+	block->allocationCount = 0;
+	block->freeRanges.emplace(0, size);
+
+	auto& result = *block;
+	m_pools[poolIndex].push_back(block.get());
+	m_blocks.emplace(static_cast<VkDeviceMemory>(*block->memory), std::move(block));
+	return result;
+}
+
+void DeviceMemoryAllocator::destroyBlock(Block& block) noexcept {
+	assert(block.allocationCount == 0);
+
+	auto& pool = m_pools[block.pool];
+	pool.erase(std::find(pool.cbegin(), pool.cend(), &block));
+
+	//Freeing the memory also unmaps it
+	m_blocks.erase(static_cast<VkDeviceMemory>(*block.memory));
+}
+
+void DeviceMemoryAllocator::updatePoolOrder(Block& block) noexcept {
+	//Only this block's usage has changed, so move it to its place instead
+	//of sorting the whole pool
+	const auto isFuller = [] (const Block* a, const Block* b) -> bool {
+		return a->usedBytes > b->usedBytes;
+	};
+
+	auto& pool = m_pools[block.pool];
+	auto ite = std::find(pool.begin(), pool.end(), &block);
+	assert(ite != pool.end());
+
+	while(ite != pool.begin() && isFuller(*ite, *std::prev(ite))) {
+		std::iter_swap(ite, std::prev(ite));
+		--ite;
+	}
+
+	while(std::next(ite) != pool.end() && isFuller(*std::next(ite), *ite)) {
+		std::iter_swap(ite, std::next(ite));
+		++ite;
+	}
+}
+
+
+
+bool DeviceMemoryAllocator::tryAllocate(Block& block,
+										size_t size,
+										size_t alignment,
+										size_t& offset ) noexcept
+{
+	//First fit in address order. This keeps allocations packed towards the
+	//beginning of the block
+	for(auto ite = block.freeRanges.begin(); ite != block.freeRanges.end(); ++ite) {
+		const auto rangeBegin = ite->first;
+		const auto rangeEnd = rangeBegin + ite->second;
+		const auto alignedBegin = Utils::alignUpper(rangeBegin, alignment);
+
+		if(alignedBegin + size <= rangeEnd) {
+			//Fits. Split the range
+			block.freeRanges.erase(ite);
+
+			if(alignedBegin > rangeBegin) {
+				block.freeRanges.emplace(rangeBegin, alignedBegin - rangeBegin);
+			}
+
+			if(alignedBegin + size < rangeEnd) {
+				block.freeRanges.emplace(alignedBegin + size, rangeEnd - (alignedBegin + size));
+			}
+
+			block.usedBytes += size;
+			++block.allocationCount;
+			offset = alignedBegin;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void DeviceMemoryAllocator::insertFreeRange(Block& block,
+											size_t offset,
+											size_t size ) noexcept
+{
+	auto [ite, inserted] = block.freeRanges.emplace(offset, size);
+	assert(inserted); Utils::ignore(inserted);
+
+	//Coalesce with the next range
+	const auto next = std::next(ite);
+	if(next != block.freeRanges.end() && ite->first + ite->second == next->first) {
+		ite->second += next->second;
+		block.freeRanges.erase(next);
+	}
+
+	//Coalesce with the previous range
+	if(ite != block.freeRanges.begin()) {
+		const auto prev = std::prev(ite);
+		if(prev->first + prev->second == ite->first) {
+			prev->second += ite->second;
+			block.freeRanges.erase(ite);
+		}
+	}
+}
+
+}
\ No newline at end of file
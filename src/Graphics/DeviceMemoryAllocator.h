@@ -0,0 +1,95 @@
+#pragma once
+
+#include <zuazo/Graphics/Vulkan.h>
+
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+
+namespace Zuazo::Graphics {
+
+/**
+ * Sub-allocates device memory out of large blocks, so that the number of
+ * vkAllocateMemory calls stays low. Each memory type has its own blocks, which
+ * are further split between linear and optimal resources when the device's
+ * bufferImageGranularity requires it. Free ranges are kept in address order
+ * and coalesced on release. Large requests get a dedicated block.
+ *
+ * Resources can not be relocated, so fragmentation is fought when allocating:
+ * the fullest blocks are tried first, letting the emptier ones drain. Empty
+ * blocks are kept (one per pool) to absorb pool growth and can be released
+ * with trim().
+ */
+class DeviceMemoryAllocator {
+public:
+	DeviceMemoryAllocator(	const vk::DispatchLoaderDynamic& disp,
+							vk::Device device,
+							const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+							const vk::PhysicalDeviceLimits& limits );
+	DeviceMemoryAllocator(const DeviceMemoryAllocator& other) = delete;
+	~DeviceMemoryAllocator();
+
+	DeviceMemoryAllocator&					operator=(const DeviceMemoryAllocator& other) = delete;
+
+	Vulkan::Allocation						allocate(	const vk::MemoryRequirements& requirements,
+														uint32_t memoryType,
+														vk::ImageTiling tiling );
+	void									release(vk::DeviceMemory memory,
+													size_t offset,
+													size_t size ) noexcept;
+	std::byte*								map(vk::DeviceMemory memory);
+
+	std::vector<Vulkan::MemoryStatistics>	getStatistics() const;
+	size_t									trim();
+
+private:
+	struct Block {
+		vk::UniqueDeviceMemory					memory;
+		size_t									size;
+		size_t									pool;
+		bool									dedicated;
+		std::byte*								mapping;
+		size_t									usedBytes;
+		size_t									allocationCount;
+		std::map<size_t, size_t>				freeRanges; //Offset -> size
+	};
+
+	using Pool = std::vector<Block*>; //Sorted from the fullest to the emptiest block
+	using BlockMap = std::unordered_map<VkDeviceMemory, std::unique_ptr<Block>>;
+
+	static constexpr size_t					DEFAULT_BLOCK_SIZE = 64 << 20; //64MiB
+	static constexpr size_t					HEAP_BLOCK_FRACTION = 8;
+
+	std::reference_wrapper<const vk::DispatchLoaderDynamic> m_dispatcher;
+	vk::Device								m_device;
+	vk::PhysicalDeviceMemoryProperties		m_memoryProperties;
+	size_t									m_nonCoherentAtomSize;
+	bool									m_separateTilings;
+
+	mutable std::mutex						m_mutex;
+	std::vector<Pool>						m_pools;
+	BlockMap								m_blocks;
+
+	size_t									getPoolIndex(uint32_t memoryType, vk::ImageTiling tiling) const noexcept;
+	uint32_t								getMemoryType(size_t poolIndex) const noexcept;
+	size_t									getBlockSize(uint32_t memoryType) const noexcept;
+	bool									isHostVisible(uint32_t memoryType) const noexcept;
+
+	Block&									createBlock(size_t poolIndex, size_t size, bool dedicated);
+	void									destroyBlock(Block& block) noexcept;
+	void									updatePoolOrder(Block& block) noexcept;
+
+	static bool								tryAllocate(Block& block,
+														size_t size,
+														size_t alignment,
+														size_t& offset ) noexcept;
+	static void								insertFreeRange(Block& block,
+															size_t offset,
+															size_t size ) noexcept;
+
+};
+
+}
\ No newline at end of file
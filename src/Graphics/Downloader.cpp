@@ -1,72 +1,447 @@
 #include <zuazo/Graphics/Downloader.h>
-/* //TODO
+
 #include <zuazo/Graphics/ColorTransfer.h>
-#include <zuazo/Graphics/Buffer.h>
 #include <zuazo/Graphics/RenderPass.h>
 #include <zuazo/Graphics/VulkanConversions.h>
-#include <zuazo/Utils/Pool.h>
-#include <zuazo/Utils/StaticId.h>
+#include <zuazo/Graphics/Buffer.h>
+#include <zuazo/Exception.h>
+#include <zuazo/Utils/CPU.h>
 
 #include <utility>
 #include <memory>
 #include <cassert>
 #include <algorithm>
+#include <array>
+#include <vector>
 
 namespace Zuazo::Graphics {
-*/
+
 /*
- * Downloader::Impl
+ * Format support
  */
+
+static const std::vector<vk::Format>& getVulkanFormatSupport(const Vulkan& vulkan) {
+	constexpr vk::FormatFeatureFlags DESIRED_FLAGS =
+		vk::FormatFeatureFlagBits::eColorAttachment |
+		vk::FormatFeatureFlagBits::eColorAttachmentBlend |
+		vk::FormatFeatureFlagBits::eTransferSrc ;
+
+	return vulkan.listSupportedFormatsOptimal(DESIRED_FLAGS);
+}
+
+static size_t getTexelSize(vk::Format format) noexcept {
+	//Only uncompressed single plane color formats, as they are the ones which can be rendered
+	switch(format) {
+	case vk::Format::eR4G4UnormPack8:
+	case vk::Format::eR8Unorm:
+	case vk::Format::eR8Snorm:
+	case vk::Format::eR8Uscaled:
+	case vk::Format::eR8Sscaled:
+	case vk::Format::eR8Uint:
+	case vk::Format::eR8Sint:
+	case vk::Format::eR8Srgb:
+		return 1;
+
+	case vk::Format::eR4G4B4A4UnormPack16:
+	case vk::Format::eB4G4R4A4UnormPack16:
+	case vk::Format::eR5G6B5UnormPack16:
+	case vk::Format::eB5G6R5UnormPack16:
+	case vk::Format::eR5G5B5A1UnormPack16:
+	case vk::Format::eB5G5R5A1UnormPack16:
+	case vk::Format::eA1R5G5B5UnormPack16:
+	case vk::Format::eR10X6UnormPack16:
+	case vk::Format::eR12X4UnormPack16:
+	case vk::Format::eR8G8Unorm:
+	case vk::Format::eR8G8Snorm:
+	case vk::Format::eR8G8Uscaled:
+	case vk::Format::eR8G8Sscaled:
+	case vk::Format::eR8G8Uint:
+	case vk::Format::eR8G8Sint:
+	case vk::Format::eR8G8Srgb:
+	case vk::Format::eR16Unorm:
+	case vk::Format::eR16Snorm:
+	case vk::Format::eR16Uscaled:
+	case vk::Format::eR16Sscaled:
+	case vk::Format::eR16Uint:
+	case vk::Format::eR16Sint:
+	case vk::Format::eR16Sfloat:
+		return 2;
+
+	case vk::Format::eR8G8B8Unorm:
+	case vk::Format::eR8G8B8Snorm:
+	case vk::Format::eR8G8B8Uscaled:
+	case vk::Format::eR8G8B8Sscaled:
+	case vk::Format::eR8G8B8Uint:
+	case vk::Format::eR8G8B8Sint:
+	case vk::Format::eR8G8B8Srgb:
+	case vk::Format::eB8G8R8Unorm:
+	case vk::Format::eB8G8R8Snorm:
+	case vk::Format::eB8G8R8Uscaled:
+	case vk::Format::eB8G8R8Sscaled:
+	case vk::Format::eB8G8R8Uint:
+	case vk::Format::eB8G8R8Sint:
+	case vk::Format::eB8G8R8Srgb:
+		return 3;
+
+	case vk::Format::eR8G8B8A8Unorm:
+	case vk::Format::eR8G8B8A8Snorm:
+	case vk::Format::eR8G8B8A8Uscaled:
+	case vk::Format::eR8G8B8A8Sscaled:
+	case vk::Format::eR8G8B8A8Uint:
+	case vk::Format::eR8G8B8A8Sint:
+	case vk::Format::eR8G8B8A8Srgb:
+	case vk::Format::eB8G8R8A8Unorm:
+	case vk::Format::eB8G8R8A8Snorm:
+	case vk::Format::eB8G8R8A8Uscaled:
+	case vk::Format::eB8G8R8A8Sscaled:
+	case vk::Format::eB8G8R8A8Uint:
+	case vk::Format::eB8G8R8A8Sint:
+	case vk::Format::eB8G8R8A8Srgb:
+	case vk::Format::eA8B8G8R8UnormPack32:
+	case vk::Format::eA8B8G8R8SnormPack32:
+	case vk::Format::eA8B8G8R8UscaledPack32:
+	case vk::Format::eA8B8G8R8SscaledPack32:
+	case vk::Format::eA8B8G8R8UintPack32:
+	case vk::Format::eA8B8G8R8SintPack32:
+	case vk::Format::eA8B8G8R8SrgbPack32:
+	case vk::Format::eA2R10G10B10UnormPack32:
+	case vk::Format::eA2R10G10B10SnormPack32:
+	case vk::Format::eA2R10G10B10UscaledPack32:
+	case vk::Format::eA2R10G10B10SscaledPack32:
+	case vk::Format::eA2R10G10B10UintPack32:
+	case vk::Format::eA2R10G10B10SintPack32:
+	case vk::Format::eA2B10G10R10UnormPack32:
+	case vk::Format::eA2B10G10R10SnormPack32:
+	case vk::Format::eA2B10G10R10UscaledPack32:
+	case vk::Format::eA2B10G10R10SscaledPack32:
+	case vk::Format::eA2B10G10R10UintPack32:
+	case vk::Format::eA2B10G10R10SintPack32:
+	case vk::Format::eR16G16Unorm:
+	case vk::Format::eR16G16Snorm:
+	case vk::Format::eR16G16Uscaled:
+	case vk::Format::eR16G16Sscaled:
+	case vk::Format::eR16G16Uint:
+	case vk::Format::eR16G16Sint:
+	case vk::Format::eR16G16Sfloat:
+	case vk::Format::eR32Uint:
+	case vk::Format::eR32Sint:
+	case vk::Format::eR32Sfloat:
+	case vk::Format::eB10G11R11UfloatPack32:
+	case vk::Format::eE5B9G9R9UfloatPack32:
+	case vk::Format::eR10X6G10X6Unorm2Pack16:
+	case vk::Format::eR12X4G12X4Unorm2Pack16:
+		return 4;
+
+	case vk::Format::eR16G16B16Unorm:
+	case vk::Format::eR16G16B16Snorm:
+	case vk::Format::eR16G16B16Uscaled:
+	case vk::Format::eR16G16B16Sscaled:
+	case vk::Format::eR16G16B16Uint:
+	case vk::Format::eR16G16B16Sint:
+	case vk::Format::eR16G16B16Sfloat:
+		return 6;
+
+	case vk::Format::eR16G16B16A16Unorm:
+	case vk::Format::eR16G16B16A16Snorm:
+	case vk::Format::eR16G16B16A16Uscaled:
+	case vk::Format::eR16G16B16A16Sscaled:
+	case vk::Format::eR16G16B16A16Uint:
+	case vk::Format::eR16G16B16A16Sint:
+	case vk::Format::eR16G16B16A16Sfloat:
+	case vk::Format::eR32G32Uint:
+	case vk::Format::eR32G32Sint:
+	case vk::Format::eR32G32Sfloat:
+	case vk::Format::eR64Uint:
+	case vk::Format::eR64Sint:
+	case vk::Format::eR64Sfloat:
+	case vk::Format::eR10X6G10X6B10X6A10X6Unorm4Pack16:
+	case vk::Format::eR12X4G12X4B12X4A12X4Unorm4Pack16:
+		return 8;
+
+	case vk::Format::eR32G32B32Uint:
+	case vk::Format::eR32G32B32Sint:
+	case vk::Format::eR32G32B32Sfloat:
+		return 12;
+
+	case vk::Format::eR32G32B32A32Uint:
+	case vk::Format::eR32G32B32A32Sint:
+	case vk::Format::eR32G32B32A32Sfloat:
+	case vk::Format::eR64G64Uint:
+	case vk::Format::eR64G64Sint:
+	case vk::Format::eR64G64Sfloat:
+		return 16;
+
+	case vk::Format::eR64G64B64Uint:
+	case vk::Format::eR64G64B64Sint:
+	case vk::Format::eR64G64B64Sfloat:
+		return 24;
+
+	case vk::Format::eR64G64B64A64Uint:
+	case vk::Format::eR64G64B64A64Sint:
+	case vk::Format::eR64G64B64A64Sfloat:
+		return 32;
+
+	default:
+		return 0;
+	}
+}
+
+static bool isSupported(const Vulkan& vulkan, vk::Format format) {
+	const auto& formatSupport = getVulkanFormatSupport(vulkan);
+	assert(std::is_sorted(formatSupport.cbegin(), formatSupport.cend())); //For binary search
+
+	//The texel size is needed in order to lay out the readback buffer
+	return	std::binary_search(formatSupport.cbegin(), formatSupport.cend(), format) &&
+			getTexelSize(format) > 0 ;
+}
+
+
+
+
+
 /*
+ * Downloader::Impl
+ */
+
 struct Downloader::Impl {
-	const Vulkan&									vulkan;
+	/*
+	 * Each slot of the ring has its own target and readback buffer, so that
+	 * a frame can be rendered while the previous ones are being read. Planes
+	 * are copied tightly packed into the buffer, which avoids the linear 
+	 * images' row pitch and their limited format support
+	 */
+	struct Slot {
+		Slot(	const Vulkan& vulkan,
+				Utils::BufferView<const Image::Plane> planes,
+				Utils::BufferView<const Utils::Area> readbackAreas,
+				const RenderPass& renderPass,
+				vk::CommandPool commandPool )
+			: targetImage(createTargetImage(vulkan, planes))
+			, framebuffer(renderPass.createFramebuffer(vulkan, targetImage))
+			, readbackBuffer(createReadbackBuffer(vulkan, readbackAreas))
+			, pixelData(getPixelData(vulkan, readbackBuffer, readbackAreas))
+			, readbackCommandBuffer(vulkan.allocateCommnadBuffer(commandPool, vk::CommandBufferLevel::ePrimary))
+			, commandBuffer()
+			, id(0)
+			, batch(0)
+		{
+			recordCommandBuffer(vulkan, readbackAreas);
+		}
+
+		Image											targetImage;
+		vk::UniqueFramebuffer							framebuffer;
+		Buffer											readbackBuffer;
+		std::vector<Utils::BufferView<const std::byte>>	pixelData;
+
+		vk::UniqueCommandBuffer							readbackCommandBuffer;
+		std::shared_ptr<const CommandBuffer>			commandBuffer;
+		uint64_t										id;
+		uint64_t										batch;
+
+	private:
+		void recordCommandBuffer(	const Vulkan& vulkan,
+									Utils::BufferView<const Utils::Area> readbackAreas )
+		{
+			const auto planes = targetImage.getPlanes();
+			const auto cmd = *readbackCommandBuffer;
+			assert(planes.size() == readbackAreas.size());
+
+			constexpr vk::ImageSubresourceRange imageSubresourceRange(
+				vk::ImageAspectFlagBits::eColor,				//Aspect mask
+				0, 1, 0, 1										//Base mipmap level, mipmap levels, base array layer, layers
+			);
+
+			//Record the command buffer. The render pass leaves the target
+			//in the transfer source layout
+			const vk::CommandBufferBeginInfo beginInfo(
+				{},
+				nullptr
+			);
+
+			vulkan.begin(cmd, beginInfo);
+
+			//Wait for the rendering to finish
+			{
+				std::vector<vk::ImageMemoryBarrier> memoryBarriers;
+				memoryBarriers.reserve(planes.size());
+				for(const auto& plane : planes){
+					constexpr vk::AccessFlags srcAccess = vk::AccessFlagBits::eColorAttachmentWrite;
+					constexpr vk::AccessFlags dstAccess = vk::AccessFlagBits::eTransferRead;
+
+					//Do not change the layout
+					constexpr vk::ImageLayout srcLayout = vk::ImageLayout::eTransferSrcOptimal;
+					constexpr vk::ImageLayout dstLayout = vk::ImageLayout::eTransferSrcOptimal;
+
+					//Rendered and read on the same queue
+					constexpr auto srcFamily = VK_QUEUE_FAMILY_IGNORED;
+					constexpr auto dstFamily = VK_QUEUE_FAMILY_IGNORED;
+
+					memoryBarriers.emplace_back(
+						srcAccess,								//Old access mask
+						dstAccess,								//New access mask
+						srcLayout,								//Old layout
+						dstLayout,								//New layout
+						srcFamily,								//Old queue family
+						dstFamily,								//New queue family
+						plane.getImage(),						//Image
+						imageSubresourceRange					//Image subresource
+					);
+				}
+
+				constexpr vk::PipelineStageFlags srcStages =
+					vk::PipelineStageFlagBits::eColorAttachmentOutput;
+
+				constexpr vk::PipelineStageFlags dstStages =
+					vk::PipelineStageFlagBits::eTransfer;
+
+				vulkan.pipelineBarrier(
+					cmd,										//Command buffer
+					srcStages,									//Generating stages
+					dstStages,									//Consuming stages
+					{},											//Dependency flags
+					Utils::BufferView<const vk::ImageMemoryBarrier>(memoryBarriers) //Memory barriers
+				);
+			}
+
+			//Copy each plane into its area of the buffer. 0 row length 
+			//and image height mean tightly packed
+			for(size_t i = 0; i < planes.size(); ++i) {
+				const vk::BufferImageCopy region(
+					readbackAreas[i].offset(),					//Buffer offset
+					0, 0,										//Buffer row length, image height
+					vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1), //Image subresource
+					vk::Offset3D(),								//Image offset
+					planes[i].getExtent()						//Image extent
+				);
+
+				vulkan.copy(
+					cmd,										//Command buffer
+					planes[i].getImage(),						//Src image
+					vk::ImageLayout::eTransferSrcOptimal,		//Src image layout
+					readbackBuffer.getBuffer(),					//Dst buffer
+					region										//Regions
+				);
+			}
+
+			//Make the result visible to the host
+			{
+				const vk::BufferMemoryBarrier memoryBarrier(
+					vk::AccessFlagBits::eTransferWrite,			//Old access mask
+					vk::AccessFlagBits::eHostRead,				//New access mask
+					VK_QUEUE_FAMILY_IGNORED,					//Old queue family
+					VK_QUEUE_FAMILY_IGNORED,					//New queue family
+					readbackBuffer.getBuffer(),					//Buffer
+					0, VK_WHOLE_SIZE							//Range
+				);
+
+				constexpr vk::PipelineStageFlags srcStages =
+					vk::PipelineStageFlagBits::eTransfer;
+
+				constexpr vk::PipelineStageFlags dstStages =
+					vk::PipelineStageFlagBits::eHost;
+
+				vulkan.pipelineBarrier(
+					cmd,										//Command buffer
+					srcStages,									//Generating stages
+					dstStages,									//Consuming stages
+					{},											//Dependency flags
+					Utils::BufferView<const vk::BufferMemoryBarrier>(memoryBarrier) //Memory barriers
+				);
+			}
+
+			vulkan.end(cmd);
+		}
+
+		static Image createTargetImage(	const Vulkan& vulkan,
+										Utils::BufferView<const Image::Plane> planes )
+		{
+			constexpr vk::ImageUsageFlags usage =
+				vk::ImageUsageFlagBits::eColorAttachment |
+				vk::ImageUsageFlagBits::eTransferSrc;
+
+			constexpr vk::ImageTiling tiling =
+				vk::ImageTiling::eOptimal;
+
+			constexpr vk::MemoryPropertyFlags memory =
+				vk::MemoryPropertyFlagBits::eDeviceLocal;
+
+			return Image(
+				vulkan,
+				planes,
+				usage,
+				tiling,
+				memory
+			);
+		}
+
+		static Buffer createReadbackBuffer(	const Vulkan& vulkan,
+											Utils::BufferView<const Utils::Area> readbackAreas )
+		{
+			assert(!readbackAreas.empty());
+
+			constexpr vk::BufferUsageFlags usage =
+				vk::BufferUsageFlagBits::eTransferDst;
+
+			//Coherent, so that it does not need to be invalidated before reading
+			constexpr vk::MemoryPropertyFlags memory =
+				vk::MemoryPropertyFlagBits::eHostVisible |
+				vk::MemoryPropertyFlagBits::eHostCoherent ;
+
+			return Buffer(
+				vulkan,
+				usage,
+				memory,
+				readbackAreas.back().end()
+			);
+		}
+
+		static std::vector<Utils::BufferView<const std::byte>> getPixelData(const Vulkan& vulkan,
+																			const Buffer& readbackBuffer,
+																			Utils::BufferView<const Utils::Area> readbackAreas )
+		{
+			const auto range = readbackBuffer.getMemory().getRange();
+
+			const auto* data = vulkan.mapMemory(range);
+			return Utils::slice(data, readbackAreas);
+		}
+
+	};
+
+	std::reference_wrapper<const Vulkan>			vulkan;
 	std::shared_ptr<Frame::Descriptor>				frameDescriptor;
+	DepthStencilFormat								depthStencilFormat;
 	ColorTransferWrite								colorTransfer;
-	std::vector<Image::Plane>						planeDescriptors;
-	vk::Format										intermediaryFormat;
-
-	std::unique_ptr<DepthStencil>					depthStencil;
+	std::vector<Image::Plane>						planes;
 	RenderPass										renderPass;
-	std::unique_ptr<Image>							intermediaryTargetImage;
-	Image											targetImage;
-	Framebuffer										framebuffer;
-	Image											stagingImage;
-	std::vector<Utils::BufferView<const std::byte>>	stagingImageData;
+	std::vector<Utils::Area>						readbackAreas;
 
 	vk::UniqueCommandPool							commandPool;
-	vk::CommandBuffer								downloadCommand;
-	vk::UniqueSemaphore								renderComplete;
-	vk::UniqueFence									downloadComplete;
-
-	std::shared_ptr<const CommandBuffer>			lastCommandBuffer;
+	std::vector<Slot>								slots;
+	uint64_t										drawCount;
 
 
-	Impl(	const Vulkan& vulkan, 
+	Impl(	const Vulkan& vulkan,
 			const Frame::Descriptor& frameDesc,
-			DepthStencilFormat depthStencilFmt )
+			DepthStencilFormat depthStencilFmt,
+			size_t ringSize )
 		: vulkan(vulkan)
 		, frameDescriptor(Utils::makeShared<Frame::Descriptor>(frameDesc))
-		, colorTransfer(*frameDescriptor)
-		, planeDescriptors(createPlaneDescriptors(vulkan, frameDesc, colorTransfer))
-		, intermediaryFormat(RenderPass::getIntermediateFormat(vulkan, planeDescriptors, colorTransfer))
-		, depthStencil(createDepthStencil(vulkan, toVulkan(depthStencilFmt), planeDescriptors.front().getExtent()))
-		, renderPass(getRenderPass(vulkan, planeDescriptors, depthStencilFmt))
-		, intermediaryTargetImage(createIntermediaryTargetImage(vulkan, intermediaryFormat, planeDescriptors.front().getExtent()))
-		, targetImage(createTargetImage(vulkan, planeDescriptors))
-		, framebuffer(createFramebuffer(vulkan, targetImage, intermediaryTargetImage.get(), depthStencil.get(), renderPass))
-		, stagingImage(createStagingImage(vulkan, planeDescriptors))
-		, stagingImageData(getPixelData(vulkan, stagingImage))
+		, depthStencilFormat(depthStencilFmt)
+		, colorTransfer(frameDesc)
+		, planes(createPlanes(vulkan, frameDesc, colorTransfer))
+		, renderPass(createRenderPass(vulkan, colorTransfer, planes, depthStencilFmt))
+		, readbackAreas(createReadbackAreas(planes))
 		, commandPool(createCommandPool(vulkan))
-		, downloadCommand(createCommandBuffer(vulkan, *commandPool))
-		, renderComplete(vulkan.createSemaphore())
-		, downloadComplete(vulkan.createFence(true))
-		, lastCommandBuffer()
+		, slots(createSlots(vulkan, planes, readbackAreas, renderPass, *commandPool, ringSize))
+		, drawCount(0)
 	{
-		recordCommandBuffer();
 	}
 
 	~Impl() {
-		waitCompletion(Vulkan::NO_TIMEOUT);
+		//Wait for all the pending downloads
+		if(drawCount > 0) {
+			waitCompletion(drawCount - 1, Vulkan::NO_TIMEOUT);
+		}
 	}
 
 
@@ -79,22 +454,34 @@ struct Downloader::Impl {
 		return *frameDescriptor;
 	}
 
+	DepthStencilFormat getDepthStencilFormat() const noexcept {
+		return depthStencilFormat;
+	}
+
 	const ColorTransferWrite& getColorTransfer() const noexcept {
 		return colorTransfer;
 	}
 
-	const Framebuffer& getFramebuffer() const noexcept {
-		return framebuffer;
+	const RenderPass& getRenderPass() const noexcept {
+		return renderPass;
 	}
 
-	void beginRenderPass(	vk::CommandBuffer cmd, 
+	size_t getRingSize() const noexcept {
+		return slots.size();
+	}
+
+
+	void beginRenderPass(	vk::CommandBuffer cmd,
 							vk::Rect2D renderArea,
 							Utils::BufferView<const vk::ClearValue> clearValues,
 							vk::SubpassContents contents ) const noexcept
 	{
+		//Render into the slot used by the next draw
+		const auto& slot = getSlot(drawCount);
+
 		const vk::RenderPassBeginInfo beginInfo(
 			renderPass.get(),
-			framebuffer.get(),
+			*slot.framebuffer,
 			renderArea,
 			clearValues.size(), clearValues.data()
 		);
@@ -103,69 +490,60 @@ struct Downloader::Impl {
 	}
 
 	void endRenderPass(vk::CommandBuffer cmd) const noexcept {
-		vulkan.endRenderPass(cmd);
+		getVulkan().endRenderPass(cmd);
 	}
 
-	void draw(std::shared_ptr<const CommandBuffer> cmd) {
-		//No previous download should be in progress
-		waitCompletion(Vulkan::NO_TIMEOUT);
+	uint64_t draw(std::shared_ptr<const CommandBuffer> cmd) {
+		assert(cmd);
+		const auto& vulkan = getVulkan();
+		const auto id = drawCount;
+		auto& slot = getSlot(id);
 
-		lastCommandBuffer = std::move(cmd);
-		assert(lastCommandBuffer);
-
-		//Submit drawing commands to the graphics queue
-		const std::array renderCommandbuffers = {
-			lastCommandBuffer->get()
-		};
-
-		const std::array intermediateSemaphores = {
-			*renderComplete
-		};
-
-		const vk::SubmitInfo renderSubmitInfo(
-			0,								nullptr,	nullptr,			//Wait semaphores
-			renderCommandbuffers.size(), 	renderCommandbuffers.data(),	//Command buffers
-			intermediateSemaphores.size(), 	intermediateSemaphores.data()	//Signal semaphores
-		);
-
-		vulkan.submit(vulkan.getGraphicsQueue(), renderSubmitInfo, vk::Fence());
+		//Ensure that the slot is not being used. Only blocks
+		//when the whole ring is pending
+		if(id >= slots.size()) {
+			waitCompletion(slot.id, Vulkan::NO_TIMEOUT);
+		}
 
-		//Submit download commands to the transfer queue
-		constexpr std::array downloadWaitStages = {
-			vk::PipelineStageFlags(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-		};    
-		static_assert(intermediateSemaphores.size() == downloadWaitStages.size(), "Wait semaphore sizes do not match");
+		slot.commandBuffer = std::move(cmd);
+		slot.id = id;
 
-		const std::array downloadCommandbuffers = {
-			downloadCommand
+		//Render and read back in the same submission. It is batched
+		//with the rest of the work of this tick
+		const std::array commandBuffers = {
+			slot.commandBuffer->get(),
+			*slot.readbackCommandBuffer
 		};
+		slot.batch = vulkan.submitGraphicsBatched(commandBuffers);
 
-		const vk::SubmitInfo dowloadSubmitInfo(
-			intermediateSemaphores.size(),	intermediateSemaphores.data(),	downloadWaitStages.data(),	//Wait semaphores
-			downloadCommandbuffers.size(), 	downloadCommandbuffers.data(),								//Command buffers
-			0, 								nullptr														//Signal semaphores
-		);
+		++drawCount;
+		return id;
+	}
 
-		vulkan.resetFences(*downloadComplete);
-		vulkan.submit(vulkan.getTransferQueue(), renderSubmitInfo, *downloadComplete);
+	uint64_t getDrawCount() const noexcept {
+		return drawCount;
 	}
 
-	bool waitCompletion(uint64_t timeo) const {
-		return vulkan.waitForFences(*downloadComplete, true, timeo);
+	bool waitCompletion(uint64_t id, uint64_t timeo) const {
+		assert(id < drawCount);
+		const auto& vulkan = getVulkan();
+
+		//If the slot has been reused, the requested one has already completed.
+		//Otherwise this sends the batch if it is still pending
+		const auto& slot = getSlot(id);
+		return (slot.id != id) || vulkan.waitBatch(slot.batch, timeo);
 	}
 
-	Utils::BufferView<const Utils::BufferView<const std::byte>>	getPixelData() const noexcept {
-		return stagingImageData;
+	PixelData getPixelData(uint64_t id) const noexcept {
+		const auto& slot = getSlot(id);
+		assert(slot.id == id); //It has been overwritten
+		return slot.pixelData;
 	}
 
 
 	static Utils::Discrete<ColorFormat> getSupportedFormats(const Vulkan& vulkan) {
 		Utils::Discrete<ColorFormat> result;
 
-		//Query support for Vulkan formats
-		const auto& vulkanFormatSupport = getVulkanFormatSupport(vulkan);
-		assert(std::is_sorted(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend())); //For binary search
-
 		//Test for each format
 		for(auto i = Utils::EnumTraits<ColorFormat>::first(); i <= Utils::EnumTraits<ColorFormat>::last(); ++i) {
 			//Convert it into a Vulkan format
@@ -184,7 +562,7 @@ struct Downloader::Impl {
 				//Check if it is supported
 				const auto supported = std::all_of(
 					conversion.cbegin(), endIte,
-					[&vulkanFormatSupport] (const std::tuple<vk::Format, vk::ComponentMapping>& conv) -> bool {
+					[&vulkan] (const std::tuple<vk::Format, vk::ComponentMapping>& conv) -> bool {
 						//Try to optimize the format (remove any swizzle if possible)
 						const auto optimized = optimizeFormat(conv);
 
@@ -192,7 +570,7 @@ struct Downloader::Impl {
 						if(std::get<1>(optimized) != vk::ComponentMapping()) return false;
 
 						//Check if the format is supported indeed
-						return std::binary_search(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend(), std::get<0>(optimized));
+						return isSupported(vulkan, std::get<0>(optimized));
 					}
 				);
 
@@ -208,14 +586,10 @@ struct Downloader::Impl {
 	static Utils::Discrete<ColorFormat> getSupportedSrgbFormats(const Vulkan& vulkan) {
 		Utils::Discrete<ColorFormat> result;
 
-		//Query support for Vulkan formats
-		const auto& vulkanFormatSupport = getVulkanFormatSupport(vulkan);
-		assert(std::is_sorted(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend())); //For binary search
-
 		//Test for each format
 		for(auto i = Utils::EnumTraits<ColorFormat>::first(); i <= Utils::EnumTraits<ColorFormat>::last(); ++i) {
 			//Convert it into a Vulkan format
-			auto conversion = toVulkan(i);
+			const auto conversion = toVulkan(i);
 
 			//Find the end of the range
 			const auto endIte = std::find_if(
@@ -230,7 +604,7 @@ struct Downloader::Impl {
 				//Check if it is supported
 				const auto supported = std::all_of(
 					conversion.cbegin(), endIte,
-					[&vulkanFormatSupport] (const std::tuple<vk::Format, vk::ComponentMapping>& conv) -> bool {
+					[&vulkan] (const std::tuple<vk::Format, vk::ComponentMapping>& conv) -> bool {
 						//Try to convert it to sRGB
 						const auto sRGBfmt = toSrgb(std::get<0>(conv));
 						if(sRGBfmt == std::get<0>(conv)) return false; //No sRGB equivalent
@@ -242,7 +616,7 @@ struct Downloader::Impl {
 						if(std::get<1>(optimized) != vk::ComponentMapping()) return false;
 
 						//Check if the format is supported indeed
-						return std::binary_search(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend(), std::get<0>(optimized));
+						return isSupported(vulkan, std::get<0>(optimized));
 					}
 				);
 
@@ -255,357 +629,58 @@ struct Downloader::Impl {
 		return result;
 	}
 
-	static Utils::Discrete<DepthStencilFormat> getSupportedFormatsDepthStencil(const Vulkan& vulkan) {
-		Utils::Discrete<DepthStencilFormat> result;
-
-		//Query support for Vulkan formats
-		const auto& vulkanFormatSupport = getVulkanFormatSupportDepthStencil(vulkan);
-		assert(std::is_sorted(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend())); //For binary search
-
-		//Having no depth/stencil is supported:
-		result.emplace_back(DepthStencilFormat::NONE);
-
-		//Test for each format
-		for(auto i = Utils::EnumTraits<DepthStencilFormat>::first(); i <= Utils::EnumTraits<DepthStencilFormat>::last(); ++i) {
-			//Convert it into a Vulkan format
-			const auto conversion = toVulkan(i);
-
-			//Check if it is supported
-			const auto supported = std::binary_search(
-				vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend(),
-				conversion
-			);
-
-			if(supported) {
-				result.push_back(i);
-			}
-		}
-
-		return result;
-	}	
-
-	static RenderPass getRenderPass(const Vulkan& vulkan, 
-									const Frame::Descriptor& frameDesc,
-									DepthStencilFormat depthStencilFmt )
-	{
-		ColorTransferWrite colorTransfer(frameDesc);
-		const auto planeDescriptors = createPlaneDescriptors(vulkan, frameDesc, colorTransfer);
-		return RenderPass(vulkan, planeDescriptors, depthStencilFmt, vk::Format::eUndefined, vk::ImageLayout::eTransferSrcOptimal); //TODO intermediary
-	}
-
 private:
-	void recordCommandBuffer() {
-		const auto& srcImage = targetImage;
-		const auto& dstImage = stagingImage;
-		const auto cmd = downloadCommand;
-
-		const bool queueOwnershipTransfer = vulkan.getGraphicsQueueIndex() != vulkan.getTransferQueueIndex();
-		const size_t barrierCount = srcImage.getPlanes().size() + dstImage.getPlanes().size();
-		
-		//Record the command buffer
-		const vk::CommandBufferBeginInfo beginInfo(
-			{},
-			nullptr
-		);
-
-		vulkan.begin(cmd, beginInfo);
-		{
-			std::vector<vk::ImageMemoryBarrier> memoryBarriers;
-			memoryBarriers.reserve(barrierCount);
-
-			constexpr vk::ImageSubresourceRange imageSubresourceRange(
-				vk::ImageAspectFlagBits::eColor,				//Aspect mask
-				0, 1, 0, 1										//Base mipmap level, mipmap levels, base array layer, layers
-			);
-
-			//Transition the layout of the images
-			{
-				memoryBarriers.clear();
-				for(const auto& plane : srcImage.getPlanes()){
-					constexpr vk::AccessFlags srcAccess = vk::AccessFlagBits::eColorAttachmentWrite;
-					constexpr vk::AccessFlags dstAccess = vk::AccessFlagBits::eTransferRead;
-
-					//Do not change the layout
-					constexpr vk::ImageLayout srcLayout = vk::ImageLayout::eTransferSrcOptimal;
-					constexpr vk::ImageLayout dstLayout = vk::ImageLayout::eTransferSrcOptimal;
-
-					//Handle the image to the transfer queue
-					const auto srcFamily = queueOwnershipTransfer ? vulkan.getGraphicsQueueIndex() : VK_QUEUE_FAMILY_IGNORED;
-					const auto dstFamily = queueOwnershipTransfer ? vulkan.getTransferQueueIndex() : VK_QUEUE_FAMILY_IGNORED;
-
-					memoryBarriers.emplace_back(
-						srcAccess,								//Old access mask
-						dstAccess,								//New access mask
-						srcLayout,								//Old layout
-						dstLayout,								//New layout
-						srcFamily,								//Old queue family
-						dstFamily,								//New queue family
-						plane.getImage(),						//Image
-						imageSubresourceRange					//Image subresource
-					);
-				}
-				for(const auto& plane : dstImage.getPlanes()){
-					constexpr vk::AccessFlags srcAccess = {};
-					constexpr vk::AccessFlags dstAccess = vk::AccessFlagBits::eTransferWrite;
-
-					constexpr vk::ImageLayout srcLayout = vk::ImageLayout::eUndefined;
-					constexpr vk::ImageLayout dstLayout = vk::ImageLayout::eTransferDstOptimal;
-
-					//Staging frame always owned by the transfer queue
-					constexpr auto srcFamily = VK_QUEUE_FAMILY_IGNORED;
-					constexpr auto dstFamily = VK_QUEUE_FAMILY_IGNORED;
-
-					memoryBarriers.emplace_back(
-						srcAccess,								//Old access mask
-						dstAccess,								//New access mask
-						srcLayout,								//Old layout
-						dstLayout,								//New layout
-						srcFamily,								//Old queue family
-						dstFamily,								//New queue family
-						plane.getImage(),						//Image
-						imageSubresourceRange					//Image subresource
-					);
-				}
-				assert(memoryBarriers.size() == barrierCount);
-
-				constexpr vk::PipelineStageFlags srcStages = 
-					vk::PipelineStageFlagBits::eAllGraphics;
-
-				constexpr vk::PipelineStageFlags dstStages = 
-					vk::PipelineStageFlagBits::eTransfer;
-
-				vulkan.pipelineBarrier(
-					cmd,										//Command buffer
-					srcStages,									//Generating stages
-					dstStages,									//Consuming stages
-					{},											//Dependency flags
-					Utils::BufferView<const vk::ImageMemoryBarrier>(memoryBarriers) //Memory barriers
-				);
-			}
-
-			copy(vulkan, cmd, srcImage, const_cast<Image&>(dstImage)); //FIXME ugly const cast
-
-			//Transition the layout of the images (again)
-			{
-				memoryBarriers.clear();
-				for(const auto& plane : srcImage.getPlanes()){
-					constexpr vk::AccessFlags srcAccess = vk::AccessFlagBits::eTransferRead;
-					constexpr vk::AccessFlags dstAccess = vk::AccessFlagBits::eColorAttachmentWrite;
-
-					//Do not change the layout
-					constexpr vk::ImageLayout srcLayout = vk::ImageLayout::eTransferSrcOptimal;
-					constexpr vk::ImageLayout dstLayout = vk::ImageLayout::eTransferSrcOptimal;
-					
-					//Handle the image back to the graphics queue
-					const auto srcFamily = queueOwnershipTransfer ? vulkan.getTransferQueueIndex() : VK_QUEUE_FAMILY_IGNORED;
-					const auto dstFamily = queueOwnershipTransfer ? vulkan.getGraphicsQueueIndex() : VK_QUEUE_FAMILY_IGNORED;
-
-					memoryBarriers.emplace_back(
-						srcAccess,								//Old access mask
-						dstAccess,								//New access mask
-						srcLayout,								//Old layout
-						dstLayout,								//New layout
-						srcFamily,								//Old queue family
-						dstFamily,								//New queue family
-						plane.getImage(),						//Image
-						imageSubresourceRange					//Image subresource
-					);
-				}
-				for(const auto& plane : dstImage.getPlanes()){
-					constexpr vk::AccessFlags srcAccess = vk::AccessFlagBits::eTransferWrite;
-					constexpr vk::AccessFlags dstAccess = vk::AccessFlagBits::eHostRead;
-
-					constexpr vk::ImageLayout srcLayout = vk::ImageLayout::eTransferDstOptimal;
-					constexpr vk::ImageLayout dstLayout = vk::ImageLayout::eGeneral;
-
-					//Staging frame always owned by the transfer queue
-					constexpr auto srcFamily = VK_QUEUE_FAMILY_IGNORED;
-					constexpr auto dstFamily = VK_QUEUE_FAMILY_IGNORED;
-
-					memoryBarriers.emplace_back(
-						srcAccess,								//Old access mask
-						dstAccess,								//New access mask
-						srcLayout,								//Old layout
-						dstLayout,								//New layout
-						srcFamily,								//Old queue family
-						dstFamily,								//New queue family
-						plane.getImage(),						//Image
-						imageSubresourceRange					//Image subresource
-					);
-				}
-				assert(memoryBarriers.size() == barrierCount);
-
-				constexpr vk::PipelineStageFlags srcStages = 
-					vk::PipelineStageFlagBits::eTransfer;
-
-				constexpr vk::PipelineStageFlags dstStages = 
-					vk::PipelineStageFlagBits::eAllGraphics |
-					vk::PipelineStageFlagBits::eHost ;
-
-				vulkan.pipelineBarrier(
-					cmd,										//Command buffer
-					srcStages,									//Generating stages
-					dstStages,									//Consuming stages
-					{},											//Dependency flags
-					Utils::BufferView<const vk::ImageMemoryBarrier>(memoryBarriers) //Memory barriers
-				);
-			}
+	const Slot& getSlot(uint64_t id) const noexcept {
+		assert(!slots.empty());
+		return slots[id % slots.size()];
+	}
 
-		}
-		vulkan.end(cmd);
+	Slot& getSlot(uint64_t id) noexcept {
+		assert(!slots.empty());
+		return slots[id % slots.size()];
 	}
 
-	static std::vector<Image::Plane> createPlaneDescriptors(const Vulkan& vulkan, 
-															const Frame::Descriptor& desc,
-															ColorTransferWrite& colorTransfer )
+	static std::vector<Image::Plane> createPlanes(	const Vulkan& vulkan,
+													const Frame::Descriptor& desc,
+													ColorTransferWrite& colorTransfer )
 	{
-		std::vector<Image::Plane> result = desc.getPlanes();
+		auto result = desc.getPlanes();
 
-		//Try to optimize it
+		//Try to optimize the swizzle
 		const auto& supportedFormats = getVulkanFormatSupport(vulkan);
-		assert(std::is_sorted(supportedFormats.cbegin(), supportedFormats.cend())); //In order to use binary search
-
-		for(auto& plane : result) {
-			const auto[format, swizzle] = optimizeFormat(std::make_tuple(plane.getFormat(), plane.getSwizzle()));
-			plane.setFormat(format);
-			plane.setSwizzle(swizzle);
-
-			//Ensure that the format is supported
-			assert(plane.getSwizzle() == vk::ComponentMapping());
-			assert(std::binary_search(supportedFormats.cbegin(), supportedFormats.cend(), plane.getFormat()));
+		optimizeSwizzle(result, supportedFormats);
+		for(const auto& plane : result) {
+			if(plane.getSwizzle() != vk::ComponentMapping()) {
+				throw Exception("Swizzled formats are not supported");
+			}
 		}
 
+		//Try to optimize the planes
 		colorTransfer.optimize(result, supportedFormats);
-
-		return result;
-	}
-
-	static std::unique_ptr<DepthStencil> createDepthStencil(const Vulkan& vulkan,
-															vk::Format format,
-															vk::Extent3D extent )
-	{
-		std::unique_ptr<DepthStencil> result;
-
-		//Check for support
-		const auto& supportedFormats = getVulkanFormatSupportDepthStencil(vulkan);
-		assert(std::is_sorted(supportedFormats.cbegin(), supportedFormats.cend())); //In order to use binary search
-		const auto supported = std::binary_search(supportedFormats.cbegin(), supportedFormats.cend(), format);
-
-		if(supported) {
-			//We need to create a depth buffer
-			result = Utils::makeUnique<DepthStencil>(
-				vulkan,
-				to2D(extent),
-				format
-			);
-		}
-
-		return result;
-	}
-
-	static std::unique_ptr<Image> createIntermediaryTargetImage(const Vulkan& vulkan,
-																vk::Format format,
-																vk::Extent3D extent )
-	{
-		std::unique_ptr<Image> result;
-
-		//Check if a intermediary image is required
-		if(format != vk::Format::eUndefined) {
-			const std::array planes = { 
-				Image::Plane(extent, format)
-			};
-
-			constexpr vk::ImageUsageFlags usage = 
-				vk::ImageUsageFlagBits::eColorAttachment |
-				vk::ImageUsageFlagBits::eTransientAttachment |
-				vk::ImageUsageFlagBits::eInputAttachment ;
-
-			constexpr auto tiling = vk::ImageTiling::eOptimal;
-
-			constexpr vk::MemoryPropertyFlags memory = 
-				vk::MemoryPropertyFlagBits::eDeviceLocal |
-				vk::MemoryPropertyFlagBits::eLazilyAllocated ;
-
-			result = Utils::makeUnique<Image>(
-				vulkan,
-				planes,
-				usage,
-				tiling,
-				memory
-			);
+		for(const auto& plane : result) {
+			if(!isSupported(vulkan, plane.getFormat())) {
+				throw Exception("Unsupported format for downloading");
+			}
 		}
 
 		return result;
 	}
 
-	Image createTargetImage(const Vulkan& vulkan,
-							Utils::BufferView<const Image::Plane> planes )
-	{
-		constexpr vk::ImageUsageFlags usage =
-			vk::ImageUsageFlagBits::eColorAttachment |
-			vk::ImageUsageFlagBits::eTransferSrc;
-
-		constexpr vk::ImageTiling tiling =
-			vk::ImageTiling::eOptimal;
-
-		constexpr vk::MemoryPropertyFlags memory =
-			vk::MemoryPropertyFlagBits::eDeviceLocal;
-
-		return Image(
-			vulkan,
-			planes,
-			usage,
-			tiling,
-			memory
-		);
-	}
-
-	static Framebuffer createFramebuffer(	const Vulkan& vulkan,
-											const Image& image,
-											const Image* intermediaryImage,
-											const DepthStencil* depthStencil,
-											const RenderPass& renderPass )
-	{
-		return Framebuffer(
-			vulkan,
-			image,
-			intermediaryImage,
-			depthStencil,
-			renderPass
-		);
-	}
-
-	Image createStagingImage(	const Vulkan& vulkan,
-								Utils::BufferView<const Image::Plane> planes )
+	static RenderPass createRenderPass(	const Vulkan& vulkan,
+										const ColorTransferWrite& colorTransfer,
+										Utils::BufferView<const Image::Plane> planes,
+										DepthStencilFormat depthStencilFmt )
 	{
-		constexpr vk::ImageUsageFlags usage =
-			vk::ImageUsageFlagBits::eTransferDst;
-
-		constexpr vk::ImageTiling tiling =
-			vk::ImageTiling::eLinear;
+		//Leave it ready to be copied
+		constexpr vk::ImageLayout finalLayout = vk::ImageLayout::eTransferSrcOptimal;
 
-		constexpr vk::MemoryPropertyFlags memory =
-			vk::MemoryPropertyFlagBits::eHostVisible;
-
-		return Image(
+		return RenderPass(
 			vulkan,
+			colorTransfer,
 			planes,
-			usage,
-			tiling,
-			memory
-		);
-	}
-
-	static std::vector<Utils::BufferView<const std::byte>> getPixelData(const Vulkan& vulkan,
-																		const Image& stagingImage )
-	{
-		const vk::MappedMemoryRange range(
-			*(stagingImage.getMemory().memory),
-			0, VK_WHOLE_SIZE
+			depthStencilFmt,
+			finalLayout
 		);
-
-		auto* data = reinterpret_cast<const std::byte*>(vulkan.mapMemory(range));
-		return Utils::slice(data, stagingImage.getMemory().areas);
 	}
 
 	static vk::UniqueCommandPool createCommandPool(const Vulkan& vulkan) {
@@ -617,46 +692,63 @@ private:
 		return vulkan.createCommandPool(createInfo);
 	}
 
-	static vk::CommandBuffer createCommandBuffer(const Vulkan& vulkan, vk::CommandPool pool) {
-		return vulkan.allocateCommnadBuffer(pool, vk::CommandBufferLevel::ePrimary).release();
-	}
+	static std::vector<Utils::Area> createReadbackAreas(Utils::BufferView<const Image::Plane> planes) {
+		std::vector<Utils::Area> result;
+		result.reserve(planes.size());
+
+		//Planes are tightly packed. Their offsets must be a multiple 
+		//of both their texel size and 4
+		size_t size = 0;
+		for(const auto& plane : planes) {
+			const auto texelSize = getTexelSize(plane.getFormat());
+			const auto extent = plane.getExtent();
+			assert(texelSize > 0);
+
+			const auto offset = Utils::alignUpper(size, 4*texelSize);
+			const size_t planeSize = texelSize * extent.width * extent.height * extent.depth;
+			result.emplace_back(offset, planeSize);
+			size = offset + planeSize;
+		}
 
-	static RenderPass getRenderPass(const Vulkan& vulkan, 
-									Utils::BufferView<const Image::Plane> planeDescriptors,
-									DepthStencilFormat depthStencilFmt )
-	{
-		return RenderPass(vulkan, planeDescriptors, depthStencilFmt, vk::Format::eUndefined, vk::ImageLayout::eShaderReadOnlyOptimal); //TODO
+		return result;
 	}
 
-	static const std::vector<vk::Format>& getVulkanFormatSupport(const Vulkan& vulkan) {
-		constexpr vk::FormatFeatureFlags DESIRED_FLAGS =
-			vk::FormatFeatureFlagBits::eSampledImage |
-			vk::FormatFeatureFlagBits::eColorAttachment |
-			vk::FormatFeatureFlagBits::eColorAttachmentBlend |
-			vk::FormatFeatureFlagBits::eTransferSrc ;
+	static std::vector<Slot> createSlots(	const Vulkan& vulkan,
+											Utils::BufferView<const Image::Plane> planes,
+											Utils::BufferView<const Utils::Area> readbackAreas,
+											const RenderPass& renderPass,
+											vk::CommandPool commandPool,
+											size_t ringSize )
+	{
+		std::vector<Slot> result;
 
-		return vulkan.listSupportedFormatsOptimal(DESIRED_FLAGS);
-	}
+		if(ringSize == 0) {
+			throw Exception("Downloader ring must not be empty");
+		}
 
-	static const std::vector<vk::Format>& getVulkanFormatSupportDepthStencil(const Vulkan& vulkan) {
-		constexpr vk::FormatFeatureFlags DESIRED_FLAGS =
-			vk::FormatFeatureFlagBits::eDepthStencilAttachment ;
+		result.reserve(ringSize);
+		for(size_t i = 0; i < ringSize; ++i) {
+			result.emplace_back(vulkan, planes, readbackAreas, renderPass, commandPool);
+		}
 
-		return vulkan.listSupportedFormatsOptimal(DESIRED_FLAGS);
+		return result;
 	}
 
 };
 
 
-*/
+
+
+
 /*
  * Downloader
  */
-/*
-Downloader::Downloader(	const Vulkan& vulkan, 
+
+Downloader::Downloader(	const Vulkan& vulkan,
 						const Frame::Descriptor& frameDesc,
-						DepthStencilFormat depthStencilFmt )
-	: m_impl({}, vulkan, frameDesc, depthStencilFmt)
+						DepthStencilFormat depthStencilFmt,
+						size_t ringSize )
+	: m_impl({}, vulkan, frameDesc, depthStencilFmt, ringSize)
 {
 }
 
@@ -676,16 +768,24 @@ const Frame::Descriptor& Downloader::getFrameDescriptor() const noexcept {
 	return m_impl->getFrameDescriptor();
 }
 
+DepthStencilFormat Downloader::getDepthStencilFormat() const noexcept {
+	return m_impl->getDepthStencilFormat();
+}
+
 const ColorTransferWrite& Downloader::getColorTransfer() const noexcept {
 	return m_impl->getColorTransfer();
 }
 
+const RenderPass& Downloader::getRenderPass() const noexcept {
+	return m_impl->getRenderPass();
+}
 
-const Framebuffer& Downloader::getFramebuffer() const noexcept {
-	return m_impl->getFramebuffer();
+size_t Downloader::getRingSize() const noexcept {
+	return m_impl->getRingSize();
 }
 
-void Downloader::beginRenderPass(	vk::CommandBuffer cmd, 
+
+void Downloader::beginRenderPass(	vk::CommandBuffer cmd,
 									vk::Rect2D renderArea,
 									Utils::BufferView<const vk::ClearValue> clearValues,
 									vk::SubpassContents contents ) const noexcept
@@ -697,16 +797,21 @@ void Downloader::endRenderPass(vk::CommandBuffer cmd) const noexcept {
 	m_impl->endRenderPass(cmd);
 }
 
-void Downloader::draw(std::shared_ptr<const CommandBuffer> cmd) {
-	m_impl->draw(std::move(cmd));
+
+uint64_t Downloader::draw(std::shared_ptr<const CommandBuffer> cmd) {
+	return m_impl->draw(std::move(cmd));
+}
+
+uint64_t Downloader::getDrawCount() const noexcept {
+	return m_impl->getDrawCount();
 }
 
-bool Downloader::waitCompletion(uint64_t timeo) const {
-	return m_impl->waitCompletion(timeo);
+bool Downloader::waitCompletion(uint64_t id, uint64_t timeo) const {
+	return m_impl->waitCompletion(id, timeo);
 }
 
-Downloader::PixelData Downloader::getPixelData() const noexcept {
-	return m_impl->getPixelData();
+Downloader::PixelData Downloader::getPixelData(uint64_t id) const noexcept {
+	return m_impl->getPixelData(id);
 }
 
 
@@ -718,16 +823,4 @@ Utils::Discrete<ColorFormat> Downloader::getSupportedSrgbFormats(const Vulkan& v
 	return Impl::getSupportedSrgbFormats(vulkan);
 }
 
-Utils::Discrete<DepthStencilFormat> Downloader::getSupportedFormatsDepthStencil(const Vulkan& vulkan) {
-	return Impl::getSupportedFormatsDepthStencil(vulkan);
-}
-
-RenderPass Downloader::getRenderPass(const Vulkan& vulkan, 
-										const Frame::Descriptor& frameDesc,
-										DepthStencilFormat depthStencilFmt )
-{
-	return Impl::getRenderPass(vulkan, frameDesc, depthStencilFmt);
-}
-
-}
-*/
\ No newline at end of file
+}
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <bitset>
+#include <mutex>
 
 namespace Zuazo::Graphics {
 
@@ -94,7 +95,8 @@ private:
 																						const std::array<Sampler, FILTER_COUNT>& samplers )
 	{
 		using Index = vk::Sampler;
-		static std::unordered_map<Index, const Utils::StaticId> ids; 
+		static std::unordered_map<Index, const Utils::StaticId> ids;
+		static std::mutex idsMutex;
 
 		std::array<vk::DescriptorSetLayout, FILTER_COUNT> result;
 		assert(samplers.size() == result.size());
@@ -102,10 +104,14 @@ private:
 		//Create a descriptor set layout for each of the samplers
 		for(size_t i = 0; i < result.size(); ++i) {
 			const auto sampler = samplers[i].getSampler();
-			const auto& id = ids[sampler]; //TODO concurrent access
+			const Utils::StaticId* id;
+			{
+				std::lock_guard<std::mutex> lock(idsMutex);
+				id = &ids[sampler];
+			}
 
 			//Try to retrieve the descriptor from cache
-			result[i] = vulkan.createDescriptorSetLayout(id);
+			result[i] = vulkan.createDescriptorSetLayout(*id);
 			if(!result[i]) {
 				//No luck, need to create it
 				//Create the bindings
@@ -127,7 +133,7 @@ private:
 					bindings.size(), bindings.data()
 				);
 
-				result[i] = vulkan.createDescriptorSetLayout(id, createInfo);
+				result[i] = vulkan.createDescriptorSetLayout(*id, createInfo);
 			}
 
 			//Ensure that all positions are filled
@@ -236,8 +242,10 @@ struct Frame::Impl {
 
 	Image												image;
 
-	vk::UniqueDescriptorPool							descriptorPool;
+	std::vector<Vulkan::PooledDescriptorSet>			uniqueDescriptorSets;
 	std::array<vk::DescriptorSet, FILTER_COUNT>			descriptorSets;
+	mutable std::array<Vulkan::BindlessSlot, FILTER_COUNT> bindlessSlots;
+	mutable std::mutex									bindlessMutex;
 
 	Impl(	const Vulkan& vulkan,
 			const Image::Plane& plane,
@@ -250,8 +258,10 @@ struct Frame::Impl {
 		, cache(c ? std::move(c) : createCache(vulkan, plane))
 		, userPointer(std::move(usrPtr))
 		, image(createImage(vulkan, plane, usage, *cache))
-		, descriptorPool(createDescriptorPool(vulkan))
-		, descriptorSets(allocateDescriptorSets(vulkan, image, *descriptorPool, *cache))
+		, uniqueDescriptorSets(allocateDescriptorSets(vulkan, image, *cache))
+		, descriptorSets(getDescriptorSets(uniqueDescriptorSets, *cache))
+		, bindlessSlots()
+		, bindlessMutex()
 	{
 	}
 
@@ -284,6 +294,24 @@ struct Frame::Impl {
 		return cache->getSamplingMode(filter);
 	}
 
+	void bind(	CommandBuffer& cmd,
+				vk::PipelineLayout layout,
+				uint32_t index,
+				ScalingFilter filter ) const noexcept
+	{
+		assert(Math::isInRangeExclusive(filter, ScalingFilter::none, ScalingFilter::count));
+		assert(&cmd.getVulkan() == &vulkan.get());
+		const auto descriptorSet = descriptorSets[static_cast<size_t>(filter)];
+
+		cmd.bindDescriptorSets(
+			vk::PipelineBindPoint::eGraphics,	//Pipeline bind point
+			layout,								//Pipeline layout
+			index,								//First index
+			descriptorSet,						//Descriptor sets
+			{}									//Dynamic offsets
+		);
+	}
+
 	void bind(	vk::CommandBuffer cmd,
 				vk::PipelineLayout layout,
 				uint32_t index,
@@ -302,6 +330,22 @@ struct Frame::Impl {
 		);
 	}
 
+	uint32_t getBindlessIndex(ScalingFilter filter) const {
+		assert(Math::isInRangeExclusive(filter, ScalingFilter::none, ScalingFilter::count));
+		assert(vulkan.get().getBindlessSupport());
+
+		//The table is shared by all the frames, so only take 
+		//slots for the filters which are actually sampled
+		std::lock_guard<std::mutex> lock(bindlessMutex);
+		auto& slot = bindlessSlots[static_cast<size_t>(filter)];
+		if(!slot) {
+			slot = allocateBindlessSlot(vulkan, image, *cache, filter);
+		}
+
+		assert(slot);
+		return slot.getIndex();
+	}
+
 
 	void setUserPointer(std::shared_ptr<void> usrPtr) {
 		userPointer = std::move(usrPtr);
@@ -318,6 +362,38 @@ struct Frame::Impl {
 		return Utils::makeShared<const Cache>(vulkan, plane);
 	}
 
+	static void bindBindless(	CommandBuffer& cmd,
+								vk::PipelineLayout layout,
+								uint32_t index ) noexcept
+	{
+		assert(cmd.getVulkan().getBindlessSupport());
+
+		cmd.bindDescriptorSets(
+			vk::PipelineBindPoint::eGraphics,	//Pipeline bind point
+			layout,								//Pipeline layout
+			index,								//First index
+			cmd.getVulkan().getBindlessDescriptorSet(),	//Descriptor sets
+			{}									//Dynamic offsets
+		);
+	}
+
+	static void bindBindless(	const Vulkan& vulkan,
+								vk::CommandBuffer cmd,
+								vk::PipelineLayout layout,
+								uint32_t index ) noexcept
+	{
+		assert(vulkan.getBindlessSupport());
+
+		vulkan.bindDescriptorSets(
+			cmd,								//Commnad buffer
+			vk::PipelineBindPoint::eGraphics,	//Pipeline bind point
+			layout,								//Pipeline layout
+			index,								//First index
+			vulkan.getBindlessDescriptorSet(),	//Descriptor sets
+			{}									//Dynamic offsets
+		);
+	}
+
 
 
 private:
@@ -345,58 +421,28 @@ private:
 		);
 	}
 
-	static vk::UniqueDescriptorPool	createDescriptorPool(const Vulkan& vulkan) {
-		//A descriptor pool is created, from which at most, 3 descriptor sets will
-		//be allocated. Each one of those descriptor sets will have one combined
-		//image sampler. Therefore, 3 descriptors of each type will be required.
-		constexpr std::array<vk::DescriptorPoolSize, 1> poolSizes = {
+	static std::vector<Vulkan::PooledDescriptorSet> allocateDescriptorSets(	const Vulkan& vulkan,
+																			const Image& image,
+																			const Cache& cache )
+	{
+		//Each descriptor set will have one combined image sampler
+		constexpr std::array<vk::DescriptorPoolSize, 1> setSizes = {
 			vk::DescriptorPoolSize(
 				vk::DescriptorType::eCombinedImageSampler,			//Descriptor type
-				FILTER_COUNT										//Descriptor count
+				1													//Descriptor count
 			)
 		};
 
-		const vk::DescriptorPoolCreateInfo createInfo(
-			{},														//Flags
-			FILTER_COUNT,											//Descriptor set count
-			poolSizes.size(), poolSizes.data()						//Pool sizes
-		);
-
-		return vulkan.createDescriptorPool(createInfo);
-	}
-
-
-	static std::array<vk::DescriptorSet, FILTER_COUNT> allocateDescriptorSets(	const Vulkan& vulkan,
-																				const Image& image,
-																				vk::DescriptorPool pool,
-																				const Cache& cache )
-	{
-		std::array<vk::DescriptorSet, FILTER_COUNT> result;
-
-		const auto layouts = cache.getDescriptorSetLayouts();
+		//Allocate descriptor sets for the unique layouts. They are shared with 
+		//the rest of the frames, so that no descriptor pools are created per frame
 		const auto uniqueLayouts = cache.getUniqueDescriptorSetLayouts();
-		assert(layouts.size() == result.size());
-
-		//Allocate descriptor sets for those unique layouts
-		const vk::DescriptorSetAllocateInfo allocInfo(
-			pool,													//Pool
-			uniqueLayouts.size(), uniqueLayouts.data()				//Layouts
-		);
-		auto uniqueDescriptorSets = vulkan.allocateDescriptorSets(allocInfo);
-		assert(uniqueDescriptorSets.size() == uniqueLayouts.size());
-
-		//Fill the result array
+		std::vector<Vulkan::PooledDescriptorSet> uniqueDescriptorSets;
+		uniqueDescriptorSets.reserve(uniqueLayouts.size());
 		std::transform(
-			layouts.cbegin(), layouts.cend(),
-			result.begin(),
-			[&uniqueLayouts, &uniqueDescriptorSets] (vk::DescriptorSetLayout layout) -> vk::DescriptorSet {
-				//Find the corresponding unique layout's index
-				const auto uniqueLayoutIte = std::find(uniqueLayouts.cbegin(), uniqueLayouts.cend(), layout);
-				const auto uniqueLayoutIdx = static_cast<size_t>(std::distance(uniqueLayouts.cbegin(), uniqueLayoutIte));
-				assert(uniqueLayoutIdx < uniqueLayouts.size()); //Must be found
-
-				//The result will be the descriptor set with the same index as the unique layout
-				return uniqueDescriptorSets[uniqueLayoutIdx].get();
+			uniqueLayouts.cbegin(), uniqueLayouts.cend(),
+			std::back_inserter(uniqueDescriptorSets),
+			[&vulkan, &setSizes] (vk::DescriptorSetLayout layout) -> Vulkan::PooledDescriptorSet {
+				return vulkan.allocateDescriptorSet(layout, setSizes);
 			}
 		);
 
@@ -412,7 +458,7 @@ private:
 		};
 		std::for_each(
 			uniqueDescriptorSets.cbegin(), uniqueDescriptorSets.cend(),
-			[&descriptorImageInfos, &vulkan] (const vk::UniqueDescriptorSet& descSet) {
+			[&descriptorImageInfos, &vulkan] (const Vulkan::PooledDescriptorSet& descSet) {
 				//Create write descriptor
 				const std::array<vk::WriteDescriptorSet, 1> writeDescriptorSets = {
 					vk::WriteDescriptorSet( //Image descriptor
@@ -431,15 +477,53 @@ private:
 			}
 		);
 
-		//Release all the descriptor sets, as they will be freed with the descriptor pool
-		std::for_each(
-			uniqueDescriptorSets.begin(), uniqueDescriptorSets.end(),
-			std::mem_fn(&vk::UniqueDescriptorSet::release)
+		return uniqueDescriptorSets;
+	}
+
+	static std::array<vk::DescriptorSet, FILTER_COUNT> getDescriptorSets(	const std::vector<Vulkan::PooledDescriptorSet>& uniqueDescriptorSets,
+																			const Cache& cache )
+	{
+		std::array<vk::DescriptorSet, FILTER_COUNT> result;
+
+		const auto layouts = cache.getDescriptorSetLayouts();
+		const auto uniqueLayouts = cache.getUniqueDescriptorSetLayouts();
+		assert(layouts.size() == result.size());
+		assert(uniqueDescriptorSets.size() == uniqueLayouts.size());
+
+		//Fill the result array
+		std::transform(
+			layouts.cbegin(), layouts.cend(),
+			result.begin(),
+			[&uniqueLayouts, &uniqueDescriptorSets] (vk::DescriptorSetLayout layout) -> vk::DescriptorSet {
+				//Find the corresponding unique layout's index
+				const auto uniqueLayoutIte = std::find(uniqueLayouts.cbegin(), uniqueLayouts.cend(), layout);
+				const auto uniqueLayoutIdx = static_cast<size_t>(std::distance(uniqueLayouts.cbegin(), uniqueLayoutIte));
+				assert(uniqueLayoutIdx < uniqueLayouts.size()); //Must be found
+
+				//The result will be the descriptor set with the same index as the unique layout
+				return uniqueDescriptorSets[uniqueLayoutIdx].get();
+			}
 		);
 
 		return result;
 	}
 
+	static Vulkan::BindlessSlot allocateBindlessSlot(	const Vulkan& vulkan,
+														const Image& image,
+														const Cache& cache,
+														ScalingFilter filter )
+	{
+		//Add the image with the given filter to the bindless table, so 
+		//that draws only need to pass its index instead of binding it
+		const auto planes = image.getPlanes();
+		assert(planes.size() == 1);
+
+		return vulkan.allocateBindlessSlot(
+			planes.front().getImageView(),
+			cache.getSampler(filter).getSampler()
+		);
+	}
+
 };
 
 
@@ -493,6 +577,14 @@ uint32_t Frame::getSamplingMode(ScalingFilter filter) const noexcept {
 	return m_impl->getSamplingMode(filter);
 }
 
+void Frame::bind( 	CommandBuffer& cmd,
+					vk::PipelineLayout layout,
+					uint32_t index,
+					ScalingFilter filter ) const noexcept
+{
+	m_impl->bind(cmd, layout, index, filter);
+}
+
 void Frame::bind( 	vk::CommandBuffer cmd,
 					vk::PipelineLayout layout,
 					uint32_t index,
@@ -501,6 +593,10 @@ void Frame::bind( 	vk::CommandBuffer cmd,
 	m_impl->bind(cmd, layout, index, filter);
 }
 
+uint32_t Frame::getBindlessIndex(ScalingFilter filter) const {
+	return m_impl->getBindlessIndex(filter);
+}
+
 
 void Frame::setUserPointer(std::shared_ptr<void> usrPtr) {
 	m_impl->setUserPointer(std::move(usrPtr));
@@ -517,4 +613,19 @@ std::shared_ptr<const Frame::Cache> Frame::createCache(	const Vulkan& vulkan,
 	return Impl::createCache(vulkan, plane);
 }
 
+void Frame::bindBindless(	CommandBuffer& cmd,
+							vk::PipelineLayout layout,
+							uint32_t index ) noexcept
+{
+	Impl::bindBindless(cmd, layout, index);
+}
+
+void Frame::bindBindless(	const Vulkan& vulkan,
+							vk::CommandBuffer cmd,
+							vk::PipelineLayout layout,
+							uint32_t index ) noexcept
+{
+	Impl::bindBindless(vulkan, cmd, layout, index);
+}
+
 }
\ No newline at end of file
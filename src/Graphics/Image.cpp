@@ -55,7 +55,7 @@ void Image::createImages(	const Vulkan& vulkan,
 		}
 		assert(memoryReq.size() == m_images.size());
 
-		m_memory = vulkan.allocateMemory(memoryReq, memoryProp);
+		m_memory = vulkan.allocateMemory(memoryReq, memoryProp, tiling);
 		assert(m_memory.areas.size() == m_images.size());
 
 
@@ -65,8 +65,8 @@ void Image::createImages(	const Vulkan& vulkan,
 			if(m_images[i]) {
 				vulkan.bindMemory(
 					*m_images[i], 
-					*m_memory.memory, 
-					m_memory.areas[i].offset()
+					m_memory.memory.getDeviceMemory(), 
+					m_memory.memory.getOffset() + m_memory.areas[i].offset()
 				);
 			}
 		}*/
@@ -74,7 +74,11 @@ void Image::createImages(	const Vulkan& vulkan,
 		std::vector<vk::BindImageMemoryInfo> bindInfos;
 		bindInfos.reserve(m_images.size());
 		for(size_t i = 0; i < m_images.size(); ++i) {
-			bindInfos.emplace_back(*m_images[i], *m_memory.memory, m_memory.areas[i].offset());
+			bindInfos.emplace_back(
+				*m_images[i], 
+				m_memory.memory.getDeviceMemory(), 
+				m_memory.memory.getOffset() + m_memory.areas[i].offset()
+			);
 		}
 		
 		vulkan.bindMemory(Utils::BufferView<const vk::BindImageMemoryInfo>(bindInfos));
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <shared_mutex>
+#include <utility>
+#include <type_traits>
+
+namespace Zuazo::Graphics {
+
+/**
+ * Thread-safe map from ids to unique Vulkan handles. Entries are distributed
+ * across several independently locked shards, so that lookups (the common case)
+ * only take a shared lock and insertions rarely contend with each other. Handles
+ * are never erased until the cache is destroyed.
+ */
+template<typename T>
+class ObjectCache {
+public:
+	using UniqueHandle = T;
+	using Handle = std::decay_t<decltype(*std::declval<const UniqueHandle&>())>;
+
+	ObjectCache() = default;
+	ObjectCache(const ObjectCache& other) = delete;
+	~ObjectCache() = default;
+
+	ObjectCache&					operator=(const ObjectCache& other) = delete;
+
+	Handle							find(size_t id) const;
+	Handle							emplace(size_t id, UniqueHandle handle);
+
+private:
+	static constexpr size_t			SHARD_COUNT_LOG2 = 4;
+	static constexpr size_t			SHARD_COUNT = 1 << SHARD_COUNT_LOG2;
+
+	struct Shard {
+		mutable std::shared_mutex				mutex;
+		std::unordered_map<size_t, UniqueHandle>	objects;
+	};
+
+	std::array<Shard, SHARD_COUNT>	m_shards;
+
+	Shard&							getShard(size_t id) noexcept;
+	const Shard&					getShard(size_t id) const noexcept;
+	static size_t					getShardIndex(size_t id) noexcept;
+
+};
+
+}
+
+#include "ObjectCache.inl"
\ No newline at end of file
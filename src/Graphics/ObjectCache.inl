@@ -0,0 +1,52 @@
+#include "ObjectCache.h"
+
+#include <mutex>
+#include <cstdint>
+
+namespace Zuazo::Graphics {
+
+template<typename T>
+inline typename ObjectCache<T>::Handle ObjectCache<T>::find(size_t id) const {
+	const auto& shard = getShard(id);
+	std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+	const auto ite = shard.objects.find(id);
+	return ite != shard.objects.cend() ? *(ite->second) : Handle();
+}
+
+template<typename T>
+inline typename ObjectCache<T>::Handle ObjectCache<T>::emplace(size_t id, UniqueHandle handle) {
+	auto& shard = getShard(id);
+	std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+	//If other thread has inserted the same object in the meantime, 
+	//keep the first one so that already returned handles remain valid.
+	//The new one gets destroyed
+	const auto [ite, result] = shard.objects.emplace(id, std::move(handle));
+	(void)result;
+
+	return *(ite->second);
+}
+
+
+
+template<typename T>
+inline typename ObjectCache<T>::Shard& ObjectCache<T>::getShard(size_t id) noexcept {
+	return m_shards[getShardIndex(id)];
+}
+
+template<typename T>
+inline const typename ObjectCache<T>::Shard& ObjectCache<T>::getShard(size_t id) const noexcept {
+	return m_shards[getShardIndex(id)];
+}
+
+template<typename T>
+inline size_t ObjectCache<T>::getShardIndex(size_t id) noexcept {
+	//Ids are usually addresses, so the lower bits are not random at all. 
+	//Use Fibonacci hashing to spread them
+	constexpr uint64_t FIBONACCI_MULTIPLIER = 0x9E3779B97F4A7C15;
+	const auto hash = static_cast<uint64_t>(id) * FIBONACCI_MULTIPLIER;
+	return static_cast<size_t>(hash >> (64 - SHARD_COUNT_LOG2));
+}
+
+}
\ No newline at end of file
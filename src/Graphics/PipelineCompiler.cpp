@@ -0,0 +1,98 @@
+#include "PipelineCompiler.h"
+
+#include <cassert>
+
+namespace Zuazo::Graphics {
+
+PipelineCompiler::PipelineCompiler(size_t threadCount)
+	: m_threadCount(threadCount)
+	, m_threads()
+	, m_mutex()
+	, m_condition()
+	, m_exit(false)
+	, m_jobs()
+	, m_pending()
+	, m_pendingCount(0)
+{
+	assert(m_threadCount > 0);
+}
+
+PipelineCompiler::~PipelineCompiler() {
+	stop();
+}
+
+
+
+bool PipelineCompiler::enqueue(size_t id, Job job) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(m_exit) {
+		return false; //Stopped
+	}
+
+	const auto [ite, inserted] = m_pending.emplace(id);
+	(void)ite;
+
+	if(inserted) {
+		m_jobs.emplace_back(id, std::move(job));
+		m_pendingCount.store(m_pending.size(), std::memory_order_relaxed);
+
+		//Lazily start the threads
+		if(m_threads.empty()) {
+			m_threads.reserve(m_threadCount);
+			for(size_t i = 0; i < m_threadCount; ++i) {
+				m_threads.emplace_back(&PipelineCompiler::threadFunc, this);
+			}
+		}
+
+		m_condition.notify_one();
+	}
+
+	return inserted;
+}
+
+size_t PipelineCompiler::getPendingCount() const noexcept {
+	return m_pendingCount.load(std::memory_order_relaxed);
+}
+
+void PipelineCompiler::stop() {
+	//Discard the jobs which have not started yet and wait for the rest
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_exit = true;
+	m_jobs.clear();
+	m_condition.notify_all();
+	lock.unlock();
+
+	for(auto& thread : m_threads) {
+		thread.join();
+	}
+	m_threads.clear();
+}
+
+
+
+void PipelineCompiler::threadFunc() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while(true) {
+		m_condition.wait(lock, [this] { return m_exit || !m_jobs.empty(); });
+
+		if(m_exit) {
+			break;
+		}
+
+		auto [id, job] = std::move(m_jobs.front());
+		m_jobs.pop_front();
+
+		//Compile without holding the lock
+		lock.unlock();
+		job();
+		lock.lock();
+
+		//Only mark it as done once the result is available
+		m_pending.erase(id);
+		m_pendingCount.store(m_pending.size(), std::memory_order_relaxed);
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace Zuazo::Graphics {
+
+/**
+ * Runs pipeline compilation jobs on background threads. Each job is identified
+ * by the id of the pipeline it creates, so that the same pipeline is not 
+ * compiled twice when it is requested again while still pending. Threads are
+ * only started when the first job is enqueued.
+ */
+class PipelineCompiler {
+public:
+	using Job = std::function<void()>;
+
+	explicit PipelineCompiler(size_t threadCount);
+	PipelineCompiler(const PipelineCompiler& other) = delete;
+	~PipelineCompiler();
+
+	PipelineCompiler&			operator=(const PipelineCompiler& other) = delete;
+
+	bool						enqueue(size_t id, Job job);
+	size_t						getPendingCount() const noexcept;
+
+	/**
+	 * Discards the jobs which have not started yet and waits for the running 
+	 * ones to finish. Jobs enqueued afterwards are ignored.
+	 */
+	void						stop();
+
+private:
+	size_t						m_threadCount;
+	std::vector<std::thread>	m_threads;
+
+	std::mutex					m_mutex;
+	std::condition_variable		m_condition;
+	bool						m_exit;
+	std::deque<std::pair<size_t, Job>> m_jobs;
+	std::unordered_set<size_t>	m_pending;
+	std::atomic<size_t>			m_pendingCount;
+
+	void						threadFunc();
+
+};
+
+}
\ No newline at end of file
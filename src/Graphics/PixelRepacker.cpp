@@ -0,0 +1,658 @@
+#include "PixelRepacker.h"
+
+#include "../Timing/WorkerPool.h"
+
+#include <zuazo/Utils/CPU.h>
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <cstring>
+#include <cassert>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+#elif defined(__ARM_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace Zuazo::Graphics {
+
+/*
+ * Format table
+ */
+
+struct RepackInfo {
+	ColorFormat				format;
+	bool					packed;
+	size_t					elementSize;
+	std::array<uint8_t, 4>	order;
+};
+
+static constexpr RepackInfo packed422(ColorFormat format, size_t elementSize, uint8_t g0, uint8_t b, uint8_t g1, uint8_t r) noexcept {
+	return RepackInfo{ format, true, elementSize, { g0, b, g1, r } };
+}
+
+static constexpr RepackInfo semiPlanar(ColorFormat format, size_t elementSize, uint8_t b, uint8_t r) noexcept {
+	return RepackInfo{ format, false, elementSize, { b, r, 0, 0 } };
+}
+
+static constexpr RepackInfo getRepackInfo(ColorFormat format) noexcept {
+	switch(format) {
+	//8 bit components
+	case ColorFormat::G8B8G8R8:						return packed422(ColorFormat::G8_B8_R8, 1, 0, 1, 2, 3);
+	case ColorFormat::B8G8R8G8:						return packed422(ColorFormat::G8_B8_R8, 1, 1, 0, 3, 2);
+	case ColorFormat::R8G8B8G8:						return packed422(ColorFormat::G8_B8_R8, 1, 1, 2, 3, 0);
+	case ColorFormat::G8R8G8B8:						return packed422(ColorFormat::G8_B8_R8, 1, 0, 3, 2, 1);
+	case ColorFormat::G8_B8R8:						return semiPlanar(ColorFormat::G8_B8_R8, 1, 0, 1);
+	case ColorFormat::G8_R8B8:						return semiPlanar(ColorFormat::G8_B8_R8, 1, 1, 0);
+	case ColorFormat::G8_B8R8_A8:					return semiPlanar(ColorFormat::G8_B8_R8_A8, 1, 0, 1);
+	case ColorFormat::G8_R8B8_A8:					return semiPlanar(ColorFormat::G8_B8_R8_A8, 1, 1, 0);
+
+	//10 bit components
+	case ColorFormat::G10X6B10X6G10X6R10X6_16:		return packed422(ColorFormat::G10X6_B10X6_R10X6_16, 2, 0, 1, 2, 3);
+	case ColorFormat::B10X6G10X6R10X6G10X6_16:		return packed422(ColorFormat::G10X6_B10X6_R10X6_16, 2, 1, 0, 3, 2);
+	case ColorFormat::R10X6G10X6B10X6G10X6_16:		return packed422(ColorFormat::G10X6_B10X6_R10X6_16, 2, 1, 2, 3, 0);
+	case ColorFormat::G10X6R10X6G10X6B10X6_16:		return packed422(ColorFormat::G10X6_B10X6_R10X6_16, 2, 0, 3, 2, 1);
+	case ColorFormat::G10X6_B10X6R10X6_16:			return semiPlanar(ColorFormat::G10X6_B10X6_R10X6_16, 2, 0, 1);
+	case ColorFormat::G10X6_R10X6B10X6_16:			return semiPlanar(ColorFormat::G10X6_B10X6_R10X6_16, 2, 1, 0);
+	case ColorFormat::G10X6_B10X6R10X6_A10X6_16:	return semiPlanar(ColorFormat::G10X6_B10X6_R10X6_A10X6_16, 2, 0, 1);
+	case ColorFormat::G10X6_R10X6B10X6_A10X6_16:	return semiPlanar(ColorFormat::G10X6_B10X6_R10X6_A10X6_16, 2, 1, 0);
+
+	//12 bit components
+	case ColorFormat::G12X4B12X4G12X4R12X4_16:		return packed422(ColorFormat::G12X4_B12X4_R12X4_16, 2, 0, 1, 2, 3);
+	case ColorFormat::B12X4G12X4R12X4G12X4_16:		return packed422(ColorFormat::G12X4_B12X4_R12X4_16, 2, 1, 0, 3, 2);
+	case ColorFormat::R12X4G12X4B12X4G12X4_16:		return packed422(ColorFormat::G12X4_B12X4_R12X4_16, 2, 1, 2, 3, 0);
+	case ColorFormat::G12X4R12X4G12X4B12X4_16:		return packed422(ColorFormat::G12X4_B12X4_R12X4_16, 2, 0, 3, 2, 1);
+	case ColorFormat::G12X4_B12X4R12X4_16:			return semiPlanar(ColorFormat::G12X4_B12X4_R12X4_16, 2, 0, 1);
+	case ColorFormat::G12X4_R12X4B12X4_16:			return semiPlanar(ColorFormat::G12X4_B12X4_R12X4_16, 2, 1, 0);
+	case ColorFormat::G12X4_B12X4R12X4_A12X4_16:	return semiPlanar(ColorFormat::G12X4_B12X4_R12X4_A12X4_16, 2, 0, 1);
+	case ColorFormat::G12X4_R12X4B12X4_A12X4_16:	return semiPlanar(ColorFormat::G12X4_B12X4_R12X4_A12X4_16, 2, 1, 0);
+
+	//16 bit components
+	case ColorFormat::G16B16G16R16:					return packed422(ColorFormat::G16_B16_R16, 2, 0, 1, 2, 3);
+	case ColorFormat::B16G16R16G16:					return packed422(ColorFormat::G16_B16_R16, 2, 1, 0, 3, 2);
+	case ColorFormat::R16G16B16G16:					return packed422(ColorFormat::G16_B16_R16, 2, 1, 2, 3, 0);
+	case ColorFormat::G16R16G16B16:					return packed422(ColorFormat::G16_B16_R16, 2, 0, 3, 2, 1);
+	case ColorFormat::G16_B16R16:					return semiPlanar(ColorFormat::G16_B16_R16, 2, 0, 1);
+	case ColorFormat::G16_R16B16:					return semiPlanar(ColorFormat::G16_B16_R16, 2, 1, 0);
+	case ColorFormat::G16_B16R16_A16:				return semiPlanar(ColorFormat::G16_B16_R16_A16, 2, 0, 1);
+	case ColorFormat::G16_R16B16_A16:				return semiPlanar(ColorFormat::G16_B16_R16_A16, 2, 1, 0);
+
+	default:										return RepackInfo{ ColorFormat::none, false, 0, {} };
+	}
+}
+
+
+
+/*
+ * Shuffle masks
+ */
+
+static std::array<uint8_t, 16> getPacked422ShuffleMask(size_t elementSize, const std::array<uint8_t, 4>& order) noexcept {
+	//Gather the G components of all the groups in 16 bytes first, then the B and R ones
+	std::array<uint8_t, 16> result;
+	const size_t groupSize = 4*elementSize;
+	const size_t groupCount = result.size() / groupSize;
+	auto ite = result.begin();
+
+	const auto push = [&ite, elementSize, groupSize] (size_t group, size_t position) {
+		for(size_t i = 0; i < elementSize; ++i) {
+			*(ite++) = static_cast<uint8_t>(group*groupSize + position*elementSize + i);
+		}
+	};
+
+	for(size_t i = 0; i < groupCount; ++i) {
+		push(i, order[0]);
+		push(i, order[2]);
+	}
+	for(size_t i = 0; i < groupCount; ++i) {
+		push(i, order[1]);
+	}
+	for(size_t i = 0; i < groupCount; ++i) {
+		push(i, order[3]);
+	}
+
+	assert(ite == result.end());
+	return result;
+}
+
+static std::array<uint8_t, 16> getSemiPlanarShuffleMask(size_t elementSize, const std::array<uint8_t, 4>& order) noexcept {
+	//Gather the B components of all the pairs in 16 bytes first, then the R ones
+	std::array<uint8_t, 16> result;
+	const size_t pairSize = 2*elementSize;
+	const size_t pairCount = result.size() / pairSize;
+	auto ite = result.begin();
+
+	for(size_t component = 0; component < 2; ++component) {
+		for(size_t i = 0; i < pairCount; ++i) {
+			for(size_t j = 0; j < elementSize; ++j) {
+				*(ite++) = static_cast<uint8_t>(i*pairSize + order[component]*elementSize + j);
+			}
+		}
+	}
+
+	assert(ite == result.end());
+	return result;
+}
+
+
+
+/*
+ * Scalar kernels
+ */
+
+template<size_t E>
+static void unpack422Scalar(const std::byte* src,
+							std::byte* g, std::byte* b, std::byte* r,
+							size_t size,
+							const std::array<uint8_t, 4>& order ) noexcept
+{
+	constexpr size_t GROUP_SIZE = 4*E;
+
+	for(size_t i = 0; i < size / GROUP_SIZE; ++i) {
+		const auto* group = src + i*GROUP_SIZE;
+		std::memcpy(g + (2*i + 0)*E, group + order[0]*E, E);
+		std::memcpy(g + (2*i + 1)*E, group + order[2]*E, E);
+		std::memcpy(b + i*E, group + order[1]*E, E);
+		std::memcpy(r + i*E, group + order[3]*E, E);
+	}
+}
+
+template<size_t E>
+static void deinterleaveScalar(	const std::byte* src,
+								std::byte* b, std::byte* r,
+								size_t size,
+								const std::array<uint8_t, 4>& order ) noexcept
+{
+	constexpr size_t PAIR_SIZE = 2*E;
+
+	for(size_t i = 0; i < size / PAIR_SIZE; ++i) {
+		const auto* pair = src + i*PAIR_SIZE;
+		std::memcpy(b + i*E, pair + order[0]*E, E);
+		std::memcpy(r + i*E, pair + order[1]*E, E);
+	}
+}
+
+
+
+/*
+ * Vectorized kernels. They return the amount of source bytes processed,
+ * the remaining ones are left to the scalar kernels. As the shuffle masks
+ * encode the element size, x86 kernels only deal with bytes:
+ * - Packed 4:2:2: each source byte pair yields one G byte and each
+ *   source byte quad yields one B and one R byte
+ * - Semi-planar: each source byte pair yields one B and one R byte
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+
+enum class SIMDLevel {
+	none,
+	ssse3,
+	avx2
+};
+
+static SIMDLevel getSIMDLevel() noexcept {
+	static const SIMDLevel level = [] () -> SIMDLevel {
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2")) {
+			return SIMDLevel::avx2;
+		} else if(__builtin_cpu_supports("ssse3")) {
+			return SIMDLevel::ssse3;
+		} else {
+			return SIMDLevel::none;
+		}
+	}();
+
+	return level;
+}
+
+__attribute__((target("ssse3")))
+static size_t unpack422SSSE3(	const std::byte* src,
+								std::byte* g, std::byte* b, std::byte* r,
+								size_t size,
+								const std::array<uint8_t, 4>& order,
+								const std::array<uint8_t, 16>& shuffleMask ) noexcept
+{
+	(void)(order);
+	const auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffleMask.data()));
+
+	size_t i;
+	for(i = 0; i + 32 <= size; i += 32) {
+		//Each register becomes [G (8 bytes), B (4 bytes), R (4 bytes)]
+		const auto lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 0)), mask);
+		const auto hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)), mask);
+		const auto chroma = _mm_unpackhi_epi32(lo, hi); //[B lo, B hi, R lo, R hi]
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(g + i/2), _mm_unpacklo_epi64(lo, hi));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(b + i/4), chroma);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(r + i/4), _mm_unpackhi_epi64(chroma, chroma));
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t unpack422AVX2(const std::byte* src,
+							std::byte* g, std::byte* b, std::byte* r,
+							size_t size,
+							const std::array<uint8_t, 4>& order,
+							const std::array<uint8_t, 16>& shuffleMask ) noexcept
+{
+	(void)(order);
+	const auto mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffleMask.data())));
+	const auto chromaPermutation = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	size_t i;
+	for(i = 0; i + 64 <= size; i += 64) {
+		//Shuffles happen within 128 bit lanes, so each lane becomes [G, B, R]
+		const auto lo = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 0)), mask);
+		const auto hi = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32)), mask);
+
+		//Restore the order of the lanes
+		const auto luma = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+		const auto chroma = _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi32(lo, hi), chromaPermutation);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(g + i/2), luma);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(b + i/4), _mm256_castsi256_si128(chroma));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(r + i/4), _mm256_extracti128_si256(chroma, 1));
+	}
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t deinterleaveSSSE3(const std::byte* src,
+								std::byte* b, std::byte* r,
+								size_t size,
+								const std::array<uint8_t, 4>& order,
+								const std::array<uint8_t, 16>& shuffleMask ) noexcept
+{
+	(void)(order);
+	const auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffleMask.data()));
+
+	size_t i;
+	for(i = 0; i + 32 <= size; i += 32) {
+		//Each register becomes [B (8 bytes), R (8 bytes)]
+		const auto lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 0)), mask);
+		const auto hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)), mask);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(b + i/2), _mm_unpacklo_epi64(lo, hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(r + i/2), _mm_unpackhi_epi64(lo, hi));
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t deinterleaveAVX2(	const std::byte* src,
+								std::byte* b, std::byte* r,
+								size_t size,
+								const std::array<uint8_t, 4>& order,
+								const std::array<uint8_t, 16>& shuffleMask ) noexcept
+{
+	(void)(order);
+	const auto mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffleMask.data())));
+
+	size_t i;
+	for(i = 0; i + 64 <= size; i += 64) {
+		//Shuffles happen within 128 bit lanes, so each lane becomes [B, R]
+		const auto lo = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 0)), mask);
+		const auto hi = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32)), mask);
+
+		//Restore the order of the lanes
+		const auto blue = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+		const auto red = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i/2), blue);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i/2), red);
+	}
+
+	return i;
+}
+
+#elif defined(__ARM_NEON)
+
+static size_t unpack422NEON(const std::byte* src,
+							std::byte* g, std::byte* b, std::byte* r,
+							size_t size,
+							size_t elementSize,
+							const std::array<uint8_t, 4>& order ) noexcept
+{
+	size_t i = 0;
+
+	//Structured loads split the groups into their components
+	if(elementSize == 1) {
+		for(; i + 64 <= size; i += 64) {
+			const auto groups = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+			const uint8x16x2_t luma = {{ groups.val[order[0]], groups.val[order[2]] }};
+
+			vst2q_u8(reinterpret_cast<uint8_t*>(g + i/2), luma);
+			vst1q_u8(reinterpret_cast<uint8_t*>(b + i/4), groups.val[order[1]]);
+			vst1q_u8(reinterpret_cast<uint8_t*>(r + i/4), groups.val[order[3]]);
+		}
+	} else {
+		assert(elementSize == 2);
+		for(; i + 64 <= size; i += 64) {
+			const auto groups = vld4q_u16(reinterpret_cast<const uint16_t*>(src + i));
+			const uint16x8x2_t luma = {{ groups.val[order[0]], groups.val[order[2]] }};
+
+			vst2q_u16(reinterpret_cast<uint16_t*>(g + i/2), luma);
+			vst1q_u16(reinterpret_cast<uint16_t*>(b + i/4), groups.val[order[1]]);
+			vst1q_u16(reinterpret_cast<uint16_t*>(r + i/4), groups.val[order[3]]);
+		}
+	}
+
+	return i;
+}
+
+static size_t deinterleaveNEON(	const std::byte* src,
+								std::byte* b, std::byte* r,
+								size_t size,
+								size_t elementSize,
+								const std::array<uint8_t, 4>& order ) noexcept
+{
+	size_t i = 0;
+
+	if(elementSize == 1) {
+		for(; i + 32 <= size; i += 32) {
+			const auto pairs = vld2q_u8(reinterpret_cast<const uint8_t*>(src + i));
+			vst1q_u8(reinterpret_cast<uint8_t*>(b + i/2), pairs.val[order[0]]);
+			vst1q_u8(reinterpret_cast<uint8_t*>(r + i/2), pairs.val[order[1]]);
+		}
+	} else {
+		assert(elementSize == 2);
+		for(; i + 32 <= size; i += 32) {
+			const auto pairs = vld2q_u16(reinterpret_cast<const uint16_t*>(src + i));
+			vst1q_u16(reinterpret_cast<uint16_t*>(b + i/2), pairs.val[order[0]]);
+			vst1q_u16(reinterpret_cast<uint16_t*>(r + i/2), pairs.val[order[1]]);
+		}
+	}
+
+	return i;
+}
+
+#endif
+
+
+
+/*
+ * Kernel dispatch
+ */
+
+static void unpack422(	const std::byte* src,
+						std::byte* g, std::byte* b, std::byte* r,
+						size_t size,
+						size_t elementSize,
+						const std::array<uint8_t, 4>& order,
+						const std::array<uint8_t, 16>& shuffleMask ) noexcept
+{
+	size_t done = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+	switch(getSIMDLevel()) {
+	case SIMDLevel::avx2:	done = unpack422AVX2(src, g, b, r, size, order, shuffleMask); break;
+	case SIMDLevel::ssse3:	done = unpack422SSSE3(src, g, b, r, size, order, shuffleMask); break;
+	default: break;
+	}
+#elif defined(__ARM_NEON)
+	(void)(shuffleMask);
+	done = unpack422NEON(src, g, b, r, size, elementSize, order);
+#else
+	(void)(shuffleMask);
+#endif
+
+	//Process the remainder
+	switch(elementSize) {
+	case 1: unpack422Scalar<1>(src + done, g + done/2, b + done/4, r + done/4, size - done, order); break;
+	case 2: unpack422Scalar<2>(src + done, g + done/2, b + done/4, r + done/4, size - done, order); break;
+	default: assert(false); break;
+	}
+}
+
+static void deinterleave(	const std::byte* src,
+							std::byte* b, std::byte* r,
+							size_t size,
+							size_t elementSize,
+							const std::array<uint8_t, 4>& order,
+							const std::array<uint8_t, 16>& shuffleMask ) noexcept
+{
+	size_t done = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+	switch(getSIMDLevel()) {
+	case SIMDLevel::avx2:	done = deinterleaveAVX2(src, b, r, size, order, shuffleMask); break;
+	case SIMDLevel::ssse3:	done = deinterleaveSSSE3(src, b, r, size, order, shuffleMask); break;
+	default: break;
+	}
+#elif defined(__ARM_NEON)
+	(void)(shuffleMask);
+	done = deinterleaveNEON(src, b, r, size, elementSize, order);
+#else
+	(void)(shuffleMask);
+#endif
+
+	//Process the remainder
+	switch(elementSize) {
+	case 1: deinterleaveScalar<1>(src + done, b + done/2, r + done/2, size - done, order); break;
+	case 2: deinterleaveScalar<2>(src + done, b + done/2, r + done/2, size - done, order); break;
+	default: assert(false); break;
+	}
+}
+
+
+
+/*
+ * Worker threads
+ */
+
+struct RepackWorkers {
+	RepackWorkers()
+		: mutex()
+		, pool(std::max(std::thread::hardware_concurrency(), 1U) - 1) //The caller also works
+	{
+	}
+
+	std::mutex				mutex;
+	Timing::WorkerPool		pool;
+};
+
+static RepackWorkers& getRepackWorkers() {
+	static RepackWorkers workers;
+	return workers;
+}
+
+
+
+/*
+ * PixelRepacker
+ */
+
+//Amount of source bytes below which a frame is not split across threads
+static constexpr size_t PARALLEL_JOB_SIZE = 256 << 10;
+
+//Cache line alignment for the source planes
+static constexpr size_t SOURCE_PLANE_ALIGNMENT = 64;
+
+PixelRepacker::PixelRepacker(	ColorFormat format,
+								Resolution resolution,
+								ColorSubsampling subsampling )
+	: m_srcFormat(format)
+	, m_dstFormat(getRepackedColorFormat(format))
+	, m_kind()
+	, m_elementSize()
+	, m_order()
+	, m_shuffleMask()
+	, m_resolution(resolution)
+	, m_chromaResolution(getSubsampledResolution(subsampling, resolution))
+	, m_alpha(hasAlpha(format))
+	, m_srcAreas()
+{
+	const auto info = getRepackInfo(format);
+	assert(info.format != ColorFormat::none);
+
+	m_kind = info.packed ? Kind::packed422 : Kind::semiPlanar;
+	m_elementSize = info.elementSize;
+	m_order = info.order;
+
+	//Lay out the source planes
+	std::vector<size_t> planeSizes;
+	switch(m_kind) {
+	case Kind::packed422:
+		assert(subsampling == ColorSubsampling::rb422);
+		m_shuffleMask = getPacked422ShuffleMask(m_elementSize, m_order);
+		planeSizes.push_back(m_resolution.height * ((m_resolution.width + 1) / 2) * 4 * m_elementSize);
+		break;
+
+	case Kind::semiPlanar:
+		m_shuffleMask = getSemiPlanarShuffleMask(m_elementSize, m_order);
+		planeSizes.push_back(m_resolution.height * m_resolution.width * m_elementSize);
+		planeSizes.push_back(m_chromaResolution.height * m_chromaResolution.width * 2 * m_elementSize);
+		if(m_alpha) {
+			planeSizes.push_back(m_resolution.height * m_resolution.width * m_elementSize);
+		}
+		break;
+	}
+
+	size_t offset = 0;
+	m_srcAreas.reserve(planeSizes.size());
+	for(const auto size : planeSizes) {
+		offset = Utils::align(offset, SOURCE_PLANE_ALIGNMENT);
+		m_srcAreas.emplace_back(offset, size);
+		offset += size;
+	}
+}
+
+
+
+ColorFormat PixelRepacker::getSourceColorFormat() const noexcept {
+	return m_srcFormat;
+}
+
+ColorFormat PixelRepacker::getDestinationColorFormat() const noexcept {
+	return m_dstFormat;
+}
+
+Utils::BufferView<const Utils::Area> PixelRepacker::getSourceAreas() const noexcept {
+	return m_srcAreas;
+}
+
+size_t PixelRepacker::getSourceSize() const noexcept {
+	return m_srcAreas.empty() ? 0 : m_srcAreas.back().end();
+}
+
+
+
+void PixelRepacker::repack(	SourcePlanes src,
+							DestinationPlanes dst ) const
+{
+	assert(src.size() == m_srcAreas.size());
+	assert(dst.size() == getPlaneCount(m_dstFormat));
+
+	const size_t rowCount = m_resolution.height;
+	const size_t jobCount = std::min(getSourceSize() / PARALLEL_JOB_SIZE, rowCount);
+
+	//Split large frames in bands of rows. Only one frame is repacked in parallel
+	//at a time, the rest are repacked in the calling thread
+	auto& workers = getRepackWorkers();
+	std::unique_lock<std::mutex> lock(workers.mutex, std::defer_lock);
+	if(jobCount > 1 && workers.pool.getThreadCount() > 0 && lock.try_lock()) {
+		workers.pool.parallelFor(
+			jobCount,
+			[this, src, dst, rowCount, jobCount] (size_t i) {
+				repackRows(
+					src, dst,
+					i * rowCount / jobCount,
+					(i + 1) * rowCount / jobCount
+				);
+			}
+		);
+	} else {
+		repackRows(src, dst, 0, rowCount);
+	}
+}
+
+ColorFormat PixelRepacker::getRepackedColorFormat(ColorFormat format) noexcept {
+	return getRepackInfo(format).format;
+}
+
+
+
+void PixelRepacker::repackRows(	SourcePlanes src,
+								DestinationPlanes dst,
+								size_t begin, size_t end ) const noexcept
+{
+	const size_t e = m_elementSize;
+	const size_t width = m_resolution.width;
+	const size_t chromaWidth = m_chromaResolution.width;
+	const size_t rowCount = end - begin;
+
+	switch(m_kind) {
+	case Kind::packed422: {
+		//There are as many chroma rows as luma rows
+		const size_t srcRowSize = (width + 1) / 2 * 4 * e;
+		const auto* srcData = src[0].data() + begin*srcRowSize;
+		auto* gData = dst[0].data() + begin*width*e;
+		auto* bData = dst[1].data() + begin*chromaWidth*e;
+		auto* rData = dst[2].data() + begin*chromaWidth*e;
+
+		assert(src[0].size() >= end*srcRowSize);
+		assert(dst[0].size() >= end*width*e);
+		assert(dst[1].size() >= end*chromaWidth*e);
+		assert(dst[2].size() >= end*chromaWidth*e);
+
+		if(width % 2 == 0) {
+			//Rows are contiguous, so they can be processed at once
+			unpack422(srcData, gData, bData, rData, rowCount*srcRowSize, e, m_order, m_shuffleMask);
+		} else {
+			//Odd widths have an incomplete group at the end of each row. Only take its first G
+			for(size_t i = 0; i < rowCount; ++i) {
+				unpack422(srcData, gData, bData, rData, chromaWidth*4*e, e, m_order, m_shuffleMask);
+				std::memcpy(gData + (width - 1)*e, srcData + (chromaWidth*4 + m_order[0])*e, e);
+
+				srcData += srcRowSize;
+				gData += width*e;
+				bData += chromaWidth*e;
+				rData += chromaWidth*e;
+			}
+		}
+		break;
+	}
+
+	case Kind::semiPlanar: {
+		//Luma and alpha are copied as they are
+		const size_t lumaOffset = begin*width*e;
+		const size_t lumaSize = rowCount*width*e;
+		assert(src[0].size() >= lumaOffset + lumaSize);
+		assert(dst[0].size() >= lumaOffset + lumaSize);
+		std::memcpy(dst[0].data() + lumaOffset, src[0].data() + lumaOffset, lumaSize);
+
+		if(m_alpha) {
+			assert(src[2].size() >= lumaOffset + lumaSize);
+			assert(dst[3].size() >= lumaOffset + lumaSize);
+			std::memcpy(dst[3].data() + lumaOffset, src[2].data() + lumaOffset, lumaSize);
+		}
+
+		//Map the luma rows into chroma rows. Consecutive bands do not overlap
+		const size_t chromaBegin = begin * m_chromaResolution.height / m_resolution.height;
+		const size_t chromaEnd = end * m_chromaResolution.height / m_resolution.height;
+		const size_t chromaOffset = chromaBegin*chromaWidth*e;
+		const size_t chromaSize = (chromaEnd - chromaBegin)*chromaWidth*e;
+		assert(src[1].size() >= 2*(chromaOffset + chromaSize));
+		assert(dst[1].size() >= chromaOffset + chromaSize);
+		assert(dst[2].size() >= chromaOffset + chromaSize);
+
+		deinterleave(
+			src[1].data() + 2*chromaOffset,
+			dst[1].data() + chromaOffset,
+			dst[2].data() + chromaOffset,
+			2*chromaSize,
+			e, m_order, m_shuffleMask
+		);
+		break;
+	}
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <zuazo/ColorFormat.h>
+#include <zuazo/ColorSubsampling.h>
+#include <zuazo/Resolution.h>
+#include <zuazo/Utils/BufferView.h>
+#include <zuazo/Utils/Area.h>
+
+#include <vector>
+#include <array>
+#include <cstdint>
+
+namespace Zuazo::Graphics {
+
+/**
+ * Rearranges on the CPU the pixels of formats which can not be uploaded as they are
+ * into an equivalent fully planar format. Packed 4:2:2 formats (such as G8B8G8R8, also
+ * known as YUY2) are split into their components and semi-planar formats (such as G8_B8R8,
+ * also known as NV12) get their chroma plane deinterleaved. Vectorized kernels are
+ * selected at runtime and large frames are split across worker threads.
+ *
+ * Source planes are expected to be tightly packed, with the layout given by
+ * getSourceAreas(). Destination planes follow the layout of the planar format.
+ */
+class PixelRepacker {
+public:
+	using SourcePlanes = Utils::BufferView<const Utils::BufferView<const std::byte>>;
+	using DestinationPlanes = Utils::BufferView<const Utils::BufferView<std::byte>>;
+
+	PixelRepacker(	ColorFormat format,
+					Resolution resolution,
+					ColorSubsampling subsampling );
+	PixelRepacker(const PixelRepacker& other) = default;
+	~PixelRepacker() = default;
+
+	PixelRepacker&						operator=(const PixelRepacker& other) = default;
+
+	ColorFormat							getSourceColorFormat() const noexcept;
+	ColorFormat							getDestinationColorFormat() const noexcept;
+	Utils::BufferView<const Utils::Area>getSourceAreas() const noexcept;
+	size_t								getSourceSize() const noexcept;
+
+	void								repack(	SourcePlanes src,
+												DestinationPlanes dst ) const;
+
+	static ColorFormat					getRepackedColorFormat(ColorFormat format) noexcept;
+
+private:
+	enum class Kind {
+		packed422,
+		semiPlanar
+	};
+
+	ColorFormat							m_srcFormat;
+	ColorFormat							m_dstFormat;
+	Kind								m_kind;
+	size_t								m_elementSize;
+	std::array<uint8_t, 4>				m_order; //Position of G0, B, G1, R or B, R
+	std::array<uint8_t, 16>				m_shuffleMask;
+
+	Resolution							m_resolution;
+	Resolution							m_chromaResolution;
+	bool								m_alpha;
+	std::vector<Utils::Area>			m_srcAreas;
+
+	void								repackRows(	SourcePlanes src,
+													DestinationPlanes dst,
+													size_t begin, size_t end ) const noexcept;
+
+};
+
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <zuazo/Utils/Hasher.h>
 
 #include <unordered_map>
+#include <mutex>
 #include <algorithm>
 #include <bitset>
 
@@ -22,9 +23,8 @@ struct RenderPass::Impl {
 					vk::Format intermediaryImageFmt,
 					vk::RenderPass renderPass )
 			: intermediaryImage(createIntermediaryImage(vulkan, planeDescriptors, intermediaryImageFmt))
-			, descriptorPool(createDescriptorPool(vulkan))
 			, descriptorSetLayout(colorTransfer.createDescriptorSetLayout(vulkan))
-			, descriptorSet(allocateDescriptorSet(vulkan, intermediaryImage, *descriptorPool, descriptorSetLayout))
+			, descriptorSet(allocateDescriptorSet(vulkan, intermediaryImage, descriptorSetLayout))
 			, pipelineLayout(createFinalizationPipelineLayout(vulkan, descriptorSetLayout))
 			, pipeline(createFinalizationPipeline(vulkan, renderPass, pipelineLayout, colorTransfer))
 		{
@@ -35,9 +35,8 @@ struct RenderPass::Impl {
 
 		Image								intermediaryImage;
 
-		vk::UniqueDescriptorPool			descriptorPool;
 		vk::DescriptorSetLayout				descriptorSetLayout;
-		vk::DescriptorSet					descriptorSet;
+		Vulkan::PooledDescriptorSet			descriptorSet;
 
 		vk::PipelineLayout					pipelineLayout;
 		vk::Pipeline						pipeline;
@@ -74,36 +73,21 @@ struct RenderPass::Impl {
 			);
 		}
 
-		static vk::UniqueDescriptorPool createDescriptorPool(const Vulkan& vulkan)
+		static Vulkan::PooledDescriptorSet allocateDescriptorSet(	const Vulkan& vulkan,
+																	const Image& image,
+																	vk::DescriptorSetLayout descriptorSetLayout )
 		{
-			//A descriptor pool is created, from which 1 descriptor sets will
-			//be allocated. This will hold 1 input attachment
-			const std::array<vk::DescriptorPoolSize, 1> poolSizes = {
+			//The descriptor set will hold 1 input attachment
+			constexpr std::array<vk::DescriptorPoolSize, 1> setSizes = {
 				vk::DescriptorPoolSize(
 					vk::DescriptorType::eInputAttachment,				//Descriptor type
 					1													//Descriptor count
 				)
 			};
 
-			const vk::DescriptorPoolCreateInfo createInfo(
-				{},														//Flags
-				1,														//Descriptor set count
-				poolSizes.size(), poolSizes.data()						//Pool sizes
-			);
-
-			return vulkan.createDescriptorPool(createInfo);
-		}
-
-		static vk::DescriptorSet allocateDescriptorSet(	const Vulkan& vulkan,
-														const Image& image,
-														vk::DescriptorPool pool,
-														vk::DescriptorSetLayout descriptorSetLayout )
-		{
-			//Release the newly allocated descriptor set as it will be freed
-			//when de pool gets freed
 			auto result = vulkan.allocateDescriptorSet(
-				pool, 
-				descriptorSetLayout
+				descriptorSetLayout,
+				setSizes
 			);
 
 			const auto imageView = image.getPlanes().front().getImageView();
@@ -130,18 +114,22 @@ struct RenderPass::Impl {
 
 			vulkan.updateDescriptorSets(Utils::BufferView<const vk::WriteDescriptorSet>(writeDescriptorSets));
 
-			//Release it, as it will be freed when de pool is destroyed
-			return result.release();
+			return result;
 		}
 
 		static vk::PipelineLayout createFinalizationPipelineLayout(	const Vulkan& vulkan,
 																	vk::DescriptorSetLayout descriptorSetLayout )
 		{
 			static std::unordered_map<vk::DescriptorSetLayout, const Utils::StaticId> ids;
-			const auto& id = ids[descriptorSetLayout]; //TODO thread safe
+			static std::mutex idsMutex;
+			const Utils::StaticId* id;
+			{
+				std::lock_guard<std::mutex> lock(idsMutex);
+				id = &ids[descriptorSetLayout];
+			}
 
 			//Try to retrive the layout from cache
-			auto result = vulkan.createPipelineLayout(id);
+			auto result = vulkan.createPipelineLayout(*id);
 			if(!result) {
 				const std::array<vk::DescriptorSetLayout, 1> descriptorSetLayouts = {
 					descriptorSetLayout
@@ -153,7 +141,7 @@ struct RenderPass::Impl {
 					0, nullptr										//Push constants
 				);
 
-				result = vulkan.createPipelineLayout(id, createInfo);
+				result = vulkan.createPipelineLayout(*id, createInfo);
 			}
 			assert(result);
 
@@ -170,7 +158,8 @@ struct RenderPass::Impl {
 										vk::PipelineLayout,
 										SpecializationData >;
 
-			static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids; //TODO make thread safe
+			static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids;
+			static std::mutex idsMutex;
 
 			//Copy the specialization data
 			SpecializationData specData;
@@ -183,9 +172,13 @@ struct RenderPass::Impl {
 				pipelineLayout,
 				specData
 			);
-			const auto& id = ids[index];
+			const Utils::StaticId* id;
+			{
+				std::lock_guard<std::mutex> lock(idsMutex);
+				id = &ids[index];
+			}
 
-			auto result = vulkan.createGraphicsPipeline(id);
+			auto result = vulkan.createGraphicsPipeline(*id);
 			if(!result) {
 				static //So that its ptr can be used as an identifier
 				const auto vertexShaderSPIRV = getWholeViewportTriangleSPIRV();
@@ -322,7 +315,7 @@ struct RenderPass::Impl {
 					nullptr, 0											//Inherit
 				);
 
-				result = vulkan.createGraphicsPipeline(id, createInfo);
+				result = vulkan.createGraphicsPipeline(*id, createInfo);
 			}
 
 			return result;
@@ -415,6 +408,28 @@ struct RenderPass::Impl {
 		return vulkan.createFramebuffer(createInfo);
 	}
 
+	void finalize(CommandBuffer& cmd) const noexcept {
+		if(conversion) {
+			cmd.nextSubpass(vk::SubpassContents::eInline);
+
+			cmd.bindDescriptorSets(
+				vk::PipelineBindPoint::eGraphics,		//Pipeline bind point
+				conversion->pipelineLayout,				//Pipeline layout
+				0,										//First index
+				*conversion->descriptorSet,				//Descriptor sets
+				{}										//Dynamic offsets
+			);
+
+			cmd.bindPipeline(
+				vk::PipelineBindPoint::eGraphics, 		//Pipeline bind point
+				conversion->pipeline					//Pipeline
+			);
+
+			//Draw a fullscreen triangle
+			cmd.draw(3, 1, 0, 0);
+		}
+	}
+
 	void finalize(	const Vulkan& vulkan, 
 					vk::CommandBuffer cmd ) const noexcept
 	{
@@ -426,7 +441,7 @@ struct RenderPass::Impl {
 				vk::PipelineBindPoint::eGraphics,		//Pipeline bind point
 				conversion->pipelineLayout,				//Pipeline layout
 				0,										//First index
-				conversion->descriptorSet,				//Descriptor sets
+				*conversion->descriptorSet,				//Descriptor sets
 				{}										//Dynamic offsets
 			);
 
@@ -523,11 +538,16 @@ private:
 		);
 
 		//Obtain the id of the parameters
-		static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids; 
-		const auto& id = ids[index]; //TODO make thread-safe
+		static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids;
+		static std::mutex idsMutex;
+		const Utils::StaticId* id;
+		{
+			std::lock_guard<std::mutex> lock(idsMutex);
+			id = &ids[index];
+		}
 
 		//Check if a renderpass with this id is cached
-		vk::RenderPass result = vulkan.createRenderPass(id);
+		vk::RenderPass result = vulkan.createRenderPass(*id);
 		if(!result) {
 			//Get the element count for the arrays
 			const size_t colorAttachmentCount = planeDescriptors.size();
@@ -743,7 +763,7 @@ private:
 				subpassDependencies.size(), subpassDependencies.data()	//Subpass dependencies
 			);
 
-			result = vulkan.createRenderPass(id, createInfo);
+			result = vulkan.createRenderPass(*id, createInfo);
 		}
 
 		assert(result);
@@ -852,6 +872,10 @@ vk::UniqueFramebuffer RenderPass::createFramebuffer(const Vulkan& vulkan,
 	return m_impl->createFramebuffer(vulkan, target);
 }
 
+void RenderPass::finalize(CommandBuffer& cmd) const noexcept {
+	return m_impl->finalize(cmd);
+}
+
 void RenderPass::finalize(	const Vulkan& vulkan, 
 							vk::CommandBuffer cmd ) const noexcept
 {
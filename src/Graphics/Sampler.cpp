@@ -7,6 +7,7 @@
 
 #include <bitset>
 #include <unordered_map>
+#include <mutex>
 
 namespace Zuazo::Graphics {
 
@@ -246,7 +247,8 @@ vk::SamplerYcbcrConversion Sampler::createSamplerYCbCrConversion(	const Vulkan&
 									vk::ChromaLocation,
 									vk::Filter >;	
 		
-		static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids; 
+		static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids;
+		static std::mutex idsMutex;
 
 		//Create an index to try to retrieve it from cache
 		const Index index (
@@ -261,10 +263,14 @@ vk::SamplerYcbcrConversion Sampler::createSamplerYCbCrConversion(	const Vulkan&
 			yChromaLoc,
 			filter
 		);
-		const auto& id = ids[index]; //TODO concurrent access
+		const Utils::StaticId* id;
+		{
+			std::lock_guard<std::mutex> lock(idsMutex);
+			id = &ids[index];
+		}
 
 		//Try to obtain it from cache
-		result = vulkan.createSamplerYcbcrConversion(id);
+		result = vulkan.createSamplerYcbcrConversion(*id);
 		if(!result) {
 			//No luck, create it
 			constexpr bool forceExplicitReconstruction = false;			
@@ -280,7 +286,7 @@ vk::SamplerYcbcrConversion Sampler::createSamplerYCbCrConversion(	const Vulkan&
 				forceExplicitReconstruction	//Force explicit chroma reconstruction
 			);
 
-			result = vulkan.createSamplerYcbcrConversion(id, createInfo);
+			result = vulkan.createSamplerYcbcrConversion(*id, createInfo);
 
 		}
 	}
@@ -294,13 +300,18 @@ vk::Sampler Sampler::createSampler(	const Vulkan& vulkan,
 {
 	using Index = std::tuple<vk::Filter, vk::SamplerYcbcrConversion>;
 	static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids;
+	static std::mutex idsMutex;
 
 	//Create an index with the relevant parameters and obtain the id
 	const Index index(filter, samplerYCbCrConversion);
-	const auto& id = ids[index]; //TODO concurrent access
+	const Utils::StaticId* id;
+	{
+		std::lock_guard<std::mutex> lock(idsMutex);
+		id = &ids[index];
+	}
 
 	//Try to retrieve the sampler from cache
-	vk::Sampler result = vulkan.createSampler(id);
+	vk::Sampler result = vulkan.createSampler(*id);
 	if(!result) {
 		//Sampler does not exist, create it
 		const auto ycbcrConversionInfo = vk::SamplerYcbcrConversionInfo(samplerYCbCrConversion);
@@ -323,7 +334,7 @@ vk::Sampler Sampler::createSampler(	const Vulkan& vulkan,
 			false													//Unormalized coords
 		).setPNext(ycbcrConversionInfo.conversion ? &ycbcrConversionInfo : nullptr);
 
-		result = vulkan.createSampler(id, createInfo);		
+		result = vulkan.createSampler(*id, createInfo);		
 	}
 
 	return result;
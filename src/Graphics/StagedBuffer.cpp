@@ -1,5 +1,7 @@
 #include <zuazo/Graphics/StagedBuffer.h>
 
+#include <algorithm>
+
 namespace Zuazo::Graphics {
 
 StagedBuffer::StagedBuffer() noexcept = default;
@@ -11,8 +13,7 @@ StagedBuffer::StagedBuffer(	const Vulkan& vulkan,
 	, m_stagingBuffer(createStagingBuffer(vulkan, size))
 	, m_data(mapStagingBuffer(vulkan, size, m_stagingBuffer))
 	, m_commandPool(createCommandPool(vulkan))
-	, m_uploadComplete(vulkan.createFence(false))
-	, m_waitFence(nullptr)
+	, m_waitBatch(0)
 {
 }
 
@@ -53,19 +54,23 @@ void StagedBuffer::flushData(	const Vulkan& vulkan,
 								vk::PipelineStageFlags stage) 
 {
 	if(area.size() > 0) {
-		assert(!m_waitFence);
+		assert(!m_waitBatch);
 
 		//Set the concrete size value if necessary
 		if(area.size() > m_data.size()) {
 			area = Utils::Area(area.offset(), m_data.size());
 		}
 
-		//Flush the memory
+		//Flush the memory. The allocation is aligned to the non-coherent atom
+		//size, so the aligned range does not exceed it
 		const auto& limits = vulkan.getPhysicalDeviceProperties().limits;
+		const auto& memory = m_stagingBuffer.getMemory();
+		const auto begin = Utils::alignLower(area.offset(), limits.nonCoherentAtomSize);
+		const auto end = Utils::alignUpper(area.offset() + area.size(), limits.nonCoherentAtomSize);
 		const vk::MappedMemoryRange range(
-			m_stagingBuffer.getDeviceMemory(),
-			Utils::alignLower(area.offset(), limits.nonCoherentAtomSize),
-			Utils::alignUpper(area.size(), limits.nonCoherentAtomSize)
+			memory.getDeviceMemory(),
+			memory.getOffset() + begin,
+			std::min(end, memory.getSize()) - begin
 		);
 		vulkan.flushMappedMemory(range);
 
@@ -79,21 +84,9 @@ void StagedBuffer::flushData(	const Vulkan& vulkan,
 			);
 		}
 
-		m_waitFence = *m_uploadComplete;
-		vulkan.resetFences(m_waitFence);
-
-		//Submit the command buffer
-		const auto subInfo = vk::SubmitInfo(
-			0, nullptr,							//Wait semaphores
-			nullptr,							//Pipeline stages
-			1, &(ite->second),					//Command buffers
-			0, nullptr							//Signal semaphores
-		);
-		vulkan.submit(
-			vulkan.getTransferQueue(),
-			subInfo,
-			m_waitFence
-		);
+		//Enqueue the command buffer. Small buffers are uploaded in the graphics
+		//queue, so that the draws using them are ordered after the upload
+		m_waitBatch = vulkan.submitGraphicsBatched(ite->second);
 	}
 }
 
@@ -108,9 +101,9 @@ void StagedBuffer::flushData(	const Vulkan& vulkan,
 bool StagedBuffer::waitCompletion(	const Vulkan& vulkan,
 									uint64_t timeo ) const 
 {
-	if(m_waitFence) {
-		if(vulkan.waitForFences(m_waitFence, true, timeo)) {
-			m_waitFence = nullptr;
+	if(m_waitBatch) {
+		if(vulkan.waitBatch(m_waitBatch, timeo)) {
+			m_waitBatch = 0;
 			return true;
 		} else {
 			return false;
@@ -184,12 +177,12 @@ vk::CommandBuffer StagedBuffer::createCommandBuffer(const Vulkan& vulkan,
 
 		//Insert a memory barrier, so that changes are visible
 		{
-			const bool queueOwnershipTransfer = vulkan.getTransferQueueIndex() != queue;
+			const bool queueOwnershipTransfer = vulkan.getGraphicsQueueIndex() != queue;
 
 			constexpr vk::AccessFlags srcAccess = vk::AccessFlagBits::eTransferWrite;
 			const vk::AccessFlags dstAccess = access;
 
-			const auto srcFamily = queueOwnershipTransfer ? vulkan.getTransferQueueIndex() : VK_QUEUE_FAMILY_IGNORED;
+			const auto srcFamily = queueOwnershipTransfer ? vulkan.getGraphicsQueueIndex() : VK_QUEUE_FAMILY_IGNORED;
 			const auto dstFamily = queueOwnershipTransfer ? queue : VK_QUEUE_FAMILY_IGNORED;
 
 			const vk::BufferMemoryBarrier memoryBarrier(
@@ -260,10 +253,7 @@ Utils::BufferView<std::byte> StagedBuffer::mapStagingBuffer(const Vulkan& vulkan
 															const Buffer& stagingBuffer )
 {
 	//Map its memory
-	const vk::MappedMemoryRange range(
-		stagingBuffer.getDeviceMemory(),
-		0, VK_WHOLE_SIZE
-	);
+	const auto range = stagingBuffer.getMemory().getRange();
 	auto* data = reinterpret_cast<std::byte*>(vulkan.mapMemory(range));
 
 	return Utils::BufferView<std::byte>( 
@@ -275,7 +265,7 @@ Utils::BufferView<std::byte> StagedBuffer::mapStagingBuffer(const Vulkan& vulkan
 vk::UniqueCommandPool StagedBuffer::createCommandPool(const Vulkan& vulkan) {
 	const vk::CommandPoolCreateInfo createInfo(
 		{},													//Flags
-		vulkan.getTransferQueueIndex()						//Queue index
+		vulkan.getGraphicsQueueIndex()						//Queue index
 	);
 
 	return vulkan.createCommandPool(createInfo);
@@ -1,14 +1,22 @@
 #include <zuazo/Graphics/StagedFrame.h>
 
+#include "PixelRepacker.h"
+
 #include <zuazo/Graphics/Image.h>
+#include <zuazo/Graphics/CommandBuffer.h>
 #include <zuazo/Graphics/Sampler.h>
 #include <zuazo/Graphics/ColorTransfer.h>
 #include <zuazo/Graphics/WholeViewportTriangle.h>
 #include <zuazo/Utils/StaticId.h>
 #include <zuazo/Utils/Hasher.h>
+#include <zuazo/Utils/CPU.h>
+#include <zuazo/Exception.h>
 
 #include <unordered_map>
+#include <mutex>
 #include <tuple>
+#include <algorithm>
+#include <utility>
 
 namespace Zuazo::Graphics {
 
@@ -31,6 +39,110 @@ static const std::vector<vk::Format>& getVulkanFormatSupportRender(const Vulkan&
 	return vulkan.listSupportedFormatsOptimal(DESIRED_FLAGS);
 }
 
+static bool isFormatSupported(	const std::vector<vk::Format>& vulkanFormatSupport,
+								ColorFormat format )
+{
+	assert(std::is_sorted(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend())); //For binary search
+
+	//Convert it into a Vulkan format
+	const auto conversion = toVulkan(format);
+
+	//Find the end of the range
+	const auto endIte = std::find_if(
+		conversion.cbegin(), conversion.cend(),
+		[] (const std::tuple<vk::Format, vk::ComponentMapping>& conv) -> bool {
+			return std::get<0>(conv) == vk::Format::eUndefined;
+		}
+	);
+
+	//Check if all the planes are supported
+	return std::all_of(
+		conversion.cbegin(), endIte,
+		[&vulkanFormatSupport] (const std::tuple<vk::Format, vk::ComponentMapping>& conv) -> bool {
+			return std::binary_search(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend(), std::get<0>(conv));
+		}
+	);
+}
+
+static bool isRepackingRequired(const std::vector<vk::Format>& vulkanFormatSupport,
+								ColorFormat format )
+{
+	//Formats which can not be uploaded as they are, but have
+	//a supported equivalent
+	const auto repacked = PixelRepacker::getRepackedColorFormat(format);
+	return	repacked != ColorFormat::none &&
+			!isFormatSupported(vulkanFormatSupport, format) &&
+			isFormatSupported(vulkanFormatSupport, repacked);
+}
+
+
+
+/*
+ * Host memory import
+ */
+static constexpr vk::ExternalMemoryHandleTypeFlagBits HOST_MEMORY_HANDLE_TYPE = 
+	vk::ExternalMemoryHandleTypeFlagBits::eHostAllocationEXT;
+
+static bool isHostMemoryImportable(	const Vulkan& vulkan,
+									const Image::Plane& plane ) 
+{
+	const auto& disp = vulkan.getDispatcher();
+
+	const vk::StructureChain<vk::PhysicalDeviceImageFormatInfo2, vk::PhysicalDeviceExternalImageFormatInfo> formatInfo(
+		vk::PhysicalDeviceImageFormatInfo2(
+			plane.getFormat(),							//Pixel format
+			vk::ImageType::e2D,							//Image type
+			vk::ImageTiling::eLinear,					//Tiling
+			vk::ImageUsageFlagBits::eTransferSrc,		//Usage
+			{}											//Flags
+		),
+		vk::PhysicalDeviceExternalImageFormatInfo(
+			HOST_MEMORY_HANDLE_TYPE						//Handle type
+		)
+	);
+	vk::StructureChain<vk::ImageFormatProperties2, vk::ExternalImageFormatProperties> properties;
+
+	vk::Result result;
+	if(disp.vkGetPhysicalDeviceImageFormatProperties2) {
+		result = vulkan.getPhysicalDevice().getImageFormatProperties2(&formatInfo.get(), &properties.get(), disp);
+	} else if(disp.vkGetPhysicalDeviceImageFormatProperties2KHR) {
+		result = vulkan.getPhysicalDevice().getImageFormatProperties2KHR(&formatInfo.get(), &properties.get(), disp);
+	} else {
+		return false;
+	}
+
+	const auto& externalProperties = properties.get<vk::ExternalImageFormatProperties>().externalMemoryProperties;
+	return 	result == vk::Result::eSuccess && 
+			(externalProperties.externalMemoryFeatures & vk::ExternalMemoryFeatureFlagBits::eImportable);
+}
+
+static vk::UniqueImage createHostMemoryImage(	const Vulkan& vulkan,
+												const Image::Plane& plane ) 
+{
+	//Same as the regular staging images, but importable
+	const vk::StructureChain<vk::ImageCreateInfo, vk::ExternalMemoryImageCreateInfo> createInfo(
+		vk::ImageCreateInfo(
+			{},											//Flags
+			vk::ImageType::e2D,							//Image type
+			plane.getFormat(),							//Pixel format
+			plane.getExtent(), 							//Extent
+			1,											//Mip levels
+			1,											//Array layers
+			vk::SampleCountFlagBits::e1,				//Sample count
+			vk::ImageTiling::eLinear,					//Tiling
+			vk::ImageUsageFlagBits::eTransferSrc,		//Usage
+			vk::SharingMode::eExclusive,				//Sharing mode
+			0, nullptr,									//Queue family indices
+			vk::ImageLayout::eUndefined					//Initial layout
+		),
+		vk::ExternalMemoryImageCreateInfo(
+			HOST_MEMORY_HANDLE_TYPE						//Handle types
+		)
+	);
+
+	return vulkan.createImage(createInfo.get());
+}
+
 
 
 /*
@@ -41,11 +153,14 @@ class StagedFrame::Cache {
 public:
 	Cache(const Vulkan& vulkan, const Frame::Descriptor& desc)
 		: m_vulkan(vulkan)
-		, m_srcPlanes(getSourcePlanes(desc))
+		, m_repacker(createRepacker(vulkan, desc))
+		, m_srcPlanes(getSourcePlanes(getUploadDescriptor(desc, m_repacker.get())))
 		, m_conversion()
-		, m_dstPlane(getDestinationPlane(vulkan, desc, m_srcPlanes, m_conversion))
+		, m_dstPlane(getDestinationPlane(vulkan, getUploadDescriptor(desc, m_repacker.get()), m_srcPlanes, m_conversion))
 		, m_commandPool(createCommandPool(vulkan))
+		, m_acquireCommandPool(createAcquireCommandPool(vulkan))
 		, m_frameCache(Frame::createCache(vulkan, m_dstPlane))
+		, m_hostMemoryLayout(getHostMemoryLayout(vulkan, m_srcPlanes, m_repacker.get()))
 	{
 	}
 	
@@ -55,6 +170,10 @@ public:
 		return m_vulkan;
 	}
 
+	const PixelRepacker* getRepacker() const noexcept {
+		return m_repacker.get();
+	}
+
 	Utils::BufferView<const Image::Plane> getSourcePlanes() const noexcept {
 		return m_srcPlanes;
 	}
@@ -99,11 +218,37 @@ public:
 		return *m_commandPool;
 	}
 
+	vk::CommandPool getAcquireCommandPool() const noexcept {
+		return *m_acquireCommandPool;
+	}
+
 	const std::shared_ptr<const Frame::Cache>& 	getFrameCache() const noexcept {
 		return m_frameCache;
 	}
 
+	size_t getHostMemorySize() const noexcept {
+		return m_hostMemoryLayout.size;
+	}
+
+	uint32_t getHostMemoryTypeBits() const noexcept {
+		return m_hostMemoryLayout.memoryTypeBits;
+	}
+
+	Utils::BufferView<const Utils::Area> getHostMemoryAreas() const noexcept {
+		return m_hostMemoryLayout.areas;
+	}
+
 private:
+	/*
+	 * Layout of the planes in imported host memory. A null size means 
+	 * that it can not be imported
+	 */
+	struct HostMemoryLayout {
+		size_t								size = 0;
+		uint32_t							memoryTypeBits = 0;
+		std::vector<Utils::Area>			areas;
+	};
+
 	struct Conversion {
 		Conversion(	const Vulkan& vulkan, 
 					const Frame::Descriptor& frameDesc,
@@ -185,12 +330,17 @@ private:
 		{
 			using Index = vk::Format;
 			static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids;
+			static std::mutex idsMutex;
 
 			const Index index(dstPlane.getFormat());
-			const auto& id = ids[index]; //TODO thread safe
+			const Utils::StaticId* id;
+			{
+				std::lock_guard<std::mutex> lock(idsMutex);
+				id = &ids[index];
+			}
 
 			//Try to retrive the layout from cache
-			auto result = vulkan.createRenderPass(id);
+			auto result = vulkan.createRenderPass(*id);
 			if(!result) {
 				const std::array<vk::AttachmentDescription, 1> attachments = {
 					vk::AttachmentDescription(
@@ -232,7 +382,7 @@ private:
 					0, nullptr												//Dependencies (implicit ones)
 				);
 
-				result = vulkan.createRenderPass(id, createInfo);
+				result = vulkan.createRenderPass(*id, createInfo);
 			}
 			assert(result);
 
@@ -250,10 +400,15 @@ private:
 														vk::DescriptorSetLayout descriptorSetLayout ) 
 		{
 			static std::unordered_map<vk::DescriptorSetLayout, const Utils::StaticId> ids;
-			const auto& id = ids[descriptorSetLayout]; //TODO thread safe
+			static std::mutex idsMutex;
+			const Utils::StaticId* id;
+			{
+				std::lock_guard<std::mutex> lock(idsMutex);
+				id = &ids[descriptorSetLayout];
+			}
 
 			//Try to retrive the layout from cache
-			auto result = vulkan.createPipelineLayout(id);
+			auto result = vulkan.createPipelineLayout(*id);
 			if(!result) {
 				const std::array<vk::DescriptorSetLayout, 1> descriptorSetLayouts = {
 					descriptorSetLayout
@@ -265,7 +420,7 @@ private:
 					0, nullptr										//Push constants
 				);
 
-				result = vulkan.createPipelineLayout(id, createInfo);
+				result = vulkan.createPipelineLayout(*id, createInfo);
 			}
 			assert(result);
 
@@ -284,7 +439,8 @@ private:
 										uint32_t, uint32_t,
 										SpecializationData >;
 
-			static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids; //TODO make thread safe
+			static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids;
+			static std::mutex idsMutex;
 
 			const auto extent = to2D(dstPlane.getExtent());
 
@@ -300,9 +456,13 @@ private:
 				extent.width, extent.height,
 				specData
 			);
-			const auto& id = ids[index];
+			const Utils::StaticId* id;
+			{
+				std::lock_guard<std::mutex> lock(idsMutex);
+				id = &ids[index];
+			}
 
-			auto result = vulkan.createGraphicsPipeline(id);
+			auto result = vulkan.createGraphicsPipeline(*id);
 			if(!result) {
 				static //So that its ptr can be used as an identifier
 				const auto vertexShaderSPIRV = getWholeViewportTriangleSPIRV();
@@ -449,7 +609,7 @@ private:
 					nullptr, 0											//Inherit
 				);
 
-				result = vulkan.createGraphicsPipeline(id, createInfo);
+				result = vulkan.createGraphicsPipeline(*id, createInfo);
 			}
 
 			return result;
@@ -458,15 +618,50 @@ private:
 	};
 
 	std::reference_wrapper<const Vulkan>m_vulkan;
+	std::unique_ptr<PixelRepacker>		m_repacker;
 	std::vector<Image::Plane> 			m_srcPlanes;
 	std::unique_ptr<Conversion>			m_conversion;
 	Image::Plane						m_dstPlane;
 
 	vk::UniqueCommandPool				m_commandPool;
+	vk::UniqueCommandPool				m_acquireCommandPool;
 
 	std::shared_ptr<const Frame::Cache>	m_frameCache;
 
+	HostMemoryLayout					m_hostMemoryLayout;
+
+
+
+	static std::unique_ptr<PixelRepacker> createRepacker(	const Vulkan& vulkan,
+															const Frame::Descriptor& frameDesc )
+	{
+		std::unique_ptr<PixelRepacker> result;
+
+		//Repack the pixels on the CPU when the device can not handle them
+		const auto& supportedFormats = getVulkanFormatSupportTransfer(vulkan);
+		if(isRepackingRequired(supportedFormats, frameDesc.getColorFormat())) {
+			result = Utils::makeUnique<PixelRepacker>(
+				frameDesc.getColorFormat(),
+				frameDesc.getResolution(),
+				frameDesc.getColorSubsampling()
+			);
+		}
+
+		return result;
+	}
+
+	static Frame::Descriptor getUploadDescriptor(	const Frame::Descriptor& frameDesc,
+													const PixelRepacker* repacker )
+	{
+		//Same as the frame descriptor, but with the format which is actually uploaded
+		Frame::Descriptor result = frameDesc;
+
+		if(repacker) {
+			result.setColorFormat(repacker->getDestinationColorFormat());
+		}
 
+		return result;
+	}
 
 	static std::vector<Image::Plane> getSourcePlanes(const Frame::Descriptor& frameDesc) {
 		return frameDesc.getPlanes();
@@ -528,6 +723,60 @@ private:
 		return vulkan.createCommandPool(createInfo);
 	}
 
+	static vk::UniqueCommandPool createAcquireCommandPool(const Vulkan& vulkan) {
+		vk::UniqueCommandPool result;
+
+		//Only needed when uploads need to be handed over to the graphics queue
+		if(vulkan.getGraphicsQueueIndex() != vulkan.getTransferQueueIndex()) {
+			const vk::CommandPoolCreateInfo createInfo(
+				vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+				vulkan.getGraphicsQueueIndex()
+			);
+
+			result = vulkan.createCommandPool(createInfo);
+		}
+
+		return result;
+	}
+
+	static HostMemoryLayout getHostMemoryLayout(const Vulkan& vulkan,
+												const std::vector<Image::Plane>& planes,
+												const PixelRepacker* repacker )
+	{
+		HostMemoryLayout result;
+
+		//Repacked pixels are not written by the user in the staging layout
+		const auto alignment = vulkan.getHostMemoryImportAlignment();
+		const auto importable = alignment && !repacker && std::all_of(
+			planes.cbegin(), planes.cend(),
+			[&vulkan] (const Image::Plane& plane) -> bool {
+				return isHostMemoryImportable(vulkan, plane);
+			}
+		);
+
+		if(importable) {
+			//Lay out the planes as if they were allocated together. Use 
+			//temporary images to query their requirements
+			result.memoryTypeBits = ~(0U);
+			result.areas.reserve(planes.size());
+
+			for(const auto& plane : planes) {
+				const auto image = createHostMemoryImage(vulkan, plane);
+				const auto requirements = vulkan.getMemoryRequirements(*image);
+
+				result.size = Utils::align(result.size, requirements.alignment);
+				result.areas.emplace_back(result.size, requirements.size);
+				result.size += requirements.size;
+				result.memoryTypeBits &= requirements.memoryTypeBits;
+			}
+
+			//Imported memory size must be aligned as well
+			result.size = Utils::align(result.size, alignment);
+		}
+
+		return result;
+	}
+
 };
 
 
@@ -545,15 +794,13 @@ struct StagedFrame::Impl {
 							const Cache& cache  )
 			: image(createImage(vulkan, cache))
 			, framebuffer(createFramebuffer(vulkan, cache, dstImage))
-			, descriptorPool(createDescriptorPool(vulkan, image))
-			, descriptorSet(allocateDescriptorSet(vulkan, cache, image, *descriptorPool))
+			, descriptorSet(allocateDescriptorSet(vulkan, cache, image))
 		{
 		}
 
 		Image						image;
 		vk::UniqueFramebuffer		framebuffer;
-		vk::UniqueDescriptorPool	descriptorPool;
-		vk::DescriptorSet			descriptorSet;
+		Vulkan::PooledDescriptorSet	descriptorSet;
 
 	private:
 		static Image createImage(	const Vulkan& vulkan,
@@ -602,36 +849,22 @@ struct StagedFrame::Impl {
 			return vulkan.createFramebuffer(createInfo);
 		}
 
-		static vk::UniqueDescriptorPool	createDescriptorPool(	const Vulkan& vulkan,
-																const Image& image) 
+		static Vulkan::PooledDescriptorSet allocateDescriptorSet(	const Vulkan& vulkan,
+																	const Cache& cache,
+																	const Image& image )
 		{
-			//A descriptor pool is created, from which 1 descriptor set will
-			//be allocated. This will hold at most 4 combined image samplers
-			const std::array<vk::DescriptorPoolSize, 1> poolSizes = {
+			//Allocate the descriptor set from the shared pools. It will hold 
+			//one combined image sampler per plane (at most 4)
+			const std::array<vk::DescriptorPoolSize, 1> setSizes = {
 				vk::DescriptorPoolSize(
 					vk::DescriptorType::eCombinedImageSampler,			//Descriptor type
 					image.getPlanes().size()							//Descriptor count
 				)
 			};
 
-			const vk::DescriptorPoolCreateInfo createInfo(
-				{},														//Flags
-				1,														//Descriptor set count
-				poolSizes.size(), poolSizes.data()						//Pool sizes
-			);
-
-			return vulkan.createDescriptorPool(createInfo);
-		}
-
-		static vk::DescriptorSet allocateDescriptorSet(	const Vulkan& vulkan,
-														const Cache& cache,
-														const Image& image,
-														vk::DescriptorPool pool )
-		{
-			//Allocate the descriptor set
 			auto result = vulkan.allocateDescriptorSet(
-				pool, 
-				cache.getConversionDescriptorSetLayout()
+				cache.getConversionDescriptorSetLayout(),
+				setSizes
 			);
 
 			//Write the descriptor set's content
@@ -666,36 +899,63 @@ struct StagedFrame::Impl {
 
 			vulkan.updateDescriptorSets(Utils::BufferView<const vk::WriteDescriptorSet>(writeDescriptorSets));
 
-			//Release it, as it will be freed when de pool is destroyed
-			return result.release();
+			return result;
 		}
 	};
 
 	std::shared_ptr<const Cache>				cache;
 
+	/*
+	 * When constructed with host memory, the staging image is bound
+	 * to it, so that the pixels are not copied to a mapped buffer.
+	 * Its lifetime is managed by the user pointer
+	 */
+	vk::UniqueDeviceMemory						importedMemory;
+	std::vector<vk::UniqueImage>				importedImages;
+
 	Image										stagingImage;
+	std::vector<Utils::BufferView<std::byte>> 	stagingData;
+
+	/*
+	 * When the pixels need to be repacked, the user writes them
+	 * to a host buffer, which is repacked into the staging image
+	 * when flushing
+	 */
+	std::vector<std::byte>						repackData;
 	std::vector<Utils::BufferView<std::byte>> 	pixelData;
 
 	std::unique_ptr<IntermediaryImage>			intermediaryImage;
 
-	vk::UniqueCommandBuffer						commandBuffer;
-	vk::SubmitInfo 								commandBufferSubmit;
-	vk::UniqueFence								uploadComplete;
+	/*
+	 * Uploads are recorded in the transfer queue. When it belongs to a different
+	 * family, the images are handed over to the graphics queue with a second
+	 * command buffer, which also performs the conversion. Both are submitted 
+	 * batched with the rest of the tick's work. The graphics queue waits for 
+	 * the transfer GPU-side, so later graphics work is ordered after it.
+	 */
+	CommandBuffer								uploadCommandBuffer;
+	CommandBuffer								acquireCommandBuffer;
+	uint64_t									uploadBatch;
 
 
 	Impl(	const Vulkan& vulkan,
 			const Image& dstImage,
-			std::shared_ptr<const Cache> c )
+			std::shared_ptr<const Cache> c,
+			Utils::BufferView<std::byte> hostMemory = {} )
 		: cache(std::move(c))
-		, stagingImage(createStagingImage(vulkan, *cache))
-		, pixelData(getPixelData(vulkan, stagingImage))
+		, importedMemory(importHostMemory(vulkan, *cache, hostMemory))
+		, importedImages(createImportedImages(vulkan, *cache, *importedMemory))
+		, stagingImage(createStagingImage(vulkan, *cache, importedImages))
+		, stagingData(getStagingData(vulkan, stagingImage, *cache, hostMemory))
+		, repackData(createRepackData(*cache))
+		, pixelData(getPixelData(*cache, stagingData, repackData))
 		, intermediaryImage(createIntermediaryImage(vulkan, dstImage, *cache))
-		, commandBuffer(createCommandBuffer(vulkan, cache->getCommandPool()))
-		, commandBufferSubmit(createSubmitInfo(*commandBuffer))
-		, uploadComplete(vulkan.createFence(false))
+		, uploadCommandBuffer(vulkan, createCommandBuffer(vulkan, cache->getCommandPool()))
+		, acquireCommandBuffer(vulkan, createCommandBuffer(vulkan, cache->getAcquireCommandPool()))
+		, uploadBatch(0)
 	{
 		transitionStagingImageLayout(vulkan);
-		recordCommandBuffer(vulkan, dstImage);
+		recordCommandBuffers(vulkan, dstImage);
 	}
 
 	~Impl() {
@@ -719,24 +979,24 @@ struct StagedFrame::Impl {
 		//There should not be any pending upload
 		assert(waitCompletion(vulkan, 0));
 
-		//Flush the mapped memory
-		const vk::MappedMemoryRange range(
-			*(stagingImage.getMemory().memory),
-			0, VK_WHOLE_SIZE
-		);
-		vulkan.flushMappedMemory(range);
-
-		//Send it to the queue
-		vulkan.resetFences(*uploadComplete);
-		vulkan.submit(
-			vulkan.getTransferQueue(),
-			commandBufferSubmit,
-			*uploadComplete
-		);
+		//Rearrange the pixels if necessary
+		const auto* repacker = cache->getRepacker();
+		if(repacker) {
+			repacker->repack(std::as_const(*this).getPixelData(), stagingData);
+		}
+
+		//Flush the mapped memory. Imported memory is coherent
+		if(!importedMemory) {
+			const auto range = stagingImage.getMemory().memory.getRange();
+			vulkan.flushMappedMemory(range);
+		}
+
+		//Enqueue it to the queue(s). This does not block
+		submit(vulkan, static_cast<bool>(acquireCommandBuffer.get()));
 	}
 
 	bool waitCompletion(const Vulkan& vulkan, uint64_t timeo) const {
-		return vulkan.waitForFences(*uploadComplete, true, timeo);
+		return !uploadBatch || vulkan.waitBatch(uploadBatch, timeo);
 	}
 
 
@@ -780,30 +1040,11 @@ struct StagedFrame::Impl {
 
 		//Query support for Vulkan formats
 		const auto& vulkanFormatSupport = getVulkanFormatSupportTransfer(vulkan);
-		assert(std::is_sorted(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend())); //For binary search
 
-		//Test for each format
+		//Test for each format. Formats which can be repacked into a 
+		//supported one are also accepted
 		for(auto i = Utils::EnumTraits<ColorFormat>::first(); i <= Utils::EnumTraits<ColorFormat>::last(); ++i) {
-			//Convert it into a Vulkan format
-			const auto conversion = toVulkan(i);
-
-			//Find the end of the range
-			const auto endIte = std::find_if(
-				conversion.cbegin(), conversion.cend(),
-				[] (const std::tuple<vk::Format, vk::ComponentMapping>& conv) -> bool {
-					return std::get<0>(conv) == vk::Format::eUndefined;
-				}
-			);
-
-			//Check if it is supported
-			const auto supported = std::all_of(
-				conversion.cbegin(), endIte,
-				[&vulkanFormatSupport] (const std::tuple<vk::Format, vk::ComponentMapping>& conv) -> bool {
-					return std::binary_search(vulkanFormatSupport.cbegin(), vulkanFormatSupport.cend(), std::get<0>(conv));
-				}
-			);
-
-			if(supported) {
+			if(isFormatSupported(vulkanFormatSupport, i) || isRepackingRequired(vulkanFormatSupport, i)) {
 				result.push_back(i);
 			}
 		}
@@ -814,7 +1055,7 @@ struct StagedFrame::Impl {
 private:
 	void transitionStagingImageLayout(const Vulkan& vulkan) {
 		const auto& image = stagingImage;
-		const auto cmd = *commandBuffer;
+		const auto cmd = uploadCommandBuffer.get();
 		const size_t planeCount = image.getPlanes().size();
 
 		constexpr vk::ImageSubresourceRange imageSubresourceRange(
@@ -874,58 +1115,76 @@ private:
 		vulkan.end(cmd);
 
 		//Submit it and wait until it completes execution (blocking)
-		vulkan.submit(vulkan.getTransferQueue(), commandBufferSubmit, *uploadComplete);
+		submit(vulkan, false);
 		waitCompletion(vulkan, Vulkan::NO_TIMEOUT);
 	}
 
-	void recordCommandBuffer(const Vulkan& vulkan, const Image& dstImage) {
+	void recordCommandBuffers(const Vulkan& vulkan, const Image& dstImage) {
 		const auto& srcImage = stagingImage;
-		const auto cmd = *commandBuffer;
+		const auto& uploadedImage = intermediaryImage ? intermediaryImage->image : dstImage;
+		const auto uploadCmd = uploadCommandBuffer.get();
+		const auto acquireCmd = acquireCommandBuffer.get();
 
-		//Record the command buffer
 		const vk::CommandBufferBeginInfo beginInfo(
 			{},
 			nullptr
 		);
 
-		vulkan.begin(cmd, beginInfo);
-
-		//Upload the image
+		//Record the upload command buffer
+		uploadCommandBuffer.begin(beginInfo);
 		uploadImage(
 			vulkan, 
-			cmd,
+			uploadCmd,
 			srcImage,
-			intermediaryImage ? intermediaryImage->image : dstImage
+			uploadedImage,
+			static_cast<bool>(acquireCmd)
 		);
 
+		//Hand the image over to the graphics queue if needed.
+		//Otherwise the conversion is recorded in the same command buffer
+		auto& graphicsCmd = acquireCmd ? acquireCommandBuffer : uploadCommandBuffer;
+		if(acquireCmd) {
+			uploadCommandBuffer.end();
+			acquireCommandBuffer.begin(beginInfo);
+			acquireImage(vulkan, acquireCmd, uploadedImage);
+		}
+
 		//Convert if necessary
 		if(intermediaryImage) {
 			convertImage(
-				vulkan,
-				cmd,
+				graphicsCmd,
 				*intermediaryImage,
 				dstImage,
 				*cache
 			);
 		}
 
-		//Convert if necessary
+		graphicsCmd.end();
+	}
 
+	void submit(const Vulkan& vulkan, bool acquire) {
+		assert(!acquire || acquireCommandBuffer.get());
 
-		vulkan.end(cmd);
+		//Enqueue the transfer
+		uploadBatch = vulkan.submitTransferBatched(uploadCommandBuffer.get());
+
+		//Hand it over to the graphics queue. Waits GPU-side
+		if(acquire) {
+			uploadBatch = vulkan.submitGraphicsBatched(acquireCommandBuffer.get(), true);
+		}
 	}
 
 	static void uploadImage(const Vulkan& vulkan,
 							vk::CommandBuffer cmd,
 							const Image& srcImage,
-							const Image& dstImage )
+							const Image& dstImage,
+							bool queueOwnershipTransfer )
 	{
 		constexpr vk::ImageSubresourceRange imageSubresourceRange(
 			vk::ImageAspectFlagBits::eColor,				//Aspect mask
 			0, 1, 0, 1										//Base mipmap level, mipmap levels, base array layer, layers
 		);
 
-		const bool queueOwnershipTransfer = vulkan.getGraphicsQueueIndex() != vulkan.getTransferQueueIndex();
 		const size_t barrierCount = srcImage.getPlanes().size() + dstImage.getPlanes().size();
 
 		std::vector<vk::ImageMemoryBarrier> memoryBarriers;
@@ -1025,8 +1284,9 @@ private:
 				);
 			}
 			for(const auto& plane : dstImage.getPlanes()){
+				//When releasing ownership, the access is defined by the acquire barrier
 				constexpr vk::AccessFlags srcAccess = vk::AccessFlagBits::eTransferWrite;
-				constexpr vk::AccessFlags dstAccess = vk::AccessFlagBits::eShaderRead;
+				const vk::AccessFlags dstAccess = queueOwnershipTransfer ? vk::AccessFlags() : vk::AccessFlagBits::eShaderRead;
 
 				constexpr vk::ImageLayout srcLayout = vk::ImageLayout::eTransferDstOptimal;
 				constexpr vk::ImageLayout dstLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
@@ -1051,9 +1311,10 @@ private:
 			constexpr vk::PipelineStageFlags srcStages = 
 				vk::PipelineStageFlagBits::eTransfer;
 
-			constexpr vk::PipelineStageFlags dstStages = 
-				vk::PipelineStageFlagBits::eAllGraphics |
-				vk::PipelineStageFlagBits::eHost ;
+			//Graphics stages may not be supported by a dedicated transfer queue
+			const vk::PipelineStageFlags dstStages = queueOwnershipTransfer ?
+				vk::PipelineStageFlags(vk::PipelineStageFlagBits::eBottomOfPipe) :
+				vk::PipelineStageFlagBits::eAllGraphics | vk::PipelineStageFlagBits::eHost ;
 
 			vulkan.pipelineBarrier(
 				cmd,										//Command buffer
@@ -1065,8 +1326,60 @@ private:
 		}
 	}
 
-	static void convertImage(	const Vulkan& vulkan,
+	static void acquireImage(	const Vulkan& vulkan,
 								vk::CommandBuffer cmd,
+								const Image& image )
+	{
+		constexpr vk::ImageSubresourceRange imageSubresourceRange(
+			vk::ImageAspectFlagBits::eColor,				//Aspect mask
+			0, 1, 0, 1										//Base mipmap level, mipmap levels, base array layer, layers
+		);
+
+		const size_t planeCount = image.getPlanes().size();
+
+		std::vector<vk::ImageMemoryBarrier> memoryBarriers;
+		memoryBarriers.reserve(planeCount);
+
+		//Acquire the ownership released by uploadImage. Must match the release barrier
+		for(const auto& plane : image.getPlanes()){
+			constexpr vk::AccessFlags srcAccess = {};
+			constexpr vk::AccessFlags dstAccess = vk::AccessFlagBits::eShaderRead;
+
+			constexpr vk::ImageLayout srcLayout = vk::ImageLayout::eTransferDstOptimal;
+			constexpr vk::ImageLayout dstLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+			const auto srcFamily = vulkan.getTransferQueueIndex();
+			const auto dstFamily = vulkan.getGraphicsQueueIndex();
+
+			memoryBarriers.emplace_back(
+				srcAccess,								//Old access mask
+				dstAccess,								//New access mask
+				srcLayout,								//Old layout
+				dstLayout,								//New layout
+				srcFamily,								//Old queue family
+				dstFamily,								//New queue family
+				plane.getImage(),						//Image
+				imageSubresourceRange					//Image subresource
+			);
+		}
+		assert(memoryBarriers.size() == planeCount);
+
+		constexpr vk::PipelineStageFlags srcStages = 
+			vk::PipelineStageFlagBits::eTopOfPipe;
+
+		constexpr vk::PipelineStageFlags dstStages = 
+			vk::PipelineStageFlagBits::eAllGraphics;
+
+		vulkan.pipelineBarrier(
+			cmd,										//Command buffer
+			srcStages,									//Generating stages
+			dstStages,									//Consuming stages
+			{},											//Dependency flags
+			Utils::BufferView<const vk::ImageMemoryBarrier>(memoryBarriers) //Memory barriers
+		);
+	}
+
+	static void convertImage(	CommandBuffer& cmd,
 								const IntermediaryImage& intImage,
 								const Image& dstImage,
 								const Cache& cache ) 
@@ -1080,32 +1393,84 @@ private:
 			vk::Rect2D(vk::Offset2D(), extent),			//Render area
 			{}											//Clear values
 		);
-		vulkan.beginRenderPass(cmd, beginInfo, vk::SubpassContents::eInline);
+		cmd.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
 
 		//Bind the descriptors and the pipeline
-		vulkan.bindDescriptorSets(
-			cmd,									//Command buffer
+		cmd.bindDescriptorSets(
 			vk::PipelineBindPoint::eGraphics,		//Pipeline bind point
 			cache.getConversionPipelineLayout(),	//Pipeline layout
 			0,										//First index
-			intImage.descriptorSet,					//Descriptor sets
+			*intImage.descriptorSet,				//Descriptor sets
 			{}										//Dynamic offsets
 		);
-		vulkan.bindPipeline(
-			cmd, 									//Command buffer
+		cmd.bindPipeline(
 			vk::PipelineBindPoint::eGraphics, 		//Pipeline bind point
 			cache.getConversionPipeline()			//Pipeline
 		);
 
 		//Draw a fullscreen triangle
-		vulkan.draw(cmd, 3, 1, 0, 0);
+		cmd.draw(3, 1, 0, 0);
 
 		//Finish the renderpass
-		vulkan.endRenderPass(cmd);
+		cmd.endRenderPass();
+	}
+
+	static vk::UniqueDeviceMemory importHostMemory(	const Vulkan& vulkan,
+													const Cache& cache,
+													Utils::BufferView<std::byte> hostMemory )
+	{
+		vk::UniqueDeviceMemory result;
+
+		if(hostMemory.data()) {
+			const auto size = cache.getHostMemorySize();
+			const auto alignment = vulkan.getHostMemoryImportAlignment();
+
+			if(!size) {
+				throw Exception("Host memory can not be imported for this frame");
+			}
+
+			if(hostMemory.size() < size || reinterpret_cast<uintptr_t>(hostMemory.data()) % alignment) {
+				throw Exception("Host memory does not meet the import requirements");
+			}
+
+			constexpr vk::MemoryPropertyFlags memory = 
+				vk::MemoryPropertyFlagBits::eHostVisible |
+				vk::MemoryPropertyFlagBits::eHostCoherent ;
+
+			result = vulkan.importHostMemory(
+				Utils::BufferView<std::byte>(hostMemory.data(), size),
+				cache.getHostMemoryTypeBits(),
+				memory
+			);
+		}
+
+		return result;
+	}
+
+	static std::vector<vk::UniqueImage> createImportedImages(	const Vulkan& vulkan,
+																const Cache& cache,
+																vk::DeviceMemory memory )
+	{
+		std::vector<vk::UniqueImage> result;
+
+		if(memory) {
+			const auto planes = cache.getSourcePlanes();
+			const auto areas = cache.getHostMemoryAreas();
+			assert(planes.size() == areas.size());
+
+			result.reserve(planes.size());
+			for(size_t i = 0; i < planes.size(); ++i) {
+				result.emplace_back(createHostMemoryImage(vulkan, planes[i]));
+				vulkan.bindMemory(*result.back(), memory, areas[i].offset());
+			}
+		}
+
+		return result;
 	}
 
 	static Image createStagingImage(const Vulkan& vulkan, 
-									const Cache& cache )
+									const Cache& cache,
+									const std::vector<vk::UniqueImage>& importedImages )
 	{
 		constexpr vk::ImageUsageFlags usage = 
 			vk::ImageUsageFlagBits::eTransferSrc;
@@ -1116,9 +1481,15 @@ private:
 		constexpr vk::MemoryPropertyFlags memory = 
 			vk::MemoryPropertyFlagBits::eHostVisible;
 
+		//Planes with an image are not allocated by the Image
+		std::vector<Image::Plane> planes(cache.getSourcePlanes().cbegin(), cache.getSourcePlanes().cend());
+		for(size_t i = 0; i < importedImages.size(); ++i) {
+			planes[i].setImage(*importedImages[i]);
+		}
+
 		return Image(
 			vulkan,
-			cache.getSourcePlanes(),
+			planes,
 			usage,
 			tiling,
 			memory,
@@ -1126,18 +1497,50 @@ private:
 		);
 	}
 	
-	static std::vector<Utils::BufferView<std::byte>> getPixelData(	const Vulkan& vulkan,
-																	const Image& stagingImage )
+	static std::vector<Utils::BufferView<std::byte>> getStagingData(const Vulkan& vulkan,
+																	const Image& stagingImage,
+																	const Cache& cache,
+																	Utils::BufferView<std::byte> hostMemory )
 	{
-		const vk::MappedMemoryRange range(
-			*(stagingImage.getMemory().memory),
-			0, VK_WHOLE_SIZE
-		);
+		if(hostMemory.data()) {
+			return Utils::slice(
+				hostMemory.data(), 
+				cache.getHostMemoryAreas()
+			);
+		} else {
+			const auto range = stagingImage.getMemory().memory.getRange();
 
-		return Utils::slice(
-			vulkan.mapMemory(range), 
-			stagingImage.getMemory().areas
-		);
+			return Utils::slice(
+				vulkan.mapMemory(range), 
+				stagingImage.getMemory().areas
+			);
+		}
+	}
+
+	static std::vector<std::byte> createRepackData(const Cache& cache) {
+		std::vector<std::byte> result;
+
+		const auto* repacker = cache.getRepacker();
+		if(repacker) {
+			result.resize(repacker->getSourceSize());
+		}
+
+		return result;
+	}
+
+	static std::vector<Utils::BufferView<std::byte>> getPixelData(	const Cache& cache,
+																	const std::vector<Utils::BufferView<std::byte>>& stagingData,
+																	std::vector<std::byte>& repackData )
+	{
+		const auto* repacker = cache.getRepacker();
+		if(repacker) {
+			return Utils::slice(
+				repackData.data(), 
+				repacker->getSourceAreas()
+			);
+		} else {
+			return stagingData;
+		}
 	}
 
 	static std::unique_ptr<IntermediaryImage> createIntermediaryImage(	const Vulkan& vulkan, 
@@ -1160,16 +1563,13 @@ private:
 	static vk::UniqueCommandBuffer createCommandBuffer(	const Vulkan& vulkan,
 														vk::CommandPool cmdPool )
 	{
-		return vulkan.allocateCommnadBuffer(cmdPool, vk::CommandBufferLevel::ePrimary);
-	}
+		vk::UniqueCommandBuffer result;
 
-	static vk::SubmitInfo createSubmitInfo(const vk::CommandBuffer& cmdBuffer) {
-		return vk::SubmitInfo(
-			0, nullptr,							//Wait semaphores
-			nullptr,							//Pipeline stages
-			1, &cmdBuffer,						//Command buffers
-			0, nullptr							//Signal semaphores
-		);
+		if(cmdPool) {
+			result = vulkan.allocateCommnadBuffer(cmdPool, vk::CommandBufferLevel::ePrimary);
+		}
+
+		return result;
 	}
 
 };
@@ -1191,6 +1591,16 @@ StagedFrame::StagedFrame(	const Vulkan& vulkan,
 {
 }
 
+StagedFrame::StagedFrame(	const Vulkan& vulkan,
+							std::shared_ptr<const Descriptor> desc,
+							Utils::BufferView<std::byte> hostMemory,
+							std::shared_ptr<const Cache> cache,
+							std::shared_ptr<void> usrPtr  )
+	: Frame(Impl::createFrame(vulkan, std::move(desc), cache, std::move(usrPtr)))
+	, m_impl({}, vulkan, getImage(), std::move(cache), hostMemory)
+{
+}
+
 StagedFrame::StagedFrame(StagedFrame&& other) noexcept = default;
 
 StagedFrame::~StagedFrame() = default;
@@ -1223,6 +1633,10 @@ std::shared_ptr<const StagedFrame::Cache> StagedFrame::createCache(	const Vulkan
 	return Impl::createCache(vulkan, frameDesc);
 }
 
+size_t StagedFrame::getHostMemorySize(const Cache& cache) noexcept {
+	return cache.getHostMemorySize();
+}
+
 Utils::Discrete<ColorFormat> StagedFrame::getSupportedFormats(const Vulkan& vulkan) {
 	return Impl::getSupportedFormats(vulkan);
 }
@@ -93,6 +93,23 @@ struct StagedFramePool::Impl {
 		return frame;
 	}
 
+	size_t getHostMemorySize() const noexcept {
+		assert(cache);
+		return StagedFrame::getHostMemorySize(*cache);
+	}
+
+	std::shared_ptr<StagedFrame> wrapFrame(	Utils::BufferView<std::byte> hostMemory,
+											std::shared_ptr<void> usrPtr ) const
+	{
+		return Utils::makeShared<StagedFrame>(
+			vulkan,
+			frameDescriptor,
+			hostMemory,
+			cache,
+			std::move(usrPtr)
+		);
+	}
+
 };
 
 
@@ -142,4 +159,14 @@ std::shared_ptr<StagedFrame> StagedFramePool::acquireFrame() const {
 	return m_impl->acquireFrame();
 }
 
+size_t StagedFramePool::getHostMemorySize() const noexcept {
+	return m_impl->getHostMemorySize();
+}
+
+std::shared_ptr<StagedFrame> StagedFramePool::wrapFrame(Utils::BufferView<std::byte> hostMemory,
+														std::shared_ptr<void> usrPtr ) const
+{
+	return m_impl->wrapFrame(hostMemory, std::move(usrPtr));
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,320 @@
+#include "SubmissionBatcher.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace Zuazo::Graphics {
+
+/*
+ * Helpers
+ */
+
+static vk::UniqueSemaphore createTimelineSemaphore(	const vk::DispatchLoaderDynamic& disp,
+													vk::Device device )
+{
+	const vk::SemaphoreTypeCreateInfoKHR typeCreateInfo(
+		vk::SemaphoreTypeKHR::eTimeline,							//Semaphore type
+		0															//Initial value
+	);
+
+	const auto createInfo = vk::SemaphoreCreateInfo().setPNext(&typeCreateInfo);
+	return device.createSemaphoreUnique(createInfo, nullptr, disp);
+}
+
+static vk::UniqueSemaphore createBinarySemaphore(	const vk::DispatchLoaderDynamic& disp,
+													vk::Device device )
+{
+	const vk::SemaphoreCreateInfo createInfo;
+	return device.createSemaphoreUnique(createInfo, nullptr, disp);
+}
+
+
+
+/*
+ * SubmissionBatcher
+ */
+
+SubmissionBatcher::SubmissionBatcher(	const vk::DispatchLoaderDynamic& disp,
+										vk::Device device,
+										vk::Queue transferQueue,
+										vk::Queue graphicsQueue,
+										bool timelineSemaphores )
+	: m_dispatcher(disp)
+	, m_device(device)
+	, m_transferQueue(transferQueue)
+	, m_graphicsQueue(graphicsQueue)
+	, m_batch(1)
+	, m_graphicsWaitIndex(NO_WAIT)
+	, m_transferTimeline((timelineSemaphores && transferQueue != graphicsQueue) ? createTimelineSemaphore(disp, device) : vk::UniqueSemaphore())
+	, m_graphicsTimeline(timelineSemaphores ? createTimelineSemaphore(disp, device) : vk::UniqueSemaphore())
+	, m_lastTransferBatch(0)
+	, m_lastGraphicsBatch(0)
+	, m_transferComplete(timelineSemaphores ? vk::UniqueSemaphore() : createBinarySemaphore(disp, device))
+	, m_submitCount(0)
+{
+}
+
+SubmissionBatcher::~SubmissionBatcher() {
+	//Pending command buffers are not sent, as their owners have already
+	//waited for them. However, in-flight work must end before destroying
+	//the synchronization primitives
+	const auto& disp = m_dispatcher.get();
+
+	if(m_graphicsTimeline) {
+		waitTimelines(m_lastTransferBatch, m_lastGraphicsBatch, std::numeric_limits<uint64_t>::max());
+	} else {
+		for(const auto& inFlight : m_inFlight) {
+			m_device.waitForFences(*inFlight.fence, true, std::numeric_limits<uint64_t>::max(), disp);
+		}
+	}
+}
+
+
+
+uint64_t SubmissionBatcher::enqueueTransfer(Utils::BufferView<const vk::CommandBuffer> cmds) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(m_transferQueue == m_graphicsQueue) {
+		//There is no dedicated transfer queue. Keeping the submission order
+		//is enough to satisfy the dependencies
+		m_graphicsCommands.insert(m_graphicsCommands.cend(), cmds.cbegin(), cmds.cend());
+	} else {
+		m_transferCommands.insert(m_transferCommands.cend(), cmds.cbegin(), cmds.cend());
+	}
+
+	return m_batch;
+}
+
+uint64_t SubmissionBatcher::enqueueGraphics(Utils::BufferView<const vk::CommandBuffer> cmds,
+											bool waitTransfer )
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(waitTransfer && m_transferQueue != m_graphicsQueue) {
+		m_graphicsWaitIndex = std::min(m_graphicsWaitIndex, m_graphicsCommands.size());
+	}
+
+	m_graphicsCommands.insert(m_graphicsCommands.cend(), cmds.cbegin(), cmds.cend());
+	return m_batch;
+}
+
+void SubmissionBatcher::flush() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	flushLocked();
+}
+
+bool SubmissionBatcher::wait(uint64_t batch, uint64_t timeout) {
+	const auto& disp = m_dispatcher.get();
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	//Pending batches need to be sent before waiting for them
+	assert(batch <= m_batch);
+	if(batch == m_batch) {
+		flushLocked();
+
+		//Nothing was enqueued, so the batch was not sent and nothing
+		//would ever signal its completion
+		if(batch == m_batch) {
+			return true;
+		}
+	}
+
+	if(m_graphicsTimeline) {
+		//Each queue's timeline only grows, so the batch has completed once
+		//both have reached it. Queues which did not get any work after it
+		//only need to reach their last batch
+		const auto transferValue = std::min(batch, m_lastTransferBatch.load());
+		const auto graphicsValue = std::min(batch, m_lastGraphicsBatch.load());
+		lock.unlock();
+
+		return waitTimelines(transferValue, graphicsValue, timeout);
+	} else {
+		const auto ite = std::find_if(
+			m_inFlight.cbegin(), m_inFlight.cend(),
+			[batch] (const InFlightBatch& inFlight) -> bool {
+				return inFlight.batch == batch;
+			}
+		);
+
+		//Batches which are no longer tracked have already completed
+		if(ite == m_inFlight.cend()) {
+			return true;
+		}
+
+		//Fences are only reset when they are reused, which happens right 
+		//before a submission. Therefore, waiting without the lock is safe
+		const auto fence = *(ite->fence);
+		lock.unlock();
+
+		return vk::Result::eSuccess == m_device.waitForFences(fence, true, timeout, disp);
+	}
+}
+
+uint64_t SubmissionBatcher::getPendingBatch() const noexcept {
+	return m_batch.load();
+}
+
+size_t SubmissionBatcher::getSubmitCount() const noexcept {
+	return m_submitCount.load();
+}
+
+
+
+void SubmissionBatcher::flushLocked() {
+	const bool transfer = !m_transferCommands.empty();
+	const bool graphics = !m_graphicsCommands.empty();
+
+	if(!transfer && !graphics) {
+		return; //Nothing to do
+	}
+
+	const auto& disp = m_dispatcher.get();
+	const bool timeline = static_cast<bool>(m_graphicsTimeline);
+	const uint64_t batchValue = m_batch;
+
+	vk::UniqueFence fence;
+	if(!timeline) {
+		recycleFences();
+		fence = acquireFence();
+	}
+
+	if(transfer) {
+		//Signal the semaphore only if somebody is going to wait for it
+		assert(!timeline || m_transferTimeline);
+		const auto signalSemaphore = timeline ? *m_transferTimeline : (graphics ? *m_transferComplete : vk::Semaphore());
+		const vk::TimelineSemaphoreSubmitInfoKHR timelineInfo(
+			0, nullptr,													//Wait values
+			1, &batchValue												//Signal values
+		);
+
+		const auto submitInfo = vk::SubmitInfo(
+			0, nullptr, nullptr,										//Wait semaphores
+			m_transferCommands.size(), m_transferCommands.data(),		//Command buffers
+			signalSemaphore ? 1 : 0, &signalSemaphore					//Signal semaphores
+		).setPNext(timeline ? &timelineInfo : nullptr);
+
+		m_transferQueue.submit(submitInfo, graphics ? vk::Fence() : *fence, disp);
+		m_lastTransferBatch = batchValue;
+		++m_submitCount;
+	}
+
+	if(graphics) {
+		//When there is transfer work, command buffers are split at the first one 
+		//which depends on it. The last submission always waits for the transfer
+		//(even if it is empty) so that its completion implies the whole batch's.
+		const auto waitIndex = transfer ? std::min(m_graphicsWaitIndex, m_graphicsCommands.size()) : 0;
+		const auto waitSemaphore = timeline ? *m_transferTimeline : *m_transferComplete;
+		const auto signalSemaphore = *m_graphicsTimeline;
+		const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+		const vk::TimelineSemaphoreSubmitInfoKHR timelineInfo(
+			transfer ? 1 : 0, &batchValue,								//Wait values
+			1, &batchValue												//Signal values
+		);
+
+		std::array<vk::SubmitInfo, 2> submitInfos;
+		size_t submitInfoCount = 0;
+
+		if(waitIndex > 0) {
+			submitInfos[submitInfoCount++] = vk::SubmitInfo(
+				0, nullptr, nullptr,									//Wait semaphores
+				waitIndex, m_graphicsCommands.data(),					//Command buffers
+				0, nullptr												//Signal semaphores
+			);
+		}
+
+		submitInfos[submitInfoCount++] = vk::SubmitInfo(
+			transfer ? 1 : 0, &waitSemaphore, &waitStage,				//Wait semaphores
+			m_graphicsCommands.size() - waitIndex, 
+			m_graphicsCommands.data() + waitIndex,						//Command buffers
+			timeline ? 1 : 0, &signalSemaphore							//Signal semaphores
+		).setPNext(timeline ? &timelineInfo : nullptr);
+
+		m_graphicsQueue.submit(
+			vk::ArrayProxy<const vk::SubmitInfo>(submitInfoCount, submitInfos.data()),
+			timeline ? vk::Fence() : *fence,
+			disp
+		);
+		m_lastGraphicsBatch = batchValue;
+		++m_submitCount;
+	}
+
+	if(!timeline) {
+		m_inFlight.push_back(InFlightBatch{ m_batch, std::move(fence) });
+	}
+
+	m_transferCommands.clear();
+	m_graphicsCommands.clear();
+	m_graphicsWaitIndex = NO_WAIT;
+	++m_batch;
+}
+
+bool SubmissionBatcher::waitTimelines(	uint64_t transferValue,
+										uint64_t graphicsValue,
+										uint64_t timeout ) const
+{
+	const auto& disp = m_dispatcher.get();
+	std::array<vk::Semaphore, 2> semaphores;
+	std::array<uint64_t, 2> values;
+	size_t count = 0;
+
+	//0 means that no work was ever sent to that queue
+	if(m_transferTimeline && transferValue > 0) {
+		semaphores[count] = *m_transferTimeline;
+		values[count] = transferValue;
+		++count;
+	}
+
+	if(m_graphicsTimeline && graphicsValue > 0) {
+		semaphores[count] = *m_graphicsTimeline;
+		values[count] = graphicsValue;
+		++count;
+	}
+
+	if(count == 0) {
+		return true;
+	}
+
+	const vk::SemaphoreWaitInfoKHR waitInfo(
+		{},																//Flags (wait all)
+		count, semaphores.data(),										//Semaphores
+		values.data()													//Values
+	);
+
+	return vk::Result::eSuccess == m_device.waitSemaphoresKHR(waitInfo, timeout, disp);
+}
+
+vk::UniqueFence SubmissionBatcher::acquireFence() {
+	const auto& disp = m_dispatcher.get();
+	vk::UniqueFence result;
+
+	if(m_freeFences.empty()) {
+		const vk::FenceCreateInfo createInfo;
+		result = m_device.createFenceUnique(createInfo, nullptr, disp);
+	} else {
+		//Recycled fences are kept signaled until they are reused
+		result = std::move(m_freeFences.back());
+		m_freeFences.pop_back();
+		m_device.resetFences(*result, disp);
+	}
+
+	assert(result);
+	return result;
+}
+
+void SubmissionBatcher::recycleFences() {
+	const auto& disp = m_dispatcher.get();
+
+	//Batches on different queues might complete out of order
+	auto ite = m_inFlight.begin();
+	while(ite != m_inFlight.end()) {
+		if(m_device.getFenceStatus(*(ite->fence), disp) == vk::Result::eSuccess) {
+			m_freeFences.push_back(std::move(ite->fence));
+			ite = m_inFlight.erase(ite);
+		} else {
+			++ite;
+		}
+	}
+}
+
+}
\ No newline at end of file
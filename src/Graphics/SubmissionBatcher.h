@@ -0,0 +1,88 @@
+#pragma once
+
+#include <zuazo/Graphics/Vulkan.h>
+#include <zuazo/Utils/BufferView.h>
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <limits>
+
+namespace Zuazo::Graphics {
+
+/**
+ * Collects the command buffers submitted to the transfer and graphics queues
+ * during a tick, so that they are sent with a single vkQueueSubmit per queue
+ * when flushed. Command buffers keep their relative order within each queue.
+ * Graphics work which depends on the transfer work of the same batch waits
+ * for it GPU-side by means of a semaphore.
+ *
+ * Each batch is identified by an increasing number. When supported, each
+ * queue has a timeline semaphore which it sets to n once it finishes the
+ * work of the n-th batch. Values only grow within a queue, so a batch has
+ * completed when both timelines have reached it (or the last batch sent to
+ * that queue, if lower). Otherwise, a binary semaphore links both queues 
+ * and a recycled fence signals the completion.
+ */
+class SubmissionBatcher {
+public:
+	SubmissionBatcher(	const vk::DispatchLoaderDynamic& disp,
+						vk::Device device,
+						vk::Queue transferQueue,
+						vk::Queue graphicsQueue,
+						bool timelineSemaphores );
+	SubmissionBatcher(const SubmissionBatcher& other) = delete;
+	~SubmissionBatcher();
+
+	SubmissionBatcher&						operator=(const SubmissionBatcher& other) = delete;
+
+	uint64_t								enqueueTransfer(Utils::BufferView<const vk::CommandBuffer> cmds);
+	uint64_t								enqueueGraphics(Utils::BufferView<const vk::CommandBuffer> cmds,
+															bool waitTransfer );
+	void									flush();
+	bool									wait(uint64_t batch, uint64_t timeout);
+
+	uint64_t								getPendingBatch() const noexcept;
+
+	size_t									getSubmitCount() const noexcept;
+
+private:
+	struct InFlightBatch {
+		uint64_t								batch;
+		vk::UniqueFence							fence;
+	};
+
+	static constexpr size_t					NO_WAIT = std::numeric_limits<size_t>::max();
+
+	std::reference_wrapper<const vk::DispatchLoaderDynamic> m_dispatcher;
+	vk::Device								m_device;
+	vk::Queue								m_transferQueue;
+	vk::Queue								m_graphicsQueue;
+
+	std::mutex								m_mutex;
+	std::atomic<uint64_t>					m_batch;
+	std::vector<vk::CommandBuffer>			m_transferCommands;
+	std::vector<vk::CommandBuffer>			m_graphicsCommands;
+	size_t									m_graphicsWaitIndex; //First graphics command which waits for the transfer
+
+	vk::UniqueSemaphore						m_transferTimeline; //Only when the queues differ
+	vk::UniqueSemaphore						m_graphicsTimeline;
+	std::atomic<uint64_t>					m_lastTransferBatch; //0 if none
+	std::atomic<uint64_t>					m_lastGraphicsBatch; //0 if none
+	vk::UniqueSemaphore						m_transferComplete;
+	std::deque<InFlightBatch>				m_inFlight;
+	std::vector<vk::UniqueFence>			m_freeFences;
+
+	std::atomic<size_t>						m_submitCount;
+
+	void									flushLocked();
+	bool									waitTimelines(	uint64_t transferValue,
+															uint64_t graphicsValue,
+															uint64_t timeout ) const;
+	vk::UniqueFence							acquireFence();
+	void									recycleFences();
+
+};
+
+}
\ No newline at end of file
@@ -127,7 +127,7 @@ struct TargetFrame::Impl {
 	std::shared_ptr<const Cache>				cache;
 
 	vk::UniqueFramebuffer						framebuffer;
-	vk::UniqueFence								renderComplete;
+	uint64_t									renderBatch;
 
 	std::shared_ptr<const CommandBuffer>		commandBuffer;
 
@@ -136,7 +136,7 @@ struct TargetFrame::Impl {
 			std::shared_ptr<const Cache> c )
 		: cache(std::move(c))
 		, framebuffer(createFramebuffer(vulkan, dstImage, *cache)) //TODO
-		, renderComplete(vulkan.createFence(true))
+		, renderBatch(0)
 		, commandBuffer()
 	{
 	}
@@ -148,7 +148,7 @@ struct TargetFrame::Impl {
 
 
 	bool waitCompletion(const Vulkan& vulkan, uint64_t timeo) const {
-		return vulkan.waitForFences(*renderComplete, true, timeo);
+		return !renderBatch || vulkan.waitBatch(renderBatch, timeo);
 	}
 
 	void beginRenderPass(	const Vulkan& vulkan,
@@ -185,20 +185,8 @@ struct TargetFrame::Impl {
 				commandBuffer->get()
 			};
 
-			const vk::SubmitInfo submitInfo(
-				0, nullptr,										//Wait semaphores
-				nullptr,										//Pipeline stages
-				commandBuffers.size(), commandBuffers.data(),	//Command buffers
-				0, nullptr										//Signal semaphores
-			);
-
-			//Send it to the queue
-			vulkan.resetFences(*renderComplete);
-			vulkan.submit(
-				vulkan.getGraphicsQueue(),
-				submitInfo,
-				*renderComplete
-			);
+			//Send it to the queue along with the rest of the tick's work
+			renderBatch = vulkan.submitGraphicsBatched(commandBuffers);
 		}
 
 	}
@@ -0,0 +1,207 @@
+#include <zuazo/Graphics/UniformRing.h>
+
+#include <zuazo/Exception.h>
+#include <zuazo/Utils/CPU.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+namespace Zuazo::Graphics {
+
+UniformRing::UniformRing() noexcept 
+	: m_alignment(1)
+	, m_frameSize(0)
+	, m_buffer()
+	, m_data()
+	, m_frameBatches()
+	, m_frame(0)
+	, m_frameUsage(0)
+	, m_flushedUsage(0)
+{
+}
+
+UniformRing::UniformRing(	const Vulkan& vulkan,
+							size_t frameSize,
+							size_t frameCount,
+							vk::BufferUsageFlags usage,
+							size_t alignment )
+	: m_alignment(getAlignment(vulkan, usage, alignment))
+	, m_frameSize(getFrameSize(vulkan, frameSize, m_alignment))
+	, m_buffer(createBuffer(vulkan, m_frameSize*frameCount, usage))
+	, m_data(mapBuffer(vulkan, m_frameSize*frameCount, m_buffer))
+	, m_frameBatches(frameCount, 0)
+	, m_frame(0)
+	, m_frameUsage(0)
+	, m_flushedUsage(0)
+{
+}
+
+
+
+vk::Buffer UniformRing::getBuffer() const noexcept {
+	return m_buffer.getBuffer();
+}
+
+size_t UniformRing::getFrameSize() const noexcept {
+	return m_frameSize;
+}
+
+size_t UniformRing::getFrameCount() const noexcept {
+	return m_frameBatches.size();
+}
+
+size_t UniformRing::getAlignment() const noexcept {
+	return m_alignment;
+}
+
+
+
+UniformRing::Slice UniformRing::allocate(size_t size) {
+	const auto offset = Utils::alignUpper(m_frameUsage, m_alignment);
+	if(offset + size > m_frameSize) {
+		throw Exception("Uniform ring frame exhausted");
+	}
+
+	m_frameUsage = offset + size;
+
+	const auto bufferOffset = m_frame*m_frameSize + offset;
+	return Slice{
+		Utils::BufferView<std::byte>(m_data.data() + bufferOffset, size),
+		static_cast<uint32_t>(bufferOffset)
+	};
+}
+
+uint32_t UniformRing::write(const void* data,
+							size_t size )
+{
+	const auto slice = allocate(size);
+	std::memcpy(slice.data.data(), data, slice.data.size());
+	return slice.offset;
+}
+
+void UniformRing::flush(const Vulkan& vulkan) {
+	//Flush the written part of the current frame. Frames are aligned 
+	//to the non-coherent atom size, so the range does not overlap others
+	if(m_frameUsage > m_flushedUsage) {
+		const auto& limits = vulkan.getPhysicalDeviceProperties().limits;
+		const auto& memory = m_buffer.getMemory();
+		const vk::MappedMemoryRange range(
+			memory.getDeviceMemory(),
+			memory.getOffset() + m_frame*m_frameSize,
+			Utils::alignUpper(m_frameUsage, limits.nonCoherentAtomSize)
+		);
+		vulkan.flushMappedMemory(range);
+		m_flushedUsage = m_frameUsage;
+	}
+}
+
+void UniformRing::advance(const Vulkan& vulkan) {
+	assert(!m_frameBatches.empty());
+	flush(vulkan);
+
+	//The work using this frame has been enqueued at most 
+	//in the pending batch
+	m_frameBatches[m_frame] = vulkan.getPendingBatch();
+
+	//Move to the next frame, waiting until the GPU has finished with it
+	m_frame = (m_frame + 1) % m_frameBatches.size();
+	m_frameUsage = 0;
+	m_flushedUsage = 0;
+	if(m_frameBatches[m_frame]) {
+		vulkan.waitBatch(m_frameBatches[m_frame]);
+		m_frameBatches[m_frame] = 0;
+	}
+}
+
+
+
+void UniformRing::writeDescriptorSet(	const Vulkan& vulkan,
+										vk::DescriptorSet descriptorSet,
+										uint32_t binding,
+										size_t range ) const
+{
+	const vk::DescriptorBufferInfo bufferInfo(
+		getBuffer(),						//Buffer
+		0,									//Offset. Provided dynamically
+		range								//Range
+	);
+
+	const vk::WriteDescriptorSet writeDescriptorSet(
+		descriptorSet,						//Descriptor set
+		binding,							//Binding
+		0,									//Index
+		1,									//Descriptor count
+		vk::DescriptorType::eUniformBufferDynamic,	//Descriptor type
+		nullptr,							//Image descriptors
+		&bufferInfo,						//Uniform buffer descriptors
+		nullptr								//Texel buffers
+	);
+
+	vulkan.updateDescriptorSets(writeDescriptorSet);
+}
+
+
+
+size_t UniformRing::getAlignment(	const Vulkan& vulkan,
+									vk::BufferUsageFlags usage,
+									size_t alignment ) noexcept
+{
+	//Dynamic offsets must be aligned to the minimum offset alignment of 
+	//their descriptor type. All of them are powers of 2
+	const auto& limits = vulkan.getPhysicalDeviceProperties().limits;
+	size_t result = std::max(alignment, static_cast<size_t>(1));
+
+	if(usage & vk::BufferUsageFlagBits::eUniformBuffer) {
+		result = std::max(result, static_cast<size_t>(limits.minUniformBufferOffsetAlignment));
+	}
+
+	if(usage & vk::BufferUsageFlagBits::eStorageBuffer) {
+		result = std::max(result, static_cast<size_t>(limits.minStorageBufferOffsetAlignment));
+	}
+
+	return result;
+}
+
+size_t UniformRing::getFrameSize(	const Vulkan& vulkan,
+									size_t frameSize,
+									size_t alignment ) noexcept
+{
+	//Frames are also aligned to nonCoherentAtomSize, so that they can be 
+	//flushed independently
+	const auto& limits = vulkan.getPhysicalDeviceProperties().limits;
+	return Utils::alignUpper(
+		frameSize, 
+		std::max(alignment, static_cast<size_t>(limits.nonCoherentAtomSize))
+	);
+}
+
+Buffer UniformRing::createBuffer(	const Vulkan& vulkan,
+									size_t size,
+									vk::BufferUsageFlags usage )
+{
+	constexpr vk::MemoryPropertyFlags memoryFlags =
+		vk::MemoryPropertyFlagBits::eHostVisible;
+
+	return Buffer(
+		vulkan,
+		usage,
+		memoryFlags,
+		size
+	);
+}
+
+Utils::BufferView<std::byte> UniformRing::mapBuffer(const Vulkan& vulkan,
+													size_t size,
+													const Buffer& buffer )
+{
+	const auto range = buffer.getMemory().getRange();
+	auto* data = reinterpret_cast<std::byte*>(vulkan.mapMemory(range));
+
+	return Utils::BufferView<std::byte>( 
+		data, 
+		size 
+	);
+}
+
+}
\ No newline at end of file
@@ -1,5 +1,12 @@
 #include <zuazo/Graphics/Vulkan.h>
 
+#include "ObjectCache.h"
+#include "PipelineCompiler.h"
+#include "DeviceMemoryAllocator.h"
+#include "DescriptorAllocator.h"
+#include "BindlessDescriptorTable.h"
+#include "SubmissionBatcher.h"
+
 #include <zuazo/Graphics/VulkanConversions.h>
 #include <zuazo/Utils/Functions.h>
 #include <zuazo/Zuazo.h>
@@ -12,7 +19,14 @@
 #include <sstream>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <optional>
+#include <shared_mutex>
+#include <fstream>
+#include <cstdio>
+#include <memory>
+#include <algorithm>
+#include <atomic>
 
 namespace Zuazo::Graphics {
 
@@ -29,6 +43,23 @@ struct Vulkan::Impl {
 		QUEUE_NUM
 	};
 
+	/*
+	 * Prepended to the serialized pipeline cache, so that it is only reused
+	 * with the same device and driver
+	 */
+	struct PipelineCacheHeader {
+		std::array<char, 4>							magic;
+		uint32_t									headerVersion;
+		uint32_t									vendorID;
+		uint32_t									deviceID;
+		uint32_t									driverVersion;
+		std::array<uint8_t, VK_UUID_SIZE>			pipelineCacheUUID;
+		uint64_t									dataSize;
+	};
+
+	static constexpr std::array<char, 4> PIPELINE_CACHE_MAGIC = { 'Z', 'Z', 'P', 'C' };
+	static constexpr uint32_t PIPELINE_CACHE_HEADER_VERSION = 1;
+
 	LogCallback 									logCallback;
 
 	vk::DynamicLoader								loader;
@@ -40,28 +71,44 @@ struct Vulkan::Impl {
 	DeviceFeatures									deviceFeatures;
 	vk::UniqueDevice								device;
 	std::array<vk::Queue, QUEUE_NUM>				queues;
-	vk::UniquePipelineCache							pipelineCache;
 	
 	vk::PhysicalDeviceProperties					physicalDeviceProperties;
 	FormatSupport									formatSupport;
+	mutable DeviceMemoryAllocator					memoryAllocator;
+	mutable DescriptorAllocator						descriptorAllocator;
+	std::unique_ptr<BindlessDescriptorTable>		bindlessDescriptorTable;
+	size_t											hostMemoryImportAlignment;
+
+	std::string										pipelineCachePath;
+	vk::UniquePipelineCache							pipelineCache;
 
 	/*
-	 * Cached Vulkan objects
+	 * Cached Vulkan objects. They may be accessed concurrently
 	 */
 
 	template<typename T>
 	using HashMap = std::unordered_map<size_t, T>;
 
+	mutable std::shared_mutex						formatPropertiesMutex;
 	mutable HashMap<std::vector<vk::Format>>		optimalFormatProperties;
 	mutable HashMap<std::vector<vk::Format>>		linearFormatProperties;
 
-	mutable HashMap<vk::UniqueRenderPass>			renderPasses;
-	mutable HashMap<vk::UniqueShaderModule>			shaders;
-	mutable HashMap<vk::UniquePipelineLayout>		pipelineLayouts;
-	mutable HashMap<vk::UniquePipeline>				graphicsPipelines;
-	mutable HashMap<vk::UniqueDescriptorSetLayout>	descriptorSetLayouts;
-	mutable HashMap<vk::UniqueSamplerYcbcrConversion>	samplerYCbCrConversions;
-	mutable HashMap<vk::UniqueSampler>				samplers;
+	mutable ObjectCache<vk::UniqueRenderPass>		renderPasses;
+	mutable ObjectCache<vk::UniqueShaderModule>		shaders;
+	mutable ObjectCache<vk::UniquePipelineLayout>	pipelineLayouts;
+	mutable ObjectCache<vk::UniquePipeline>			graphicsPipelines;
+	mutable ObjectCache<vk::UniqueDescriptorSetLayout>	descriptorSetLayouts;
+	mutable ObjectCache<vk::UniqueSamplerYcbcrConversion>	samplerYCbCrConversions;
+	mutable ObjectCache<vk::UniqueSampler>			samplers;
+
+	/*
+	 * Background pipeline compilation. Declared after the caches, so 
+	 * that it is stopped before them
+	 */
+
+	mutable std::mutex								failedPipelinesMutex;
+	mutable std::unordered_set<size_t>				failedPipelines;
+	mutable PipelineCompiler						pipelineCompiler;
 
 	/*
 	 * Deferred present
@@ -71,6 +118,13 @@ struct Vulkan::Impl {
 	mutable std::vector<uint32_t>					presentIndices;
 	mutable std::vector<vk::Semaphore>				presentSemaphores;
 
+	/*
+	 * Batched submissions
+	 */
+
+	mutable SubmissionBatcher						submissionBatcher;
+	mutable std::atomic<size_t>						submitCount;
+
 	/*
 	 * User pointers
 	 */
@@ -86,7 +140,8 @@ struct Vulkan::Impl {
 			std::vector<vk::ExtensionProperties> requiredDeviceExtensions,
 			LogCallback logCallback,
 			const PresentationSupportCallback& presentationSupportCbk,
-			const DeviceScoreFunc& scoreFunc )
+			const DeviceScoreFunc& scoreFunc,
+			std::string pipelineCachePath )
 		: logCallback(std::move(logCallback))
 		, loader()
 		, dispatcher(createDispatcher(loader))
@@ -99,10 +154,51 @@ struct Vulkan::Impl {
 		, queues(getQueues(dispatcher, *device, queueIndices))
 		, physicalDeviceProperties(getPhysicalDeviceProperties(dispatcher, physicalDevice))
 		, formatSupport(getFormatSupport(dispatcher, physicalDevice))
-	{
+		, memoryAllocator(dispatcher, *device, physicalDevice.getMemoryProperties(dispatcher), physicalDeviceProperties.limits)
+		, descriptorAllocator(dispatcher, *device)
+		, bindlessDescriptorTable(createBindlessDescriptorTable(dispatcher, physicalDevice, *device, deviceFeatures))
+		, hostMemoryImportAlignment(getHostMemoryImportAlignment(dispatcher, physicalDevice))
+		, pipelineCachePath(std::move(pipelineCachePath))
+		, pipelineCache(createPipelineCache(dispatcher, *device, loadPipelineCacheData(this->pipelineCachePath, physicalDeviceProperties, this->logCallback)))
+		, pipelineCompiler(getPipelineCompilerThreadCount())
+		, submissionBatcher(dispatcher, *device, getTransferQueue(), getGraphicsQueue(), getTimelineSemaphoreSupport())
+		, submitCount(0)
+	{
+	}
+
+	~Impl() {
+		//Let the pipelines being compiled land in the cache before saving it
+		pipelineCompiler.stop();
+
+		//Destructors must not throw, so a failure only loses the cache
+		try {
+			savePipelineCache();
+		} catch(const std::exception& e) {
+			log(Severity::warning, std::string("Could not save the pipeline cache: ") + e.what());
+		}
 	}
 
-	~Impl() = default;
+	void log(Severity severity, std::string msg) const {
+		if(logCallback) {
+			logCallback(severity, std::move(msg));
+		}
+	}
+
+	void compileGraphicsPipeline(size_t id, const GraphicsPipelineFactory& factory) const noexcept {
+		//It may have been finished just before being enqueued again
+		if(graphicsPipelines.find(id)) {
+			return;
+		}
+
+		try {
+			graphicsPipelines.emplace(id, factory());
+		} catch(const std::exception& e) {
+			log(Severity::error, std::string("Background pipeline compilation failed: ") + e.what());
+
+			std::lock_guard<std::mutex> lock(failedPipelinesMutex);
+			failedPipelines.emplace(id);
+		}
+	}
 
 	const vk::DynamicLoader& getLoader() const noexcept {
 		return loader;
@@ -160,6 +256,38 @@ struct Vulkan::Impl {
 		return *pipelineCache;
 	}
 
+	bool savePipelineCache() const {
+		if(pipelineCachePath.empty()) {
+			return false;
+		}
+
+		const auto data = device->getPipelineCacheData(*pipelineCache, dispatcher);
+		const auto header = createPipelineCacheHeader(physicalDeviceProperties, data.size());
+
+		//Write to a temporary file first, so that a crash while writing does 
+		//not leave a truncated cache behind
+		const auto temporaryPath = pipelineCachePath + ".tmp";
+		{
+			std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+			if(!file) {
+				log(Severity::warning, "Could not write the pipeline cache to " + temporaryPath);
+				return false;
+			}
+		}
+
+		if(std::rename(temporaryPath.c_str(), pipelineCachePath.c_str()) != 0) {
+			log(Severity::warning, "Could not write the pipeline cache to " + pipelineCachePath);
+			std::remove(temporaryPath.c_str());
+			return false;
+		}
+
+		log(Severity::verbose, "Saved " + std::to_string(data.size()) + " bytes of pipeline cache to " + pipelineCachePath);
+		return true;
+	}
+
 
 
 	const vk::PhysicalDeviceProperties&	getPhysicalDeviceProperties() const noexcept {
@@ -174,29 +302,42 @@ struct Vulkan::Impl {
 		return deviceFeatures;
 	}
 
+	bool getTimelineSemaphoreSupport() const noexcept {
+		return deviceFeatures.get<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>().timelineSemaphore;
+	}
+
 	const std::vector<vk::Format>& listSupportedFormatsOptimal(vk::FormatFeatureFlags flags) const {
 		const auto id = static_cast<vk::FormatFeatureFlags::MaskType>(flags);
-		auto ite = optimalFormatProperties.find(id);
 
-		if(ite == optimalFormatProperties.cend()) {
-			//This flags where not tested before
-			std::vector<vk::Format> result;
-
-			for(const auto& feature : getFormatSupport()) {
-				//Test if all the flags are set to '1'
-				if((feature.second.optimalTilingFeatures & flags) == flags) {
-					result.push_back(feature.first);
-				}
+		{
+			std::shared_lock<std::shared_mutex> lock(formatPropertiesMutex);
+			const auto ite = optimalFormatProperties.find(id);
+			if(ite != optimalFormatProperties.cend()) {
+				return ite->second;
 			}
+		}
 
-			//Sort in order to use binary search if needed
-			std::sort(result.begin(), result.end());
-			std::tie(ite, std::ignore) = optimalFormatProperties.emplace(
-				id,
-				std::move(result)
-			);
+		//This flags where not tested before
+		std::vector<vk::Format> result;
+
+		for(const auto& feature : getFormatSupport()) {
+			//Test if all the flags are set to '1'
+			if((feature.second.optimalTilingFeatures & flags) == flags) {
+				result.push_back(feature.first);
+			}
 		}
 
+		//Sort in order to use binary search if needed
+		std::sort(result.begin(), result.end());
+
+		//References to the elements of an unordered_map remain valid on insertion
+		std::unique_lock<std::shared_mutex> lock(formatPropertiesMutex);
+		const auto [ite, inserted] = optimalFormatProperties.emplace(
+			id,
+			std::move(result)
+		);
+		(void)inserted; //May have been inserted concurrently
+
 		assert(ite != optimalFormatProperties.cend());
 		assert(std::is_sorted(ite->second.cbegin(), ite->second.cend()));
 		return ite->second;
@@ -204,27 +345,36 @@ struct Vulkan::Impl {
 
 	const std::vector<vk::Format>& listSupportedFormatsLinear(vk::FormatFeatureFlags flags) const {
 		const auto id = static_cast<vk::FormatFeatureFlags::MaskType>(flags);
-		auto ite = linearFormatProperties.find(id);
-
-		if(ite == linearFormatProperties.cend()) {
-			//This flags where not tested before
-			std::vector<vk::Format> result;
 
-			for(const auto& feature : getFormatSupport()) {
-				//Test if all the flags are set to '1'
-				if((feature.second.linearTilingFeatures & flags) == flags) {
-					result.push_back(feature.first);
-				}
+		{
+			std::shared_lock<std::shared_mutex> lock(formatPropertiesMutex);
+			const auto ite = linearFormatProperties.find(id);
+			if(ite != linearFormatProperties.cend()) {
+				return ite->second;
 			}
+		}
 
-			//Sort in order to use binary search if needed
-			std::sort(result.begin(), result.end());
-			std::tie(ite, std::ignore) = linearFormatProperties.emplace(
-				id,
-				std::move(result)
-			);
+		//This flags where not tested before
+		std::vector<vk::Format> result;
+
+		for(const auto& feature : getFormatSupport()) {
+			//Test if all the flags are set to '1'
+			if((feature.second.linearTilingFeatures & flags) == flags) {
+				result.push_back(feature.first);
+			}
 		}
 
+		//Sort in order to use binary search if needed
+		std::sort(result.begin(), result.end());
+
+		//References to the elements of an unordered_map remain valid on insertion
+		std::unique_lock<std::shared_mutex> lock(formatPropertiesMutex);
+		const auto [ite, inserted] = linearFormatProperties.emplace(
+			id,
+			std::move(result)
+		);
+		(void)inserted; //May have been inserted concurrently
+
 		assert(ite != linearFormatProperties.cend());
 		assert(std::is_sorted(ite->second.cbegin(), ite->second.cend()));
 		return ite->second;
@@ -275,6 +425,19 @@ struct Vulkan::Impl {
 		return device->createSemaphoreUnique(createInfo, nullptr, dispatcher);
 	}
 
+	vk::UniqueSemaphore createTimelineSemaphore(uint64_t initialValue) const {
+		//It is a extension so support should have been checked before calling
+		assert(getTimelineSemaphoreSupport());
+
+		const vk::SemaphoreTypeCreateInfoKHR typeCreateInfo(
+			vk::SemaphoreTypeKHR::eTimeline,							//Semaphore type
+			initialValue												//Initial value
+		);
+
+		const auto createInfo = vk::SemaphoreCreateInfo().setPNext(&typeCreateInfo);
+		return device->createSemaphoreUnique(createInfo, nullptr, dispatcher);
+	}
+
 	vk::UniqueFence createFence(bool signaled) const {
 		const vk::FenceCreateInfo createInfo(
 			signaled ? vk::FenceCreateFlags(vk::FenceCreateFlagBits::eSignaled) : vk::FenceCreateFlags()
@@ -288,21 +451,14 @@ struct Vulkan::Impl {
 	}
 
 	vk::RenderPass createRenderPass(size_t id) const {
-		auto ite = renderPasses.find(id);
-		return ite != renderPasses.cend() ? *(ite->second) : vk::RenderPass();
+		return renderPasses.find(id);
 	}
 
 	vk::RenderPass createRenderPass(size_t id,
 									const vk::RenderPassCreateInfo& createInfo ) const
 	{
-		auto [ite, result] = renderPasses.emplace(
-			id,
-			createRenderPass(createInfo)
-		);
-
-		assert(result);
-		assert(ite != renderPasses.cend());
-		return *(ite->second);
+		//Create it without holding any lock, as it might take a while
+		return renderPasses.emplace(id, createRenderPass(createInfo));
 	}
 
 	vk::UniqueShaderModule createShaderModule(Utils::BufferView<const uint32_t> code) const
@@ -316,21 +472,14 @@ struct Vulkan::Impl {
 	}
 
 	vk::ShaderModule createShaderModule(size_t id) const {
-		auto ite = shaders.find(id);
-		return ite != shaders.cend() ? *(ite->second) : vk::ShaderModule();
+		return shaders.find(id);
 	}
 
 	vk::ShaderModule createShaderModule(size_t id, 
 										Utils::BufferView<const uint32_t> code ) const
 	{
-		auto [ite, result] = shaders.emplace(
-			id,
-			createShaderModule(code)
-		);
-
-		assert(result);
-		assert(ite != shaders.cend());
-		return *(ite->second);
+		//Create it without holding any lock, as it might take a while
+		return shaders.emplace(id, createShaderModule(code));
 	}
 
 	vk::UniquePipelineLayout createPipelineLayout(const vk::PipelineLayoutCreateInfo& createInfo) const {
@@ -338,21 +487,14 @@ struct Vulkan::Impl {
 	}
 
 	vk::PipelineLayout createPipelineLayout(size_t id) const {
-		auto ite = pipelineLayouts.find(id);
-		return ite != pipelineLayouts.cend() ? *(ite->second) : vk::PipelineLayout();
+		return pipelineLayouts.find(id);
 	}
 
 	vk::PipelineLayout createPipelineLayout(size_t id, 
 											const vk::PipelineLayoutCreateInfo& createInfo ) const
 	{
-		auto [ite, result] = pipelineLayouts.emplace(
-			id,
-			createPipelineLayout(createInfo)
-		);
-
-		assert(result);
-		assert(ite != pipelineLayouts.cend());
-		return *(ite->second);
+		//Create it without holding any lock, as it might take a while
+		return pipelineLayouts.emplace(id, createPipelineLayout(createInfo));
 	}
 
 	vk::UniquePipeline createGraphicsPipeline(const vk::GraphicsPipelineCreateInfo& createInfo) const 
@@ -362,21 +504,47 @@ struct Vulkan::Impl {
 	}
 
 	vk::Pipeline createGraphicsPipeline(size_t id) const {
-		auto ite = graphicsPipelines.find(id);
-		return ite != graphicsPipelines.cend() ? *(ite->second) : vk::Pipeline();
+		return graphicsPipelines.find(id);
 	}
 
 	vk::Pipeline createGraphicsPipeline(size_t id,
 										const vk::GraphicsPipelineCreateInfo& createInfo ) const
 	{
-		auto [ite, result] = graphicsPipelines.emplace(
-			id,
-			createGraphicsPipeline(createInfo)
-		);
+		//Create it without holding any lock, as it might take a while
+		return graphicsPipelines.emplace(id, createGraphicsPipeline(createInfo));
+	}
+
+	vk::Pipeline createGraphicsPipelineAsync(	size_t id,
+												GraphicsPipelineFactory factory ) const
+	{
+		auto result = graphicsPipelines.find(id);
+
+		if(!result) {
+			bool hasFailed;
+			{
+				std::lock_guard<std::mutex> lock(failedPipelinesMutex);
+				hasFailed = failedPipelines.count(id) > 0;
+			}
 
-		assert(result);
-		assert(ite != graphicsPipelines.cend());
-		return *(ite->second);
+			if(hasFailed) {
+				//Compile it here, so that the caller gets the exception
+				result = graphicsPipelines.emplace(id, factory());
+			} else {
+				//Nothing happens if it is already pending
+				pipelineCompiler.enqueue(
+					id,
+					[this, id, factory = std::move(factory)] {
+						compileGraphicsPipeline(id, factory);
+					}
+				);
+			}
+		}
+
+		return result;
+	}
+
+	size_t getPendingPipelineCount() const noexcept {
+		return pipelineCompiler.getPendingCount();
 	}
 
 	vk::UniqueDescriptorSetLayout createDescriptorSetLayout(const vk::DescriptorSetLayoutCreateInfo& createInfo) const {
@@ -384,21 +552,14 @@ struct Vulkan::Impl {
 	}
 
 	vk::DescriptorSetLayout createDescriptorSetLayout(size_t id) const {
-		auto ite = descriptorSetLayouts.find(id);
-		return ite != descriptorSetLayouts.cend() ? *(ite->second) : vk::DescriptorSetLayout();
+		return descriptorSetLayouts.find(id);
 	}
 
 	vk::DescriptorSetLayout createDescriptorSetLayout(	size_t id, 
 														const vk::DescriptorSetLayoutCreateInfo& createInfo ) const
 	{
-		auto [ite, result] = descriptorSetLayouts.emplace(
-			id,
-			createDescriptorSetLayout(createInfo)
-		);
-
-		assert(result);
-		assert(ite != descriptorSetLayouts.cend());
-		return *(ite->second);
+		//Create it without holding any lock, as it might take a while
+		return descriptorSetLayouts.emplace(id, createDescriptorSetLayout(createInfo));
 	}
 
 	vk::UniqueSamplerYcbcrConversion createSamplerYcbcrConversion(const vk::SamplerYcbcrConversionCreateInfo& createInfo) const {
@@ -413,21 +574,14 @@ struct Vulkan::Impl {
 	}
 
 	vk::SamplerYcbcrConversion createSamplerYcbcrConversion(size_t id) const {
-		auto ite = samplerYCbCrConversions.find(id);
-		return ite != samplerYCbCrConversions.cend() ? *(ite->second) : vk::SamplerYcbcrConversion();
+		return samplerYCbCrConversions.find(id);
 	}
 
 	vk::SamplerYcbcrConversion createSamplerYcbcrConversion(	size_t id,
 																const vk::SamplerYcbcrConversionCreateInfo& createInfo ) const 
 	{
-		auto [ite, result] = samplerYCbCrConversions.emplace(
-			id,
-			createSamplerYcbcrConversion(createInfo)
-		);
-
-		assert(result);
-		assert(ite != samplerYCbCrConversions.cend());
-		return *(ite->second);
+		//Create it without holding any lock, as it might take a while
+		return samplerYCbCrConversions.emplace(id, createSamplerYcbcrConversion(createInfo));
 	}
 
 	vk::UniqueSampler createSampler(const vk::SamplerCreateInfo& createInfo) const {
@@ -435,21 +589,14 @@ struct Vulkan::Impl {
 	}
 
 	vk::Sampler createSampler(size_t id) const {
-		auto ite = samplers.find(id);
-		return ite != samplers.cend() ? *(ite->second) : vk::Sampler();
+		return samplers.find(id);
 	}
 
 	vk::Sampler createSampler(	size_t id,
 								const vk::SamplerCreateInfo& createInfo ) const 
 	{
-		auto [ite, result] = samplers.emplace(
-			id,
-			createSampler(createInfo)
-		);
-
-		assert(result);
-		assert(ite != samplers.cend());
-		return *(ite->second);
+		//Create it without holding any lock, as it might take a while
+		return samplers.emplace(id, createSampler(createInfo));
 	}
 
 
@@ -495,10 +642,10 @@ struct Vulkan::Impl {
 		return device->allocateMemoryUnique(allocInfo, nullptr, dispatcher);
 	}
 
-	vk::UniqueDeviceMemory allocateMemory(	const vk::MemoryRequirements& requirements,
-											vk::MemoryPropertyFlags properties ) const
+	Allocation allocateMemory(	const vk::MemoryRequirements& requirements,
+								vk::MemoryPropertyFlags properties,
+								vk::ImageTiling tiling ) const
 	{
-		vk::UniqueDeviceMemory result;
 		const auto memoryProperties = physicalDevice.getMemoryProperties(dispatcher);
 
 		//Find an apropiate index for the type
@@ -514,38 +661,24 @@ struct Vulkan::Impl {
 		}
 
 		if(i < memoryProperties.memoryTypeCount){
-			size_t size = requirements.size;
-
-			if(properties | vk::MemoryPropertyFlagBits::eHostVisible) {
-				//As it is host visible, align it to the non-coherent atom size
-				const auto nonCoherentAtomSize = getPhysicalDeviceProperties().limits.nonCoherentAtomSize;
-				size = Utils::align(requirements.size, nonCoherentAtomSize);
-			}
-
-			//Found a suitable memory type
-			const vk::MemoryAllocateInfo allocInfo(
-				size,									//Size
-				i										//Memory type index
-			);
-
-			result = allocateMemory(allocInfo);
+			//Found a suitable memory type. The allocator takes care of the non-coherent atom size
+			return memoryAllocator.allocate(requirements, i, tiling);
 		} else {
 			//Did not find any suitable memory
 			if(properties & vk::MemoryPropertyFlagBits::eLazilyAllocated) {
 				//Try to allocate without the lazy allocation bit
 				constexpr vk::MemoryPropertyFlags MASK = ~vk::MemoryPropertyFlagBits::eLazilyAllocated;
-				result = allocateMemory(requirements, properties & MASK);
+				return allocateMemory(requirements, properties & MASK, tiling);
 			} else {
 				//No solution :-<
 				throw Exception("Error allocating device memory");
 			}
 		}
-
-		return result;
 	}
 
 	AggregatedAllocation allocateMemory(Utils::BufferView<const vk::MemoryRequirements> requirements,
-										vk::MemoryPropertyFlags properties ) const
+										vk::MemoryPropertyFlags properties,
+										vk::ImageTiling tiling ) const
 	{
 		AggregatedAllocation result;
 		vk::MemoryRequirements combinedRequirements(0, 1, ~(0U)); //Size, aligment, flags
@@ -565,10 +698,74 @@ struct Vulkan::Impl {
 			combinedRequirements.alignment = std::max(combinedRequirements.alignment, requirements[i].alignment); //Restrict the alignment
 		}
 
-		result.memory = allocateMemory(combinedRequirements, properties);
+		result.memory = allocateMemory(combinedRequirements, properties, tiling);
 		return result;
 	}
 
+	std::vector<MemoryStatistics> getMemoryStatistics() const {
+		return memoryAllocator.getStatistics();
+	}
+
+	size_t trimMemory() const {
+		return memoryAllocator.trim();
+	}
+
+	size_t getHostMemoryImportAlignment() const noexcept {
+		return hostMemoryImportAlignment;
+	}
+
+	vk::UniqueDeviceMemory importHostMemory(Utils::BufferView<std::byte> memory,
+											uint32_t memoryTypeBits,
+											vk::MemoryPropertyFlags properties ) const
+	{
+		constexpr auto handleType = vk::ExternalMemoryHandleTypeFlagBits::eHostAllocationEXT;
+
+		if(!hostMemoryImportAlignment) {
+			throw Exception("Host memory import is not supported");
+		}
+
+		assert(reinterpret_cast<uintptr_t>(memory.data()) % hostMemoryImportAlignment == 0);
+		assert(memory.size() % hostMemoryImportAlignment == 0);
+
+		//Query which memory types may be used for this pointer
+		const auto hostPointerProperties = device->getMemoryHostPointerPropertiesEXT(
+			handleType, 
+			memory.data(), 
+			dispatcher
+		);
+		memoryTypeBits &= hostPointerProperties.memoryTypeBits;
+
+		//Find an apropiate index for the type
+		const auto memoryProperties = physicalDevice.getMemoryProperties(dispatcher);
+		uint32_t i;
+		for (i = 0; i < memoryProperties.memoryTypeCount; i++) {
+			const uint32_t indexFlag = 1 << i;
+
+			if(	(memoryTypeBits & indexFlag) && 
+				(memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) 
+			{
+				break; //Found one!
+			}
+		}
+
+		if(i >= memoryProperties.memoryTypeCount) {
+			throw Exception("Error importing host memory");
+		}
+
+		const vk::StructureChain<vk::MemoryAllocateInfo, vk::ImportMemoryHostPointerInfoEXT> allocInfo(
+			vk::MemoryAllocateInfo(
+				memory.size(),										//Size
+				i													//Memory type index
+			),
+			vk::ImportMemoryHostPointerInfoEXT(
+				handleType,											//Handle type
+				memory.data()										//Host pointer
+			)
+		);
+
+		return allocateMemory(allocInfo.get());
+	}
+
 
 
 	std::vector<vk::UniqueDescriptorSet> allocateDescriptorSets(const vk::DescriptorSetAllocateInfo& allocInfo) const {
@@ -600,6 +797,38 @@ struct Vulkan::Impl {
 		);
 	}
 
+	PooledDescriptorSet allocateDescriptorSet(	vk::DescriptorSetLayout layout,
+												Utils::BufferView<const vk::DescriptorPoolSize> setSizes ) const
+	{
+		return descriptorAllocator.allocate(layout, setSizes);
+	}
+
+	size_t getCreatedDescriptorPoolCount() const noexcept {
+		return descriptorAllocator.getCreatedPoolCount();
+	}
+
+	bool getBindlessSupport() const noexcept {
+		return static_cast<bool>(bindlessDescriptorTable);
+	}
+
+	vk::DescriptorSetLayout getBindlessDescriptorSetLayout() const noexcept {
+		return bindlessDescriptorTable ? bindlessDescriptorTable->getDescriptorSetLayout() : vk::DescriptorSetLayout();
+	}
+
+	vk::DescriptorSet getBindlessDescriptorSet() const noexcept {
+		return bindlessDescriptorTable ? bindlessDescriptorTable->getDescriptorSet() : vk::DescriptorSet();
+	}
+
+	BindlessSlot allocateBindlessSlot(	vk::ImageView imageView,
+										vk::Sampler sampler ) const
+	{
+		if(!bindlessDescriptorTable) {
+			throw Exception("Bindless mode is not supported");
+		}
+
+		return bindlessDescriptorTable->allocate(imageView, sampler);
+	}
+
 
 
 	vk::MemoryRequirements getMemoryRequirements(vk::Buffer buf) const {
@@ -674,6 +903,12 @@ struct Vulkan::Impl {
 
 
 	std::byte* mapMemory(const vk::MappedMemoryRange& range) const{
+		//Sub-allocated memory is persistently mapped by the allocator
+		auto* const blockMapping = memoryAllocator.map(range.memory);
+		if(blockMapping) {
+			return blockMapping + range.offset;
+		}
+
 		return static_cast<std::byte*>(device->mapMemory(
 			range.memory,												//Memory allocation
 			range.offset,												//Offset
@@ -744,6 +979,27 @@ struct Vulkan::Impl {
 		);
 	}
 
+	bool waitSemaphore(	vk::Semaphore semaphore,
+						uint64_t value,
+						uint64_t timeout ) const
+	{
+		const vk::SemaphoreWaitInfoKHR waitInfo(
+			{},															//Flags
+			1, &semaphore,												//Semaphores
+			&value														//Values
+		);
+
+		return vk::Result::eSuccess == device->waitSemaphoresKHR(
+			waitInfo,													//Wait info
+			timeout,													//Timeout
+			dispatcher													//Dispatcher
+		);
+	}
+
+	uint64_t getSemaphoreCounterValue(vk::Semaphore semaphore) const {
+		return device->getSemaphoreCounterValueKHR(semaphore, dispatcher);
+	}
+
 	void resetFences(Utils::BufferView<const vk::Fence> fences) const { 
 		using FenceArray = vk::ArrayProxy<const vk::Fence>;
 
@@ -760,11 +1016,45 @@ struct Vulkan::Impl {
 	{
 		using SubInfoArray = vk::ArrayProxy<const vk::SubmitInfo>;
 
+		//Send the pending batch first, so that direct submissions
+		//are ordered after it
+		submissionBatcher.flush();
+
 		queue.submit(
 			SubInfoArray(subInfo.size(), subInfo.data()),	//Submit infos
 			fence,											//Fence
 			dispatcher										//Dispatcher
 		);
+
+		++submitCount;
+	}
+
+	uint64_t submitTransferBatched(Utils::BufferView<const vk::CommandBuffer> cmds) const {
+		return submissionBatcher.enqueueTransfer(cmds);
+	}
+
+	uint64_t submitGraphicsBatched(	Utils::BufferView<const vk::CommandBuffer> cmds,
+									bool waitTransfer ) const
+	{
+		return submissionBatcher.enqueueGraphics(cmds, waitTransfer);
+	}
+
+	bool waitBatch(	uint64_t batch,
+					uint64_t timeout ) const
+	{
+		return submissionBatcher.wait(batch, timeout);
+	}
+
+	void submitAll() const {
+		submissionBatcher.flush();
+	}
+
+	uint64_t getPendingBatch() const noexcept {
+		return submissionBatcher.getPendingBatch();
+	}
+
+	size_t getSubmitCount() const noexcept {
+		return submitCount.load() + submissionBatcher.getSubmitCount();
 	}
 
 
@@ -1000,6 +1290,21 @@ struct Vulkan::Impl {
 		);
 	}
 
+	void pushConstants(	vk::CommandBuffer cmd,
+						vk::PipelineLayout layout,
+						vk::ShaderStageFlags stages,
+						uint32_t offset,
+						Utils::BufferView<const std::byte> data ) const noexcept
+	{
+		cmd.pushConstants(
+			layout,
+			stages,
+			offset,
+			data.size(), data.data(),
+			dispatcher
+		);
+	}
+
 	void setViewport(	vk::CommandBuffer cmd,
 						uint32_t first,
 						Utils::BufferView<const vk::Viewport> viewports ) const noexcept
@@ -1297,7 +1602,7 @@ private:
 		//Add the queue families
 		queues[GRAPHICS_QUEUE] = getQueueFamilyIndex(queueFamilies, vk::QueueFlagBits::eGraphics);
 		queues[COMPUTE_QUEUE] = getQueueFamilyIndex(queueFamilies, vk::QueueFlagBits::eCompute);
-		queues[TRANSFER_QUEUE] = getQueueFamilyIndex(queueFamilies, vk::QueueFlagBits::eTransfer);
+		queues[TRANSFER_QUEUE] = getTransferQueueFamilyIndex(queueFamilies);
 
 		//Find a queue family compatible with presentation
 		const auto presentFamilies = getPresentationQueueFamilies(inst, dev, queueFamilies.size(), presentationSupportCbk);
@@ -1333,6 +1638,97 @@ private:
 			result.get<vk::PhysicalDeviceSamplerYcbcrConversionFeatures>().samplerYcbcrConversion = true;
 		}
 
+		//Add the descriptor indexing features required for the bindless mode if possible
+		if(isBindlessSupported(supported)) {
+			auto& descriptorIndexing = result.get<vk::PhysicalDeviceDescriptorIndexingFeaturesEXT>();
+			descriptorIndexing.shaderSampledImageArrayNonUniformIndexing = true;
+			descriptorIndexing.descriptorBindingSampledImageUpdateAfterBind = true;
+			descriptorIndexing.descriptorBindingUpdateUnusedWhilePending = true;
+			descriptorIndexing.descriptorBindingPartiallyBound = true;
+			descriptorIndexing.runtimeDescriptorArray = true;
+		}
+
+		//Add the timeline semaphore feature if possible
+		if(supported.get<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>().timelineSemaphore) {
+			result.get<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>().timelineSemaphore = true;
+		}
+
+		return result;
+	}
+
+	static bool isBindlessSupported(const DeviceFeatures& features) noexcept {
+		const auto& descriptorIndexing = features.get<vk::PhysicalDeviceDescriptorIndexingFeaturesEXT>();
+
+		return	descriptorIndexing.shaderSampledImageArrayNonUniformIndexing &&
+				descriptorIndexing.descriptorBindingSampledImageUpdateAfterBind &&
+				descriptorIndexing.descriptorBindingUpdateUnusedWhilePending &&
+				descriptorIndexing.descriptorBindingPartiallyBound &&
+				descriptorIndexing.runtimeDescriptorArray ;
+	}
+
+	static size_t getHostMemoryImportAlignment(	const vk::DispatchLoaderDynamic& disp,
+												vk::PhysicalDevice physicalDevice )
+	{
+		size_t result = 0;
+
+		//The extension is only enabled when supported
+		const auto extensions = physicalDevice.enumerateDeviceExtensionProperties(nullptr, disp);
+		const auto externalMemoryHostSupported = std::find_if(
+			extensions.cbegin(), extensions.cend(),
+			[] (const vk::ExtensionProperties& ext) -> bool {
+				return !std::strncmp(
+					VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME, 
+					ext.extensionName.data(), 
+					ext.extensionName.size()
+				);
+			}
+		);
+
+		if(externalMemoryHostSupported != extensions.cend()) {
+			vk::StructureChain<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceExternalMemoryHostPropertiesEXT> properties;
+			if(disp.vkGetPhysicalDeviceProperties2) {
+				physicalDevice.getProperties2(&properties.get(), disp);
+			} else if(disp.vkGetPhysicalDeviceProperties2KHR) {
+				physicalDevice.getProperties2KHR(&properties.get(), disp);
+			}
+
+			result = properties.get<vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>().minImportedHostPointerAlignment;
+		}
+
+		return result;
+	}
+
+	static std::unique_ptr<BindlessDescriptorTable> createBindlessDescriptorTable(	const vk::DispatchLoaderDynamic& disp,
+																					vk::PhysicalDevice physicalDevice,
+																					vk::Device device,
+																					const DeviceFeatures& features )
+	{
+		constexpr uint32_t MAX_CAPACITY = 1U << 14;
+		std::unique_ptr<BindlessDescriptorTable> result;
+
+		if(isBindlessSupported(features)) {
+			//Features are only enabled when the properties can be queried
+			vk::StructureChain<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDescriptorIndexingPropertiesEXT> properties;
+			if(disp.vkGetPhysicalDeviceProperties2) {
+				physicalDevice.getProperties2(&properties.get(), disp);
+			} else {
+				assert(disp.vkGetPhysicalDeviceProperties2KHR);
+				physicalDevice.getProperties2KHR(&properties.get(), disp);
+			}
+
+			//Combined image samplers count both as samplers and sampled images
+			const auto& limits = properties.get<vk::PhysicalDeviceDescriptorIndexingPropertiesEXT>();
+			const auto capacity = std::min({
+				MAX_CAPACITY,
+				limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+				limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+				limits.maxDescriptorSetUpdateAfterBindSamplers,
+				limits.maxDescriptorSetUpdateAfterBindSampledImages
+			});
+
+			result = std::make_unique<BindlessDescriptorTable>(disp, device, capacity);
+		}
+
 		return result;
 	}
 
@@ -1397,17 +1793,96 @@ private:
 		return queues;
 	}
 
+	static size_t getPipelineCompilerThreadCount() noexcept {
+		//Leave most of the cores for rendering
+		constexpr size_t CORES_PER_THREAD = 4;
+		return std::max(static_cast<size_t>(std::thread::hardware_concurrency()) / CORES_PER_THREAD, size_t(1));
+	}
+
 	static vk::UniquePipelineCache createPipelineCache(	const vk::DispatchLoaderDynamic& disp, 
-														vk::Device device )
+														vk::Device device,
+														const std::vector<uint8_t>& initialData )
 	{
 		const vk::PipelineCacheCreateInfo createInfo(
 			{},															//Flags
-			0, nullptr													//Data
+			initialData.size(), initialData.data()						//Data
 		);
 
 		return device.createPipelineCacheUnique(createInfo, nullptr, disp);
 	}
 
+	static PipelineCacheHeader createPipelineCacheHeader(	const vk::PhysicalDeviceProperties& properties,
+															size_t dataSize ) noexcept
+	{
+		PipelineCacheHeader result = {};
+
+		result.magic = PIPELINE_CACHE_MAGIC;
+		result.headerVersion = PIPELINE_CACHE_HEADER_VERSION;
+		result.vendorID = properties.vendorID;
+		result.deviceID = properties.deviceID;
+		result.driverVersion = properties.driverVersion;
+		std::memcpy(result.pipelineCacheUUID.data(), &properties.pipelineCacheUUID[0], result.pipelineCacheUUID.size());
+		result.dataSize = dataSize;
+
+		return result;
+	}
+
+	static std::vector<uint8_t> loadPipelineCacheData(	const std::string& path,
+														const vk::PhysicalDeviceProperties& properties,
+														const LogCallback& logCbk )
+	{
+		std::vector<uint8_t> result;
+
+		if(!path.empty()) {
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+			if(file) {
+				const size_t fileSize = file.tellg();
+				file.seekg(0);
+
+				//Only accept caches written by the same device and driver. Although the 
+				//implementation should validate it as well, some drivers misbehave 
+				//when given caches from other versions
+				PipelineCacheHeader header = {};
+				file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+				//Files shorter than the header leave it partially read
+				if(file) {
+					const auto expected = createPipelineCacheHeader(properties, header.dataSize);
+
+					const bool isValid = 
+						fileSize == sizeof(header) + header.dataSize &&
+						header.magic == expected.magic &&
+						header.headerVersion == expected.headerVersion &&
+						header.vendorID == expected.vendorID &&
+						header.deviceID == expected.deviceID &&
+						header.driverVersion == expected.driverVersion &&
+						header.pipelineCacheUUID == expected.pipelineCacheUUID;
+
+					if(isValid) {
+						result.resize(header.dataSize);
+						file.read(reinterpret_cast<char*>(result.data()), result.size());
+
+						if(!file) {
+							result.clear(); //Truncated
+						}
+					}
+				}
+
+				if(logCbk) {
+					logCbk(
+						result.empty() ? Severity::warning : Severity::verbose,
+						result.empty() ? 
+						"Discarding invalid or outdated pipeline cache at " + path :
+						"Loaded " + std::to_string(result.size()) + " bytes of pipeline cache from " + path
+					);
+				}
+			}
+		}
+
+		return result;
+	}
+
 	static FormatSupport getFormatSupport(	const vk::DispatchLoaderDynamic& disp, 
 											vk::PhysicalDevice physicalDevice )
 	{
@@ -1499,6 +1974,55 @@ private:
 			extensions.push_back(*cubicFilterSupported);
 		}
 
+		//Add descriptor indexing extension if possible. Used for the bindless mode
+		const auto descriptorIndexingSupported = std::find_if(
+			supported.cbegin(), supported.cend(),
+			[] (const vk::ExtensionProperties& ext) -> bool {
+				return !std::strncmp(
+					VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, 
+					ext.extensionName.data(), 
+					ext.extensionName.size()
+				);
+			}
+		);
+		if(descriptorIndexingSupported != supported.cend()) {
+			//Descriptor indexing depends on maintenance3
+			extensions.emplace_back(std::array<char, VK_MAX_EXTENSION_NAME_SIZE>{VK_KHR_MAINTENANCE3_EXTENSION_NAME});
+			extensions.push_back(*descriptorIndexingSupported);
+		}
+
+		//Add timeline semaphore extension if possible
+		const auto timelineSemaphoreSupported = std::find_if(
+			supported.cbegin(), supported.cend(),
+			[] (const vk::ExtensionProperties& ext) -> bool {
+				return !std::strncmp(
+					VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, 
+					ext.extensionName.data(), 
+					ext.extensionName.size()
+				);
+			}
+		);
+		if(timelineSemaphoreSupported != supported.cend()) {
+			extensions.push_back(*timelineSemaphoreSupported);
+		}
+
+		//Add external host memory extension if possible. Used for zero-copy uploads
+		const auto externalMemoryHostSupported = std::find_if(
+			supported.cbegin(), supported.cend(),
+			[] (const vk::ExtensionProperties& ext) -> bool {
+				return !std::strncmp(
+					VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME, 
+					ext.extensionName.data(), 
+					ext.extensionName.size()
+				);
+			}
+		);
+		if(externalMemoryHostSupported != supported.cend()) {
+			//External host memory depends on external memory
+			extensions.emplace_back(std::array<char, VK_MAX_EXTENSION_NAME_SIZE>{VK_KHR_EXTERNAL_MEMORY_EXTENSION_NAME});
+			extensions.push_back(*externalMemoryHostSupported);
+		}
+
 		removeDuplicated(extensions);
 		return extensions;
 	}
@@ -1669,6 +2193,26 @@ private:
 		return queueFamilies;
 	}
 
+	static size_t getTransferQueueFamilyIndex(const std::vector<vk::QueueFamilyProperties>& qf) {
+		//Prefer a dedicated transfer queue family (usually backed by DMA engines),
+		//so that uploads can overlap with rendering
+		constexpr vk::QueueFlags OTHER_FLAGS = 
+			vk::QueueFlagBits::eGraphics | 
+			vk::QueueFlagBits::eCompute ;
+
+		for(size_t i = 0; i < qf.size(); i++){
+			if(	(qf[i].queueFlags & vk::QueueFlagBits::eTransfer) && 
+				!(qf[i].queueFlags & OTHER_FLAGS) && 
+				qf[i].queueCount > 0 ) 
+			{
+				return i;
+			}
+		}
+
+		//No dedicated family, use any of them
+		return getQueueFamilyIndex(qf, vk::QueueFlagBits::eTransfer);
+	}
+
 	static size_t getQueueFamilyIndex(const std::vector<vk::QueueFamilyProperties>& qf, vk::QueueFlags flags) {
 		size_t i;
 
@@ -1763,7 +2307,8 @@ Vulkan::Vulkan(	const std::string& appName,
 				std::vector<vk::ExtensionProperties> requiredDeviceExtensions,
 				LogCallback logCallback,
 				const PresentationSupportCallback& presentationSupportCbk,
-				const DeviceScoreFunc& scoreFunc )
+				const DeviceScoreFunc& scoreFunc,
+				std::string pipelineCachePath )
 	: m_impl(
 		{}, 
 		appName, 
@@ -1773,7 +2318,8 @@ Vulkan::Vulkan(	const std::string& appName,
 		std::move(requiredDeviceExtensions),
 		std::move(logCallback), 
 		presentationSupportCbk,
-		scoreFunc )
+		scoreFunc,
+		std::move(pipelineCachePath) )
 {
 }
 
@@ -1841,6 +2387,10 @@ vk::PipelineCache Vulkan::getPipelineCache() const noexcept {
 	return m_impl->getPipelineCache();
 }
 
+bool Vulkan::savePipelineCache() const {
+	return m_impl->savePipelineCache();
+}
+
 
 
 const vk::PhysicalDeviceProperties&	Vulkan::getPhysicalDeviceProperties() const noexcept { 
@@ -1855,6 +2405,10 @@ const Vulkan::DeviceFeatures& Vulkan::getDeviceFeatures() const noexcept {
 	return m_impl->getDeviceFeatures();
 }
 
+bool Vulkan::getTimelineSemaphoreSupport() const noexcept {
+	return m_impl->getTimelineSemaphoreSupport();
+}
+
 const std::vector<vk::Format>& Vulkan::listSupportedFormatsOptimal(vk::FormatFeatureFlags flags) const {
 	return m_impl->listSupportedFormatsOptimal(flags);
 }
@@ -1897,6 +2451,10 @@ vk::UniqueSemaphore Vulkan::createSemaphore() const {
 	return m_impl->createSemaphore();
 }
 
+vk::UniqueSemaphore Vulkan::createTimelineSemaphore(uint64_t initialValue) const {
+	return m_impl->createTimelineSemaphore(initialValue);
+}
+
 vk::UniqueFence Vulkan::createFence(bool signaled) const {
 	return m_impl->createFence(signaled);
 }
@@ -1958,6 +2516,16 @@ vk::Pipeline Vulkan::createGraphicsPipeline(size_t id,
 	return m_impl->createGraphicsPipeline(id, createInfo);
 }
 
+vk::Pipeline Vulkan::createGraphicsPipelineAsync(	size_t id,
+													GraphicsPipelineFactory factory ) const
+{
+	return m_impl->createGraphicsPipelineAsync(id, std::move(factory));
+}
+
+size_t Vulkan::getPendingPipelineCount() const noexcept {
+	return m_impl->getPendingPipelineCount();
+}
+
 vk::UniqueDescriptorSetLayout Vulkan::createDescriptorSetLayout(const vk::DescriptorSetLayoutCreateInfo& createInfo) const {
 	return m_impl->createDescriptorSetLayout(createInfo);
 }
@@ -2023,16 +2591,37 @@ vk::UniqueDeviceMemory Vulkan::allocateMemory(const vk::MemoryAllocateInfo& allo
 	return m_impl->allocateMemory(allocInfo);
 }
 
-vk::UniqueDeviceMemory Vulkan::allocateMemory(	const vk::MemoryRequirements& requirements,
-												vk::MemoryPropertyFlags properties ) const
+Vulkan::Allocation Vulkan::allocateMemory(	const vk::MemoryRequirements& requirements,
+											vk::MemoryPropertyFlags properties,
+											vk::ImageTiling tiling ) const
 {
-	return m_impl->allocateMemory(requirements, properties);
+	return m_impl->allocateMemory(requirements, properties, tiling);
 }
 
 Vulkan::AggregatedAllocation Vulkan::allocateMemory(Utils::BufferView<const vk::MemoryRequirements> requirements,
-													vk::MemoryPropertyFlags properties ) const
+													vk::MemoryPropertyFlags properties,
+													vk::ImageTiling tiling ) const
+{
+	return m_impl->allocateMemory(requirements, properties, tiling);
+}
+
+std::vector<Vulkan::MemoryStatistics> Vulkan::getMemoryStatistics() const {
+	return m_impl->getMemoryStatistics();
+}
+
+size_t Vulkan::trimMemory() const {
+	return m_impl->trimMemory();
+}
+
+size_t Vulkan::getHostMemoryImportAlignment() const noexcept {
+	return m_impl->getHostMemoryImportAlignment();
+}
+
+vk::UniqueDeviceMemory Vulkan::importHostMemory(Utils::BufferView<std::byte> memory,
+												uint32_t memoryTypeBits,
+												vk::MemoryPropertyFlags properties ) const
 {
-	return m_impl->allocateMemory(requirements, properties);
+	return m_impl->importHostMemory(memory, memoryTypeBits, properties);
 }
 
 
@@ -2046,6 +2635,34 @@ vk::UniqueDescriptorSet Vulkan::allocateDescriptorSet(	vk::DescriptorPool pool,
 	return m_impl->allocateDescriptorSet(pool, layout);
 }
 
+Vulkan::PooledDescriptorSet Vulkan::allocateDescriptorSet(	vk::DescriptorSetLayout layout,
+															Utils::BufferView<const vk::DescriptorPoolSize> setSizes ) const
+{
+	return m_impl->allocateDescriptorSet(layout, setSizes);
+}
+
+size_t Vulkan::getCreatedDescriptorPoolCount() const noexcept {
+	return m_impl->getCreatedDescriptorPoolCount();
+}
+
+bool Vulkan::getBindlessSupport() const noexcept {
+	return m_impl->getBindlessSupport();
+}
+
+vk::DescriptorSetLayout Vulkan::getBindlessDescriptorSetLayout() const noexcept {
+	return m_impl->getBindlessDescriptorSetLayout();
+}
+
+vk::DescriptorSet Vulkan::getBindlessDescriptorSet() const noexcept {
+	return m_impl->getBindlessDescriptorSet();
+}
+
+Vulkan::BindlessSlot Vulkan::allocateBindlessSlot(	vk::ImageView imageView,
+													vk::Sampler sampler ) const
+{
+	return m_impl->allocateBindlessSlot(imageView, sampler);
+}
+
 
 vk::MemoryRequirements Vulkan::getMemoryRequirements(vk::Buffer buf) const {
 	return m_impl->getMemoryRequirements(buf);
@@ -2139,6 +2756,17 @@ void Vulkan::resetFences(Utils::BufferView<const vk::Fence> fences) const {
 	m_impl->resetFences(fences);
 }
 
+bool Vulkan::waitSemaphore(	vk::Semaphore semaphore,
+							uint64_t value,
+							uint64_t timeout ) const
+{
+	return m_impl->waitSemaphore(semaphore, value, timeout);
+}
+
+uint64_t Vulkan::getSemaphoreCounterValue(vk::Semaphore semaphore) const {
+	return m_impl->getSemaphoreCounterValue(semaphore);
+}
+
 
 
 void Vulkan::submit(vk::Queue queue,
@@ -2148,6 +2776,34 @@ void Vulkan::submit(vk::Queue queue,
 	m_impl->submit(queue, subInfo, fence);
 }
 
+uint64_t Vulkan::submitTransferBatched(Utils::BufferView<const vk::CommandBuffer> cmds) const {
+	return m_impl->submitTransferBatched(cmds);
+}
+
+uint64_t Vulkan::submitGraphicsBatched(	Utils::BufferView<const vk::CommandBuffer> cmds,
+										bool waitTransfer ) const
+{
+	return m_impl->submitGraphicsBatched(cmds, waitTransfer);
+}
+
+bool Vulkan::waitBatch(	uint64_t batch,
+						uint64_t timeout ) const
+{
+	return m_impl->waitBatch(batch, timeout);
+}
+
+void Vulkan::submitAll() const {
+	m_impl->submitAll();
+}
+
+uint64_t Vulkan::getPendingBatch() const noexcept {
+	return m_impl->getPendingBatch();
+}
+
+size_t Vulkan::getSubmitCount() const noexcept {
+	return m_impl->getSubmitCount();
+}
+
 
 void Vulkan::begin(	vk::CommandBuffer cmd,
 					const vk::CommandBufferBeginInfo& beginInfo ) const
@@ -2364,6 +3020,15 @@ void Vulkan::bindDescriptorSets(vk::CommandBuffer cmd,
 	m_impl->bindDescriptorSets(cmd, pipelineBindPoint, layout, firstSet, descriptorSets, dynamicOffsets);
 }
 
+void Vulkan::pushConstants(	vk::CommandBuffer cmd,
+							vk::PipelineLayout layout,
+							vk::ShaderStageFlags stages,
+							uint32_t offset,
+							Utils::BufferView<const std::byte> data ) const noexcept
+{
+	m_impl->pushConstants(cmd, layout, stages, offset, data);
+}
+
 void Vulkan::setViewport(	vk::CommandBuffer cmd,
 							uint32_t first,
 							Utils::BufferView<const vk::Viewport> viewports ) const noexcept
@@ -3,13 +3,16 @@
 #include "Timing/MainLoop.h"
 #include "Timing/Scheduler.h"
 #include "Timing/EventQueue.h"
+#include "Timing/CommandQueue.h"
 
 #include <zuazo/Zuazo.h>
 #include <zuazo/ZuazoBase.h>
+#include <zuazo/Signal/ExecutionPlan.h>
 #include <zuazo/Graphics/VulkanConversions.h>
 #include <zuazo/Utils/Bit.h>
 
 #include <mutex>
+#include <atomic>
 #include <iostream>
 #include <sstream>
 #include <type_traits>
@@ -24,17 +27,26 @@ struct Instance::Impl {
 	Graphics::Vulkan				vulkan;
 
 	std::mutex						mutex;
+	std::atomic<size_t>				lockRequests;
 	Timing::Scheduler				scheduler;
 	Timing::EventQueue				eventQueue;
+	Timing::CommandQueue			commandQueue;
 	Timing::MainLoop				loop;
+	Signal::ExecutionPlan			executionPlan;
 
 	Utils::Discrete<ColorFormat>	formatSupport;
 	Utils::Discrete<DepthStencilFormat>	depthStencilFormatSupport;
 	Utils::Range<Resolution>		resolutionSupport;
 
+	ScheduledCallback 				processCommandsCallback;
 	ScheduledCallback 				processEventsCallback;
+	ScheduledCallback 				evaluateSignalsCallback;
+	ScheduledCallback 				submitCallback;
 	ScheduledCallback 				presentImagesCallback;
 
+	size_t							submitCount;
+	std::atomic<size_t>				submitsPerTick;
+
 	Impl(	Instance& instance,
 			ApplicationInfo appInfo,
 			const DeviceScoreFunc& deviceScoreFunc )
@@ -48,20 +60,32 @@ struct Instance::Impl {
 			getRequiredVulkanDeviceExtensions(applicationInfo.getModules()),
 			std::bind(&Impl::vulkanLogCallback, std::ref(*this), std::placeholders::_1, std::placeholders::_2),
 			std::bind(&Impl::getPresentationSupport, std::cref(applicationInfo.getModules()), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-			deviceScoreFunc
+			deviceScoreFunc,
+			applicationInfo.getPipelineCachePath()
 		)
 		, mutex()
+		, lockRequests(0)
 		, scheduler()
 		, eventQueue()
-		, loop(scheduler, mutex)
+		, commandQueue()
+		, loop(scheduler, mutex, lockRequests)
+		, executionPlan()
 		, formatSupport(queryFormatSupport(vulkan))
 		, depthStencilFormatSupport(queryDepthStencilSupport(vulkan))
 		, resolutionSupport(queryResolutionSupport(vulkan))
+		, processCommandsCallback(createCommandProcessingCallback(commandQueue))
 		, processEventsCallback(createEventProcessingCallback(eventQueue))
+		, evaluateSignalsCallback(createSignalEvaluationCallback(executionPlan))
+		, submitCallback(std::bind(&Impl::submitAll, std::ref(*this)))
 		, presentImagesCallback(createPresentCallback(vulkan))
+		, submitCount(0)
+		, submitsPerTick(0)
 	{
 		std::lock_guard<Impl> lock(*this);
+		addRegularCallback(processCommandsCallback, commandHandlingPriority);
 		addRegularCallback(processEventsCallback, eventHandlingPriority);
+		addRegularCallback(evaluateSignalsCallback, signalEvaluationPriority);
+		addRegularCallback(submitCallback, submitPriority);
 		addRegularCallback(presentImagesCallback, presentPriority);
 
 		for(const Module& module : applicationInfo.getModules()) {
@@ -77,7 +101,10 @@ struct Instance::Impl {
 		}
 
 		removeRegularCallback(presentImagesCallback);
+		removeRegularCallback(submitCallback);
+		removeRegularCallback(evaluateSignalsCallback);
 		removeRegularCallback(processEventsCallback);
+		removeRegularCallback(processCommandsCallback);
 	}
 
 	const Instance::ApplicationInfo& getApplicationInfo() const noexcept {
@@ -119,14 +146,79 @@ struct Instance::Impl {
 		ZUAZO_LOG(instance, Severity::verbose, generateAddPeriodicEventMessage(cbk, prior, period));
 	}
 
+	void addPeriodicCallback(const ScheduledCallback& cbk, Priority prior, Rate rate) {
+		scheduler.addPeriodicCallback(cbk, prior, rate);
+		loop.interrupt();
+		ZUAZO_LOG(instance, Severity::verbose, generateAddPeriodicEventMessage(cbk, prior, rate));
+	}
+
 	void removePeriodicCallback(const ScheduledCallback& cbk) {
 		scheduler.removePeriodicCallback(cbk);
 		loop.interrupt();
 		ZUAZO_LOG(instance, Severity::verbose, generateRemovePeriodicEventMessage(cbk));
 	}
 
-	void addEvent(size_t emitterId, ScheduledCallback cbk) {
-		eventQueue.addEvent(emitterId, std::move(cbk));
+	void scheduleLayout(Signal::Layout& layout) {
+		executionPlan.addLayout(layout);
+	}
+
+	void unscheduleLayout(Signal::Layout& layout) {
+		executionPlan.removeLayout(layout);
+	}
+
+	void setWorkerThreadCount(size_t count) {
+		scheduler.setWorkerThreadCount(count);
+		ZUAZO_LOG(instance, Severity::verbose, generateWorkerThreadCountMessage(count));
+	}
+
+	size_t getWorkerThreadCount() const noexcept {
+		return scheduler.getWorkerThreadCount();
+	}
+
+	void setProfilingEnabled(bool ena) {
+		scheduler.setProfilingEnabled(ena);
+		ZUAZO_LOG(instance, Severity::verbose, ena ? "Profiling enabled" : "Profiling disabled");
+	}
+
+	bool getProfilingEnabled() const noexcept {
+		return scheduler.getProfilingEnabled();
+	}
+
+	CallbackStatistics getCallbackStatistics(const ScheduledCallback& cbk) const noexcept {
+		CallbackStatistics result = {};
+
+		const auto* profile = scheduler.getCallbackProfile(cbk);
+		if(profile) {
+			constexpr double P99 = 0.99;
+
+			result.invocationCount = profile->getInvocationCount();
+			result.minimumTime = profile->getMinimumTime();
+			result.averageTime = profile->getAverageTime();
+			result.p99Time = profile->getPercentileTime(P99);
+			result.maximumTime = profile->getMaximumTime();
+		}
+
+		return result;
+	}
+
+	size_t getProfiledUpdateCount() const noexcept {
+		return scheduler.getTickCount();
+	}
+
+	size_t getDeadlineMissCount() const noexcept {
+		return scheduler.getDeadlineMissCount();
+	}
+
+	void clearProfilingStatistics() noexcept {
+		scheduler.clearProfiles();
+	}
+
+	size_t getSubmitsPerTick() const noexcept {
+		return submitsPerTick.load();
+	}
+
+	void addEvent(size_t emitterId, ScheduledCallback cbk, bool coalesce) {
+		eventQueue.addEvent(emitterId, std::move(cbk), coalesce);
 		loop.interrupt();
 	}
 
@@ -134,6 +226,65 @@ struct Instance::Impl {
 		eventQueue.removeEvent(emitterId);
 	}
 
+	void addCommand(ScheduledCallback cmd) {
+		commandQueue.addCommand(std::move(cmd));
+		loop.interrupt();
+	}
+
+
+	void setClockMode(ClockMode mode) {
+		loop.setMode(toMainLoopMode(mode));
+		ZUAZO_LOG(instance, Severity::verbose, generateClockModeMessage(mode));
+	}
+
+	ClockMode getClockMode() const noexcept {
+		return fromMainLoopMode(loop.getMode());
+	}
+
+	void step() {
+		if(getClockMode() != ClockMode::realTime) {
+			loop.step();
+		} else {
+			ZUAZO_LOG(instance, Severity::warning, "Stepping is not allowed in real time mode");
+		}
+	}
+
+	void setSpinDuration(Duration duration) {
+		loop.setSpinDuration(duration);
+	}
+
+	Duration getSpinDuration() const noexcept {
+		return loop.getSpinDuration();
+	}
+
+	bool setLoopThreadScheduling(ThreadPolicy policy, int priority) {
+		const auto result = loop.setThreadScheduling(toMainLoopThreadPolicy(policy), priority);
+
+		if(!result) {
+			ZUAZO_LOG(instance, Severity::warning, "Could not set the scheduling policy of the main loop");
+		}
+
+		return result;
+	}
+
+	bool setLoopThreadAffinity(Utils::BufferView<const size_t> cpus) {
+		const auto result = loop.setThreadAffinity(cpus);
+
+		if(!result) {
+			ZUAZO_LOG(instance, Severity::warning, "Could not set the CPU affinity of the main loop");
+		}
+
+		return result;
+	}
+
+	JitterHistogram getJitterHistogram() const {
+		return loop.getJitterHistogram();
+	}
+
+	void clearJitterHistogram() {
+		loop.clearJitterHistogram();
+	}
+
 
 	TimePoint getTime() const noexcept {
 		return scheduler.getTime();
@@ -149,7 +300,10 @@ struct Instance::Impl {
 
 
 	void lock() noexcept {
+		//Announce it, so that the main loop yields the lock when running without waits
+		++lockRequests;
 		mutex.lock();
+		--lockRequests;
 	}
 
 	bool try_lock() noexcept {
@@ -210,11 +364,15 @@ struct Instance::Impl {
 	}
 
 	std::string generateAddPeriodicEventMessage(const ScheduledCallback& cbk, Priority prior, Duration period) const {
+		return generateAddPeriodicEventMessage(cbk, prior, getRate(period));
+	}
+
+	std::string generateAddPeriodicEventMessage(const ScheduledCallback& cbk, Priority prior, Rate rate) const {
 		std::ostringstream message;
 
 		message << "Periodic event added: " << &cbk << " ";
 		message << "(Priority: " << prior << ", ";
-		message << "Rate: " << getRate(period) << " Hz)";
+		message << "Rate: " << rate << " Hz)";
 
 		return message.str();
 	}
@@ -227,6 +385,27 @@ struct Instance::Impl {
 		return message.str();
 	}
 
+	std::string generateClockModeMessage(ClockMode mode) const {
+		std::ostringstream message;
+
+		message << "Clock mode set to: ";
+		switch(mode) {
+		case ClockMode::realTime: message << "real time"; break;
+		case ClockMode::virtualTime: message << "virtual time"; break;
+		case ClockMode::manual: message << "manual"; break;
+		}
+
+		return message.str();
+	}
+
+	std::string generateWorkerThreadCountMessage(size_t count) const {
+		std::ostringstream message;
+
+		message << "Worker thread count set to: " << count;
+
+		return message.str();
+	}
+
 private:
 	static Module::VulkanExtensions getRequiredVulkanInstanceExtensions(const ApplicationInfo::Modules& modules) {
 		Module::VulkanExtensions result;
@@ -271,7 +450,9 @@ private:
 
 
 	void vulkanLogCallback(Severity severity, std::string msg) {
-		if(applicationInfo.getInstanceLogFunc()) {
+		if(	applicationInfo.getInstanceLogFunc() && 
+			(applicationInfo.getVerbosity() & severity) != Verbosity::silent ) 
+		{
 			applicationInfo.getInstanceLogFunc()(
 				instance, 
 				severity, 
@@ -348,10 +529,51 @@ private:
 		);
 	}
 
+	static Timing::MainLoop::Mode toMainLoopMode(ClockMode mode) noexcept {
+		switch(mode) {
+		case ClockMode::virtualTime: 	return Timing::MainLoop::Mode::virtualTime;
+		case ClockMode::manual:			return Timing::MainLoop::Mode::manual;
+		default: 						return Timing::MainLoop::Mode::realTime;
+		}
+	}
+
+	static Timing::MainLoop::ThreadPolicy toMainLoopThreadPolicy(ThreadPolicy policy) noexcept {
+		switch(policy) {
+		case ThreadPolicy::fifo: 		return Timing::MainLoop::ThreadPolicy::fifo;
+		case ThreadPolicy::roundRobin:	return Timing::MainLoop::ThreadPolicy::roundRobin;
+		default: 						return Timing::MainLoop::ThreadPolicy::normal;
+		}
+	}
+
+	static ClockMode fromMainLoopMode(Timing::MainLoop::Mode mode) noexcept {
+		switch(mode) {
+		case Timing::MainLoop::Mode::virtualTime: 	return ClockMode::virtualTime;
+		case Timing::MainLoop::Mode::manual:		return ClockMode::manual;
+		default: 									return ClockMode::realTime;
+		}
+	}
+
+	static ScheduledCallback createCommandProcessingCallback(Timing::CommandQueue& commandQueue) {
+		return std::bind(&Timing::CommandQueue::process, std::ref(commandQueue));
+	}
+
 	static ScheduledCallback createEventProcessingCallback(Timing::EventQueue& eventQueue) {
 		return std::bind(&Timing::EventQueue::process, std::ref(eventQueue));
 	}
 
+	static ScheduledCallback createSignalEvaluationCallback(Signal::ExecutionPlan& executionPlan) {
+		return std::bind(&Signal::ExecutionPlan::beginUpdate, std::ref(executionPlan));
+	}
+
+	void submitAll() {
+		//Send all the work batched during this update
+		vulkan.submitAll();
+
+		const auto count = vulkan.getSubmitCount();
+		submitsPerTick.store(count - submitCount);
+		submitCount = count;
+	}
+
 	static ScheduledCallback createPresentCallback(const Graphics::Vulkan& vulkan) {
 		return std::bind(&Graphics::Vulkan::presentAll, std::cref(vulkan));
 	}
@@ -408,18 +630,110 @@ void Instance::addPeriodicCallback(	const ScheduledCallback& cbk,
 	m_impl->addPeriodicCallback(cbk, prior, period);
 }
 
+void Instance::addPeriodicCallback(	const ScheduledCallback& cbk, 
+									Priority prior, 
+									Rate rate )
+{
+	m_impl->addPeriodicCallback(cbk, prior, rate);
+}
+
 void Instance::removePeriodicCallback(const ScheduledCallback& cbk) {
 	m_impl->removePeriodicCallback(cbk);
 }
 
-void Instance::addEvent(size_t emitterId, ScheduledCallback cbk) {
-	m_impl->addEvent(emitterId, std::move(cbk));
+void Instance::scheduleLayout(Signal::Layout& layout) {
+	m_impl->scheduleLayout(layout);
+}
+
+void Instance::unscheduleLayout(Signal::Layout& layout) {
+	m_impl->unscheduleLayout(layout);
+}
+
+void Instance::setWorkerThreadCount(size_t count) {
+	m_impl->setWorkerThreadCount(count);
+}
+
+size_t Instance::getWorkerThreadCount() const noexcept {
+	return m_impl->getWorkerThreadCount();
+}
+
+void Instance::setProfilingEnabled(bool ena) {
+	m_impl->setProfilingEnabled(ena);
+}
+
+bool Instance::getProfilingEnabled() const noexcept {
+	return m_impl->getProfilingEnabled();
+}
+
+Instance::CallbackStatistics Instance::getCallbackStatistics(const ScheduledCallback& cbk) const noexcept {
+	return m_impl->getCallbackStatistics(cbk);
+}
+
+size_t Instance::getProfiledUpdateCount() const noexcept {
+	return m_impl->getProfiledUpdateCount();
+}
+
+size_t Instance::getDeadlineMissCount() const noexcept {
+	return m_impl->getDeadlineMissCount();
+}
+
+void Instance::clearProfilingStatistics() noexcept {
+	m_impl->clearProfilingStatistics();
+}
+
+size_t Instance::getSubmitsPerTick() const noexcept {
+	return m_impl->getSubmitsPerTick();
+}
+
+void Instance::addEvent(size_t emitterId, ScheduledCallback cbk, bool coalesce) {
+	m_impl->addEvent(emitterId, std::move(cbk), coalesce);
 }
 
 void Instance::removeEvent(size_t emitterId) {
 	m_impl->removeEvent(emitterId);
 }
 
+void Instance::addCommand(ScheduledCallback cmd) {
+	m_impl->addCommand(std::move(cmd));
+}
+
+
+
+void Instance::setClockMode(ClockMode mode) {
+	m_impl->setClockMode(mode);
+}
+
+Instance::ClockMode Instance::getClockMode() const noexcept {
+	return m_impl->getClockMode();
+}
+
+void Instance::step() {
+	m_impl->step();
+}
+
+void Instance::setSpinDuration(Duration duration) {
+	m_impl->setSpinDuration(duration);
+}
+
+Duration Instance::getSpinDuration() const noexcept {
+	return m_impl->getSpinDuration();
+}
+
+bool Instance::setLoopThreadScheduling(ThreadPolicy policy, int priority) {
+	return m_impl->setLoopThreadScheduling(policy, priority);
+}
+
+bool Instance::setLoopThreadAffinity(Utils::BufferView<const size_t> cpus) {
+	return m_impl->setLoopThreadAffinity(cpus);
+}
+
+Instance::JitterHistogram Instance::getJitterHistogram() const {
+	return m_impl->getJitterHistogram();
+}
+
+void Instance::clearJitterHistogram() {
+	m_impl->clearJitterHistogram();
+}
 
 
 TimePoint Instance::getTime() const noexcept {
@@ -546,6 +860,7 @@ Instance::ApplicationInfo::ApplicationInfo(	std::string name,
 	, m_modules(std::move(modules))
 	, m_instanceLogFunc(std::move(instanceLogFunc))
 	, m_elementLogFunc(std::move(elementLogFunc))
+	, m_pipelineCachePath()
 {
 }
 
@@ -575,6 +890,14 @@ const Instance::ApplicationInfo::ElementLogFunc& Instance::ApplicationInfo::getE
 	return m_elementLogFunc;
 }
 
+void Instance::ApplicationInfo::setPipelineCachePath(std::string path) {
+	m_pipelineCachePath = std::move(path);
+}
+
+const std::string& Instance::ApplicationInfo::getPipelineCachePath() const noexcept {
+	return m_pipelineCachePath;
+}
+
 
 
 void Instance::ApplicationInfo::defaultInstanceLogFunc(	const Instance& inst, 
@@ -3,6 +3,9 @@
 #include <zuazo/Utils/StaticId.h>
 
 #include <utility>
+#include <cassert>
+#include <algorithm>
+#include <vector>
 
 namespace Zuazo {
 
@@ -13,6 +16,8 @@ struct LayerBase::Impl {
 	RenderingLayer									renderingLayer;
 
 	vk::RenderPass 									renderPass;
+	std::vector<std::pair<vk::RenderPass, RenderPassState>> renderPassStates; //Most recently used last
+	bool											usePushConstants;
 
 	TransformCallback								transformCallback;
 	OpacityCallback									opacityCallback;
@@ -22,6 +27,10 @@ struct LayerBase::Impl {
 	HasAlphaCallback								hasAlphaCallback;
 	DrawCallback									drawCallback;
 	RenderPassCallback								renderPassCallback;
+	BatchKeyCallback								batchKeyCallback;
+	FrameIndexCallback								frameIndexCallback;
+	DrawInstancedCallback							drawInstancedCallback;
+	StateKeyCallback								stateKeyCallback;
 
 
 	Impl(	TransformCallback transformCbk,
@@ -37,6 +46,8 @@ struct LayerBase::Impl {
 		, blendingMode(BlendingMode::opacity)
 		, renderingLayer(RenderingLayer::background)
 		, renderPass()
+		, renderPassStates()
+		, usePushConstants(false)
 		, transformCallback(std::move(transformCbk))
 		, opacityCallback(std::move(opacityCbk))
 		, blendingModeCallback(std::move(blendingModeCbk))
@@ -45,6 +56,10 @@ struct LayerBase::Impl {
 		, hasAlphaCallback(std::move(hasAlphaCbk))
 		, drawCallback(std::move(drawCbk))
 		, renderPassCallback(std::move(renderPassCbk))
+		, batchKeyCallback()
+		, frameIndexCallback()
+		, drawInstancedCallback()
+		, stateKeyCallback()
 	{
 	}
 
@@ -136,12 +151,72 @@ struct LayerBase::Impl {
 		}
 	}
 
+	void pushConstants(	const Graphics::Vulkan& vulkan,
+						vk::CommandBuffer cmd,
+						vk::PipelineLayout layout ) const noexcept
+	{
+		const RendererBase::PushConstants pushConstants = {
+			transform.calculateMatrix(),
+			opacity
+		};
+
+		const auto& range = RendererBase::getPushConstantRanges().front();
+		assert(range.size == sizeof(pushConstants));
+
+		vulkan.pushConstants(
+			cmd,
+			layout,
+			range.stageFlags,
+			range.offset,
+			Utils::BufferView<const std::byte>(reinterpret_cast<const std::byte*>(&pushConstants), sizeof(pushConstants))
+		);
+	}
+
+	void setUsePushConstants(bool use) noexcept {
+		usePushConstants = use;
+	}
+
+	bool getUsePushConstants() const noexcept {
+		return usePushConstants;
+	}
+
+	size_t getBatchKey(const LayerBase& base, const RendererBase& renderer) const {
+		//Layers without effect are not batched, as they draw nothing
+		return (batchKeyCallback && drawInstancedCallback && hasEffect()) ? batchKeyCallback(base, renderer) : 0;
+	}
+
+	InstanceData getInstanceData(const LayerBase& base) const {
+		return InstanceData {
+			transform.calculateMatrix(),
+			opacity,
+			frameIndexCallback ? frameIndexCallback(base) : 0
+		};
+	}
+
+	void drawInstanced(	const LayerBase& base, 
+						const RendererBase& renderer, 
+						Graphics::CommandBuffer& cmd,
+						vk::Buffer instanceBuffer,
+						size_t instanceOffset,
+						uint32_t instanceCount ) const
+	{
+		assert(drawInstancedCallback);
+		drawInstancedCallback(base, renderer, cmd, instanceBuffer, instanceOffset, instanceCount);
+	}
+
 
 
 	void setRenderPass(LayerBase& base, vk::RenderPass pass) {
 		if(renderPass != pass) {
 			renderPass = pass;
-			Utils::invokeIf(renderPassCallback, base, renderPass);
+
+			const auto ite = findRenderPassState(renderPass);
+			if(ite != renderPassStates.end()) {
+				//Reuse the cached state. Mark it as the most recently used
+				std::rotate(ite, std::next(ite), renderPassStates.end());
+			} else {
+				Utils::invokeIf(renderPassCallback, base, renderPass);
+			}
 		} 
 	}
 
@@ -149,6 +224,35 @@ struct LayerBase::Impl {
 		return renderPass;
 	}
 
+	void setRenderPassState(RenderPassState state) {
+		const auto ite = findRenderPassState(renderPass);
+		if(ite != renderPassStates.end()) {
+			renderPassStates.erase(ite);
+		}
+
+		if(state) {
+			renderPassStates.emplace_back(renderPass, std::move(state));
+
+			//Evict the least recently used one
+			if(renderPassStates.size() > MAX_RENDER_PASS_STATES) {
+				renderPassStates.erase(renderPassStates.begin());
+			}
+		}
+	}
+
+	const RenderPassState& getRenderPassState() const noexcept {
+		static const RenderPassState EMPTY;
+
+		//The state of the current render pass is always the most recently used
+		return (!renderPassStates.empty() && renderPassStates.back().first == renderPass) ?
+			renderPassStates.back().second :
+			EMPTY ;
+	}
+
+	size_t getStateKey(const LayerBase& base, const RendererBase& renderer) const {
+		return stateKeyCallback ? stateKeyCallback(base, renderer) : 0;
+	}
+
 
 
 	void setTransformCallback(TransformCallback cbk) {
@@ -221,7 +325,50 @@ struct LayerBase::Impl {
 		return renderPassCallback;
 	}
 
+	void setBatchKeyCallback(BatchKeyCallback cbk) {
+		batchKeyCallback = std::move(cbk);
+	}
+
+	const BatchKeyCallback& getBatchKeyCallback() const noexcept {
+		return batchKeyCallback;
+	}
+
+	void setFrameIndexCallback(FrameIndexCallback cbk) {
+		frameIndexCallback = std::move(cbk);
+	}
+
+	const FrameIndexCallback& getFrameIndexCallback() const noexcept {
+		return frameIndexCallback;
+	}
+
+	void setDrawInstancedCallback(DrawInstancedCallback cbk) {
+		drawInstancedCallback = std::move(cbk);
+	}
+
+	const DrawInstancedCallback& getDrawInstancedCallback() const noexcept {
+		return drawInstancedCallback;
+	}
+
+	void setStateKeyCallback(StateKeyCallback cbk) {
+		stateKeyCallback = std::move(cbk);
+	}
+
+	const StateKeyCallback& getStateKeyCallback() const noexcept {
+		return stateKeyCallback;
+	}
+
 private:
+	using RenderPassStates = std::vector<std::pair<vk::RenderPass, RenderPassState>>;
+
+	RenderPassStates::iterator findRenderPassState(vk::RenderPass pass) noexcept {
+		return std::find_if(
+			renderPassStates.begin(), renderPassStates.end(),
+			[pass] (const RenderPassStates::value_type& state) -> bool {
+				return state.first == pass;
+			}
+		);
+	}
+
 	bool hasEffect() const noexcept {
 		bool result;
 
@@ -332,6 +479,30 @@ void LayerBase::draw(const RendererBase& renderer, Graphics::CommandBuffer& cmd)
 	m_impl->draw(*this, renderer, cmd);
 }
 
+void LayerBase::pushConstants(	const Graphics::Vulkan& vulkan,
+								vk::CommandBuffer cmd,
+								vk::PipelineLayout layout ) const noexcept
+{
+	m_impl->pushConstants(vulkan, cmd, layout);
+}
+
+size_t LayerBase::getBatchKey(const RendererBase& renderer) const {
+	return m_impl->getBatchKey(*this, renderer);
+}
+
+LayerBase::InstanceData LayerBase::getInstanceData() const {
+	return m_impl->getInstanceData(*this);
+}
+
+void LayerBase::drawInstanced(	const RendererBase& renderer, 
+								Graphics::CommandBuffer& cmd,
+								vk::Buffer instanceBuffer,
+								size_t instanceOffset,
+								uint32_t instanceCount ) const
+{
+	m_impl->drawInstanced(*this, renderer, cmd, instanceBuffer, instanceOffset, instanceCount);
+}
+
 
 void LayerBase::setRenderPass(vk::RenderPass pass) {
 	m_impl->setRenderPass(*this, pass);
@@ -341,6 +512,10 @@ vk::RenderPass LayerBase::getRenderPass() const noexcept {
 	return m_impl->getRenderPass();
 }
 
+size_t LayerBase::getStateKey(const RendererBase& renderer) const {
+	return m_impl->getStateKey(*this, renderer);
+}
+
 
 
 void LayerBase::setTransformCallback(TransformCallback cbk) {
@@ -405,4 +580,57 @@ const LayerBase::RenderPassCallback& LayerBase::getRenderPassCallback() const no
 	return m_impl->getRenderPassCallback();
 }
 
+
+void LayerBase::setBatchKeyCallback(BatchKeyCallback cbk) {
+	m_impl->setBatchKeyCallback(std::move(cbk));
+}
+
+const LayerBase::BatchKeyCallback& LayerBase::getBatchKeyCallback() const noexcept {
+	return m_impl->getBatchKeyCallback();
+}
+
+
+void LayerBase::setFrameIndexCallback(FrameIndexCallback cbk) {
+	m_impl->setFrameIndexCallback(std::move(cbk));
+}
+
+const LayerBase::FrameIndexCallback& LayerBase::getFrameIndexCallback() const noexcept {
+	return m_impl->getFrameIndexCallback();
+}
+
+
+void LayerBase::setDrawInstancedCallback(DrawInstancedCallback cbk) {
+	m_impl->setDrawInstancedCallback(std::move(cbk));
+}
+
+const LayerBase::DrawInstancedCallback& LayerBase::getDrawInstancedCallback() const noexcept {
+	return m_impl->getDrawInstancedCallback();
+}
+
+
+void LayerBase::setStateKeyCallback(StateKeyCallback cbk) {
+	m_impl->setStateKeyCallback(std::move(cbk));
+}
+
+const LayerBase::StateKeyCallback& LayerBase::getStateKeyCallback() const noexcept {
+	return m_impl->getStateKeyCallback();
+}
+
+
+void LayerBase::setUsePushConstants(bool use) noexcept {
+	m_impl->setUsePushConstants(use);
+}
+
+bool LayerBase::getUsePushConstants() const noexcept {
+	return m_impl->getUsePushConstants();
+}
+
+void LayerBase::setRenderPassState(RenderPassState state) {
+	m_impl->setRenderPassState(std::move(state));
+}
+
+const LayerBase::RenderPassState& LayerBase::getRenderPassState() const noexcept {
+	return m_impl->getRenderPassState();
+}
+
 }
\ No newline at end of file
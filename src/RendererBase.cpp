@@ -1,10 +1,20 @@
 #include <zuazo/RendererBase.h>
 
+#include "Timing/WorkerPool.h"
+
 #include <zuazo/Graphics/ColorTransfer.h>
+#include <zuazo/Graphics/CommandBufferPool.h>
+#include <zuazo/Graphics/UniformRing.h>
+#include <zuazo/Utils/CPU.h>
 #include <zuazo/Utils/StaticId.h>
+#include <zuazo/Utils/Functions.h>
 #include <zuazo/LayerBase.h>
 
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <exception>
+#include <cstring>
 
 namespace Zuazo {
 
@@ -13,23 +23,59 @@ namespace Zuazo {
  */
 
 struct RendererBase::Impl {
+	/*
+	 * A single layer or a run of batched layers
+	 */
+	struct DrawItem {
+		size_t												begin;
+		size_t												count;
+		size_t												instanceOffset;
+	};
+
+	using StateKeyedLayer = std::pair<size_t, LayerRef>;
+
 	Math::Vec2f											viewportSize;
 	vk::RenderPass										renderPass;
 	DepthStencilFormat									depthStencilFormat;
 	Camera												camera;	
 	std::vector<LayerRef>								layers;
 
+	vk::DescriptorSet									descriptorSet;
+
 	ViewportSizeCallback								viewportSizeCallback;
 	RenderPassCallback									renderPassCallback;
 
 	DepthStencilFormatCallback							depthStencilFormatCallback;
 	CameraCallback										cameraCallback;
+	SecondaryCommandBufferCallback						secondaryCommandBufferCallback;
 
 	Math::Mat4x4f										projectionMatrix; //Precomputed for use in layerComp
 	std::vector<LayerRef>								sortedLayers;
+	std::vector<StateKeyedLayer>						stateKeyedLayers; //Scratch space for sortOpaqueLayersByState
 	bool												hasChanged;
 
+	/*
+	 * Instanced batching. The instance buffer is shared with the
+	 * command buffers using it, so that it outlives them
+	 */
+	std::vector<size_t>									batchKeys;
+	std::vector<DrawItem>								drawItems;
+	std::shared_ptr<Graphics::UniformRing>				instanceRing;
+
+	/*
+	 * Parallel recording. Each chunk of layers has its own command 
+	 * pool, as they can not be used concurrently
+	 */
+	std::unique_ptr<Timing::WorkerPool>					recordingWorkers;
+	std::vector<Graphics::CommandBufferPool>			recordingPools;
+	std::vector<std::shared_ptr<Graphics::CommandBuffer>> recordingCommandBuffers;
+
+	size_t												pipelineBindCount;
+	size_t												descriptorSetBindCount;
+
 	static constexpr Math::Vec2f DUMMY_SIZE = Math::Vec2f(1.0f, 1.0f);
+	static constexpr size_t MIN_DRAWS_PER_CHUNK = 16;
+	static constexpr size_t INSTANCE_DATA_ALIGNMENT = alignof(LayerBase::InstanceData);
 
 
 	Impl(	DepthStencilFormatCallback depthStencilFormatCbk, 
@@ -39,11 +85,21 @@ struct RendererBase::Impl {
 		, depthStencilFormat(DepthStencilFormat::D16)
 		, camera()
 		, layers()
+		, descriptorSet()
 		, viewportSizeCallback()
 		, depthStencilFormatCallback(std::move(depthStencilFormatCbk))
 		, cameraCallback(std::move(cameraCbk))
+		, secondaryCommandBufferCallback()
 		, projectionMatrix(camera.calculateProjectionMatrix(DUMMY_SIZE))
 		, hasChanged(true)
+		, batchKeys()
+		, drawItems()
+		, instanceRing()
+		, recordingWorkers()
+		, recordingPools()
+		, recordingCommandBuffers()
+		, pipelineBindCount(0)
+		, descriptorSetBindCount(0)
 	{
 	}
 
@@ -54,6 +110,7 @@ struct RendererBase::Impl {
 	void setViewportSize(RendererBase& base, Math::Vec2f size) {
 		if(viewportSize != size) {
 			viewportSize = size;
+			hasChanged = true;
 			Utils::invokeIf(viewportSizeCallback, base, viewportSize);
 		}		
 	}
@@ -74,6 +131,7 @@ struct RendererBase::Impl {
 	void setRenderPass(RendererBase& base, vk::RenderPass pass) {
 		if(renderPass != pass) {
 			renderPass = pass;
+			hasChanged = true;
 			Utils::invokeIf(renderPassCallback, base, renderPass);
 		}		
 	}
@@ -95,6 +153,7 @@ struct RendererBase::Impl {
 	void setDepthStencilFormat(RendererBase& base, DepthStencilFormat fmt) {
 		if(depthStencilFormat != fmt) {
 			depthStencilFormat = fmt;
+			hasChanged = true;
 			Utils::invokeIf(depthStencilFormatCallback, base, depthStencilFormat);
 		}
 	}
@@ -109,6 +168,7 @@ struct RendererBase::Impl {
 		if(camera != cam) {
 			camera = cam;
 			projectionMatrix = camera.calculateProjectionMatrix(DUMMY_SIZE);
+			hasChanged = true;
 			Utils::invokeIf(cameraCallback, base, camera);
 		}
 	}
@@ -139,6 +199,15 @@ struct RendererBase::Impl {
 	}
 
 
+	void setDescriptorSet(vk::DescriptorSet set) noexcept {
+		descriptorSet = set;
+	}
+
+	vk::DescriptorSet getDescriptorSet() const noexcept {
+		return descriptorSet;
+	}
+
+
 	bool layersHaveChanged(const RendererBase& renderer) const {
 		if(hasChanged) {
 			return true;
@@ -179,20 +248,42 @@ struct RendererBase::Impl {
 					std::next(sortedLayers.begin(), baseIndex), sortedLayers.end(),
 					std::bind(&Impl::sceneLayerComp, std::cref(*this), std::placeholders::_1, std::placeholders::_2)
 				);
+
+				sortOpaqueLayersByState(renderer, baseIndex);
 			}
 
 		}
 		assert(sortedLayers.size() == layers.size());
 
-		//Draw all the layers
-		//Ensure all layers have the correct renderpass.
-		//FIXME this will be very innefficient if two renderers
-		//with different renderPasses share the same layer.
+		//Ensure all layers have the correct renderpass. Layers keep their 
+		//state for the last few render passes, so switching between the
+		//render passes of the renderers sharing them is cheap
 		for(LayerBase& layer : sortedLayers) {
 			layer.setRenderPass(renderPass);
-			layer.draw(renderer, cmd);
 		}
 
+		//Group compatible layers into instanced draws
+		const auto batchedLayerCount = createDrawItems(renderer);
+		if(batchedLayerCount > 0) {
+			writeInstanceData(cmd);
+		}
+
+		//Draw all the layers. Batching may have left too few draws to split, 
+		//but the render pass expects secondary command buffers anyway
+		if(useSecondaryCommandBuffers()) {
+			drawParallel(renderer, cmd, getRecordingChunkCount(drawItems.size()));
+		} else {
+			const auto pipelineBindBase = cmd.getPipelineBindCount();
+			const auto descriptorSetBindBase = cmd.getDescriptorSetBindCount();
+
+			drawRange(renderer, cmd, 0, drawItems.size());
+
+			pipelineBindCount = cmd.getPipelineBindCount() - pipelineBindBase;
+			descriptorSetBindCount = cmd.getDescriptorSetBindCount() - descriptorSetBindBase;
+		}
+
+		drawItems.clear();
+
 		//Empty the sorted layers array. This should not deallocate it
 		sortedLayers.clear();
 		hasChanged = false;
@@ -200,6 +291,37 @@ struct RendererBase::Impl {
 
 
 
+	void setRecordingThreadCount(size_t count) {
+		if(count != getRecordingThreadCount()) {
+			recordingWorkers.reset(); //Wait for the old threads before spawning the new ones
+			if(count > 0) {
+				recordingWorkers = Utils::makeUnique<Timing::WorkerPool>(count);
+			}
+		}
+
+		assert(getRecordingThreadCount() == count);
+	}
+
+	size_t getRecordingThreadCount() const noexcept {
+		return recordingWorkers ? recordingWorkers->getThreadCount() : 0;
+	}
+
+	vk::SubpassContents getSubpassContents() const noexcept {
+		return	useSecondaryCommandBuffers() ?
+				vk::SubpassContents::eSecondaryCommandBuffers :
+				vk::SubpassContents::eInline ;
+	}
+
+	size_t getPipelineBindCount() const noexcept {
+		return pipelineBindCount;
+	}
+
+	size_t getDescriptorSetBindCount() const noexcept {
+		return descriptorSetBindCount;
+	}
+
+
+
 	static UniformBufferSizes getUniformBufferSizes() noexcept {
 		static const std::array uniformBufferSizes = {
 			std::make_pair(static_cast<uint32_t>(DESCRIPTOR_BINDING_PROJECTION_MATRIX), 	sizeof(Math::Mat4x4f))
@@ -219,6 +341,19 @@ struct RendererBase::Impl {
 		return descriptorPoolSizes;
 	}
 
+	static PushConstantRanges getPushConstantRanges() noexcept {
+		static_assert(sizeof(PushConstants) <= 128, "Push constants must fit in the guaranteed size");
+		static const std::array pushConstantRanges = {
+			vk::PushConstantRange(
+				vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+				0,
+				sizeof(PushConstants)
+			)
+		};
+
+		return pushConstantRanges;
+	}
+
 	static vk::DescriptorSetLayout getDescriptorSetLayout(const Graphics::Vulkan& vulkan) {
 		static const Utils::StaticId id;
 
@@ -273,6 +408,32 @@ struct RendererBase::Impl {
 		return result;
 	}
 
+	static vk::PipelineLayout getPushConstantPipelineLayout(const Graphics::Vulkan& vulkan) {
+		//Same as above for the pipelines of layers using push constants, as set 
+		//compatibility also requires identical push constant ranges
+		static const Utils::StaticId id;
+
+		auto result = vulkan.createPipelineLayout(id);
+		if(!result) {
+			const std::array layouts {
+				getDescriptorSetLayout(vulkan)
+			};
+
+			const auto pushConstantRanges = getPushConstantRanges();
+
+			const vk::PipelineLayoutCreateInfo createInfo(
+				{},													//Flags
+				layouts.size(), layouts.data(),						//Descriptor set layouts
+				pushConstantRanges.size(), pushConstantRanges.data()	//Push constants
+			);
+
+			result = vulkan.createPipelineLayout(id, createInfo);
+		}
+
+		assert(result);
+		return result;
+	}
+
 
 
 	void setDepthStencilFormatCallback(DepthStencilFormatCallback cbk) {
@@ -291,8 +452,354 @@ struct RendererBase::Impl {
 	const CameraCallback& getCameraCallback() const {
 		return cameraCallback;
 	}
+
+
+	void setSecondaryCommandBufferCallback(SecondaryCommandBufferCallback cbk) {
+		secondaryCommandBufferCallback = std::move(cbk);
+	}
+
+	const SecondaryCommandBufferCallback& getSecondaryCommandBufferCallback() const noexcept {
+		return secondaryCommandBufferCallback;
+	}
 	
 private:
+	bool useSecondaryCommandBuffers() const noexcept {
+		//Decided before the draw items are created, as the render pass is begun
+		//before drawing. Each layer yields at most one draw, so it is an upper bound
+		return	recordingWorkers && 
+				secondaryCommandBufferCallback && 
+				layers.size() >= 2*MIN_DRAWS_PER_CHUNK ;
+	}
+
+	size_t getRecordingChunkCount(size_t drawCount) const noexcept {
+		assert(useSecondaryCommandBuffers());
+
+		//The calling thread also records a chunk
+		const auto maxChunkCount = recordingWorkers->getThreadCount() + 1;
+		return std::clamp(drawCount / MIN_DRAWS_PER_CHUNK, static_cast<size_t>(1), maxChunkCount);
+	}
+
+	size_t createDrawItems(const RendererBase& renderer) {
+		size_t result = 0;
+		drawItems.clear();
+
+		batchKeys.clear();
+		batchKeys.reserve(sortedLayers.size());
+		for(const LayerBase& layer : sortedLayers) {
+			batchKeys.push_back(layer.getBatchKey(renderer));
+		}
+		assert(batchKeys.size() == sortedLayers.size());
+
+		//Only consecutive layers are merged, so that the drawing 
+		//order (and therefore blending) is preserved
+		size_t begin = 0;
+		while(begin < sortedLayers.size()) {
+			const LayerBase& first = sortedLayers[begin];
+			size_t end = begin + 1;
+
+			if(batchKeys[begin]) {
+				while(end < sortedLayers.size()) {
+					const LayerBase& layer = sortedLayers[end];
+					const bool compatible = 
+						batchKeys[end] == batchKeys[begin] &&
+						layer.getBlendingMode() == first.getBlendingMode() &&
+						layer.getRenderingLayer() == first.getRenderingLayer() ;
+
+					if(!compatible) {
+						break;
+					}
+
+					++end;
+				}
+			}
+
+			const auto count = end - begin;
+			drawItems.push_back(DrawItem{ begin, count, 0 });
+			if(count > 1) {
+				result += count;
+			}
+
+			begin = end;
+		}
+
+		return result;
+	}
+
+	size_t getInstanceDataSize() const noexcept {
+		//Each batch's slice starts at an aligned offset
+		size_t result = 0;
+
+		for(const auto& item : drawItems) {
+			if(item.count > 1) {
+				result += Utils::alignUpper(item.count * sizeof(LayerBase::InstanceData), INSTANCE_DATA_ALIGNMENT);
+			}
+		}
+
+		return result;
+	}
+
+	void writeInstanceData(Graphics::CommandBuffer& cmd) {
+		const auto& vulkan = cmd.getVulkan();
+		const auto size = getInstanceDataSize();
+
+		//Move to the next region or create a bigger ring when it does not
+		//fit. The previous one is kept alive by its command buffers
+		if(instanceRing && instanceRing->getFrameSize() >= size) {
+			instanceRing->advance(vulkan);
+		} else {
+			instanceRing = Utils::makeShared<Graphics::UniformRing>(
+				vulkan,
+				2*size,
+				Graphics::UniformRing::DEFAULT_FRAME_COUNT,
+				vk::BufferUsageFlagBits::eVertexBuffer,
+				INSTANCE_DATA_ALIGNMENT
+			);
+		}
+		assert(instanceRing->getAlignment() == INSTANCE_DATA_ALIGNMENT);
+
+		for(auto& item : drawItems) {
+			if(item.count > 1) {
+				const auto slice = instanceRing->allocate(item.count * sizeof(LayerBase::InstanceData));
+				item.instanceOffset = slice.offset;
+
+				//The mapped memory holds no InstanceData objects, so copy them bytewise
+				for(size_t i = 0; i < item.count; ++i) {
+					const LayerBase& layer = sortedLayers[item.begin + i];
+					const auto instance = layer.getInstanceData();
+					std::memcpy(
+						slice.data.data() + i*sizeof(instance), 
+						&instance, 
+						sizeof(instance)
+					);
+				}
+			}
+		}
+
+		const std::array dependencies = {
+			Graphics::CommandBuffer::Dependency(instanceRing)
+		};
+		cmd.addDependencies(dependencies);
+	}
+
+	void drawRange(	const RendererBase& renderer, 
+					Graphics::CommandBuffer& cmd,
+					size_t begin, size_t end ) const
+	{
+		//The renderer's descriptor set is bound with the base pipeline layout, which 
+		//is not compatible with the pipelines of layers using push constants. Rebind
+		//it whenever switching between both kinds of layers
+		bool pushConstantLayout = false;
+		for(auto i = begin; i < end; ++i) {
+			const auto& item = drawItems[i];
+			const LayerBase& first = sortedLayers[item.begin];
+
+			if(first.getUsePushConstants() != pushConstantLayout) {
+				pushConstantLayout = !pushConstantLayout;
+				bindDescriptorSet(cmd, pushConstantLayout);
+			}
+
+			drawItem(renderer, cmd, item);
+		}
+
+		//Leave it as the renderer bound it
+		if(pushConstantLayout) {
+			bindDescriptorSet(cmd, false);
+		}
+	}
+
+	void bindDescriptorSet(	Graphics::CommandBuffer& cmd,
+							bool pushConstantLayout ) const
+	{
+		assert(descriptorSet); //Required by layers using push constants
+		const auto& vulkan = cmd.getVulkan();
+
+		cmd.bindDescriptorSets(
+			vk::PipelineBindPoint::eGraphics,			//Pipeline bind point
+			pushConstantLayout ? getPushConstantPipelineLayout(vulkan) : getBasePipelineLayout(vulkan), //Pipeline layout
+			DESCRIPTOR_SET,								//First index
+			descriptorSet,								//Descriptor sets
+			{}											//Dynamic offsets
+		);
+	}
+
+	void drawItem(	const RendererBase& renderer, 
+					Graphics::CommandBuffer& cmd,
+					const DrawItem& item ) const
+	{
+		const LayerBase& first = sortedLayers[item.begin];
+
+		if(item.count > 1) {
+			assert(instanceRing);
+			first.drawInstanced(
+				renderer, 
+				cmd, 
+				instanceRing->getBuffer(), 
+				item.instanceOffset, 
+				static_cast<uint32_t>(item.count)
+			);
+		} else {
+			assert(item.count == 1);
+			first.draw(renderer, cmd);
+		}
+	}
+
+	void drawParallel(	const RendererBase& renderer, 
+						Graphics::CommandBuffer& cmd,
+						size_t chunkCount )
+	{
+		assert(recordingWorkers);
+		assert(secondaryCommandBufferCallback);
+		const auto& vulkan = cmd.getVulkan();
+
+		//Ensure that there are enough pools for the given Vulkan instance
+		if(!recordingPools.empty() && &(recordingPools.front().getVulkan()) != &vulkan) {
+			recordingPools.clear();
+		}
+		while(recordingPools.size() < chunkCount) {
+			recordingPools.emplace_back(
+				vulkan,
+				vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+				vulkan.getGraphicsQueueIndex(),
+				vk::CommandBufferLevel::eSecondary
+			);
+		}
+
+		const vk::CommandBufferInheritanceInfo inheritanceInfo(
+			renderPass,										//Render pass
+			0,												//Subpass
+			vk::Framebuffer()								//Framebuffer. Unknown
+		);
+
+		const vk::CommandBufferBeginInfo beginInfo(
+			vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+			&inheritanceInfo
+		);
+
+		//Record contiguous chunks of draws. Workers must not throw, 
+		//so keep the first exception and rethrow it afterwards
+		std::mutex exceptionMutex;
+		std::exception_ptr exception;
+		recordingCommandBuffers.resize(chunkCount);
+
+		recordingWorkers->parallelFor(
+			chunkCount,
+			[&] (size_t index) {
+				try {
+					const auto begin = drawItems.size() * index / chunkCount;
+					const auto end = drawItems.size() * (index + 1) / chunkCount;
+
+					auto secondary = recordingPools[index].acquireCommandBuffer();
+					secondary->begin(beginInfo);
+					secondaryCommandBufferCallback(renderer, *secondary);
+					drawRange(renderer, *secondary, begin, end);
+					secondary->end();
+
+					recordingCommandBuffers[index] = std::move(secondary);
+				} catch(...) {
+					std::lock_guard<std::mutex> lock(exceptionMutex);
+					if(!exception) {
+						exception = std::current_exception();
+					}
+				}
+			}
+		);
+
+		if(exception) {
+			recordingCommandBuffers.clear();
+			std::rethrow_exception(exception);
+		}
+
+		//Execute them in order, so that the result is the same as 
+		//recording serially. The primary keeps them alive
+		std::vector<vk::CommandBuffer> commandBuffers;
+		std::vector<Graphics::CommandBuffer::Dependency> dependencies;
+		commandBuffers.reserve(chunkCount);
+		dependencies.reserve(chunkCount);
+		pipelineBindCount = 0;
+		descriptorSetBindCount = 0;
+		for(auto& secondary : recordingCommandBuffers) {
+			assert(secondary);
+			pipelineBindCount += secondary->getPipelineBindCount();
+			descriptorSetBindCount += secondary->getDescriptorSetBindCount();
+			commandBuffers.push_back(secondary->get());
+			dependencies.push_back(std::move(secondary));
+		}
+
+		cmd.execute(commandBuffers);
+		cmd.addDependencies(dependencies);
+		recordingCommandBuffers.clear();
+	}
+
+	void sortOpaqueLayersByState(const RendererBase& renderer, size_t baseIndex) {
+		//Without depth testing the drawing order determines the result
+		if(depthStencilFormat == DepthStencilFormat::none || depthStencilFormat == DepthStencilFormat::S8) {
+			return;
+		}
+
+		//Opaque layers come first in the scene. Their relative order only
+		//matters for early depth rejection, so use it as the tiebreak
+		const auto begin = std::next(sortedLayers.begin(), baseIndex);
+		const auto end = std::find_if(
+			begin, sortedLayers.end(),
+			[] (const LayerBase& layer) -> bool {
+				return layer.hasBlending();
+			}
+		);
+
+		const auto count = static_cast<size_t>(std::distance(begin, end));
+		if(count < 2) {
+			return;
+		}
+
+		//Query the keys once, as they are provided by callbacks
+		assert(stateKeyedLayers.empty());
+		stateKeyedLayers.reserve(count);
+		std::transform(
+			begin, end,
+			std::back_inserter(stateKeyedLayers),
+			[&renderer] (LayerBase& layer) -> StateKeyedLayer {
+				return StateKeyedLayer(layer.getStateKey(renderer), layer);
+			}
+		);
+
+		//Layers without a state key (0) stay in place. Only the runs
+		//of layers in between them are sorted
+		const auto isUnkeyed = [] (const StateKeyedLayer& keyedLayer) -> bool {
+			return keyedLayer.first == 0;
+		};
+
+		auto first = std::find_if_not(stateKeyedLayers.begin(), stateKeyedLayers.end(), isUnkeyed);
+		if(first == stateKeyedLayers.end()) {
+			//No layer provides a state key
+			stateKeyedLayers.clear();
+			return;
+		}
+
+		while(first != stateKeyedLayers.end()) {
+			const auto last = std::find_if(first, stateKeyedLayers.end(), isUnkeyed);
+
+			std::stable_sort(
+				first, last,
+				[] (const StateKeyedLayer& a, const StateKeyedLayer& b) -> bool {
+					return a.first < b.first;
+				}
+			);
+
+			first = std::find_if_not(last, stateKeyedLayers.end(), isUnkeyed);
+		}
+
+		std::transform(
+			stateKeyedLayers.cbegin(), stateKeyedLayers.cend(),
+			begin,
+			[] (const StateKeyedLayer& keyedLayer) -> LayerRef {
+				return keyedLayer.second;
+			}
+		);
+
+		//This should not deallocate it
+		stateKeyedLayers.clear();
+	}
+
 	bool sceneLayerComp(const LayerBase& a, const LayerBase& b) const {
 		/*
 		 * The strategy will be the following:
@@ -412,6 +919,27 @@ void RendererBase::draw(Graphics::CommandBuffer& cmd) {
 }
 
 
+void RendererBase::setRecordingThreadCount(size_t count) {
+	m_impl->setRecordingThreadCount(count);
+}
+
+size_t RendererBase::getRecordingThreadCount() const noexcept {
+	return m_impl->getRecordingThreadCount();
+}
+
+vk::SubpassContents RendererBase::getSubpassContents() const noexcept {
+	return m_impl->getSubpassContents();
+}
+
+size_t RendererBase::getPipelineBindCount() const noexcept {
+	return m_impl->getPipelineBindCount();
+}
+
+size_t RendererBase::getDescriptorSetBindCount() const noexcept {
+	return m_impl->getDescriptorSetBindCount();
+}
+
+
 void RendererBase::setLayers(Utils::BufferView<const LayerRef> layers) {
 	m_impl->setLayers(layers);
 }
@@ -421,6 +949,15 @@ Utils::BufferView<const RendererBase::LayerRef> RendererBase::getLayers() const
 }
 
 
+vk::DescriptorSet RendererBase::getDescriptorSet() const noexcept {
+	return m_impl->getDescriptorSet();
+}
+
+void RendererBase::setDescriptorSet(vk::DescriptorSet descriptorSet) noexcept {
+	m_impl->setDescriptorSet(descriptorSet);
+}
+
+
 
 RendererBase::UniformBufferSizes RendererBase::getUniformBufferSizes() noexcept {
 	return Impl::getUniformBufferSizes();
@@ -430,6 +967,10 @@ RendererBase::DescriptorPoolSizes RendererBase::getDescriptorPoolSizes() noexcep
 	return Impl::getDescriptorPoolSizes();
 }
 
+RendererBase::PushConstantRanges RendererBase::getPushConstantRanges() noexcept {
+	return Impl::getPushConstantRanges();
+}
+
 vk::DescriptorSetLayout RendererBase::getDescriptorSetLayout(const Graphics::Vulkan& vulkan) {
 	return Impl::getDescriptorSetLayout(vulkan);
 }
@@ -438,6 +979,10 @@ vk::PipelineLayout RendererBase::getBasePipelineLayout(const Graphics::Vulkan& v
 	return Impl::getBasePipelineLayout(vulkan);
 }
 
+vk::PipelineLayout RendererBase::getPushConstantPipelineLayout(const Graphics::Vulkan& vulkan) {
+	return Impl::getPushConstantPipelineLayout(vulkan);
+}
+
 
 
 void RendererBase::setViewportSize(Math::Vec2f size) {
@@ -448,6 +993,14 @@ void RendererBase::setRenderPass(vk::RenderPass pass) {
 	m_impl->setRenderPass(*this, pass);
 }
 
+void RendererBase::setSecondaryCommandBufferCallback(SecondaryCommandBufferCallback cbk) {
+	m_impl->setSecondaryCommandBufferCallback(std::move(cbk));
+}
+
+const RendererBase::SecondaryCommandBufferCallback& RendererBase::getSecondaryCommandBufferCallback() const noexcept {
+	return m_impl->getSecondaryCommandBufferCallback();
+}
+
 
 
 
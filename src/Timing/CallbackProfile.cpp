@@ -0,0 +1,102 @@
+#include "CallbackProfile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace Zuazo::Timing {
+
+CallbackProfile::CallbackProfile() noexcept
+	: m_invocationCount(0)
+	, m_minimumTime(Duration::max())
+	, m_maximumTime(Duration::zero())
+	, m_totalTime(Duration::zero())
+	, m_histogram{}
+{
+}
+
+
+
+void CallbackProfile::record(Duration time) noexcept {
+	++m_invocationCount;
+	m_minimumTime = std::min(m_minimumTime, time);
+	m_maximumTime = std::max(m_maximumTime, time);
+	m_totalTime += time;
+	++m_histogram[getHistogramIndex(time)];
+}
+
+void CallbackProfile::clear() noexcept {
+	*this = CallbackProfile();
+}
+
+
+
+size_t CallbackProfile::getInvocationCount() const noexcept {
+	return m_invocationCount;
+}
+
+Duration CallbackProfile::getMinimumTime() const noexcept {
+	return m_invocationCount ? m_minimumTime : Duration::zero();
+}
+
+Duration CallbackProfile::getAverageTime() const noexcept {
+	return m_invocationCount ? m_totalTime / static_cast<Duration::rep>(m_invocationCount) : Duration::zero();
+}
+
+Duration CallbackProfile::getMaximumTime() const noexcept {
+	return m_maximumTime;
+}
+
+Duration CallbackProfile::getPercentileTime(double percentile) const noexcept {
+	assert(percentile >= 0.0 && percentile <= 1.0);
+	Duration result = Duration::zero();
+
+	if(m_invocationCount) {
+		//Find the bucket where the percentile lies in
+		const auto target = static_cast<size_t>(std::ceil(percentile * m_invocationCount));
+		size_t count = 0;
+		size_t index = 0;
+		while(index < m_histogram.size() - 1 && (count += m_histogram[index]) < target) {
+			++index;
+		}
+
+		//The histogram is not exact, so use the upper bound of the bucket without exceeding the real maximum
+		result = std::clamp(getHistogramUpperBound(index), getMinimumTime(), getMaximumTime());
+	}
+
+	return result;
+}
+
+
+
+size_t CallbackProfile::getHistogramIndex(Duration time) noexcept {
+	const auto us = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+	size_t result = 0;
+
+	if(us > 0) {
+		//Obtain the octave and use the next bit to split it in 2
+		size_t octave = 0;
+		while((us >> (octave + 1)) > 0) {
+			++octave;
+		}
+		const size_t half = octave > 0 ? ((us >> (octave - 1)) & 1) : 0;
+
+		result = 1 + 2*octave + half;
+	}
+
+	return std::min(result, std::tuple_size<Histogram>::value - 1);
+}
+
+Duration CallbackProfile::getHistogramUpperBound(size_t index) noexcept {
+	std::chrono::nanoseconds result = std::chrono::microseconds(1);
+
+	if(index > 0) {
+		const size_t octave = (index - 1) / 2;
+		const size_t half = (index - 1) % 2;
+		result = std::chrono::microseconds((2 + half + 1) << octave) / 2; //(1.5 or 2) * 2^octave us
+	}
+
+	return std::chrono::duration_cast<Duration>(result);
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <zuazo/Chrono.h>
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace Zuazo::Timing {
+
+class CallbackProfile {
+public:
+	CallbackProfile() noexcept;
+	CallbackProfile(const CallbackProfile& other) = default;
+	~CallbackProfile() = default;
+
+	CallbackProfile&		operator=(const CallbackProfile& other) = default;
+
+	void					record(Duration time) noexcept;
+	void					clear() noexcept;
+
+	size_t					getInvocationCount() const noexcept;
+	Duration				getMinimumTime() const noexcept;
+	Duration				getAverageTime() const noexcept;
+	Duration				getMaximumTime() const noexcept;
+	Duration				getPercentileTime(double percentile) const noexcept;
+
+private:
+	//Logarithmic histogram, with 2 buckets per octave starting at 1us
+	using Histogram = std::array<uint32_t, 48>;
+
+	size_t					m_invocationCount;
+	Duration				m_minimumTime;
+	Duration				m_maximumTime;
+	Duration				m_totalTime;
+	Histogram				m_histogram;
+
+	static size_t			getHistogramIndex(Duration time) noexcept;
+	static Duration			getHistogramUpperBound(size_t index) noexcept;
+
+};
+
+}
@@ -0,0 +1,34 @@
+#include "CommandQueue.h"
+
+#include <zuazo/Utils/Functions.h>
+
+#include <memory>
+
+namespace Zuazo::Timing {
+
+CommandQueue::CommandQueue()
+	: m_commands()
+{
+}
+
+CommandQueue::~CommandQueue() = default;
+
+
+
+void CommandQueue::addCommand(Command cmd) {
+	m_commands.push(new Node{ std::move(cmd), nullptr });
+}
+
+void CommandQueue::process() {
+	//Take all the pending commands at once. Commands are pushed in reverse 
+	//order, so restore the original order before processing them
+	Node* list = IntrusiveStack<Node>::reverse(m_commands.popAll());
+
+	while(list) {
+		std::unique_ptr<Node> node(list);
+		list = node->next;
+		Utils::invokeIf(node->command);
+	}
+}
+
+}
\ No newline at end of file
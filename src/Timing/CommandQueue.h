@@ -0,0 +1,32 @@
+#pragma once
+
+#include "IntrusiveStack.h"
+
+#include <functional>
+
+namespace Zuazo::Timing {
+
+class CommandQueue {
+public:
+	using Command = std::function<void()>;
+
+	CommandQueue();
+	CommandQueue(const CommandQueue& other) = delete;
+	~CommandQueue();
+
+	CommandQueue&				operator=(const CommandQueue& other) = delete;
+
+	void 						addCommand(Command cmd);
+	void 						process();
+
+private:
+	struct Node {
+		Command						command;
+		Node*						next;
+	};
+
+	IntrusiveStack<Node>		m_commands;
+
+};
+
+}
@@ -4,40 +4,98 @@
 
 #include <cassert>
 #include <algorithm>
+#include <memory>
 
 namespace Zuazo::Timing {
 
-void EventQueue::addEvent(size_t emitterId, EventCallback event) {
-	std::lock_guard<std::mutex> lock(m_mutex);
-	m_pendingEvents.emplace_back(emitterId, std::move(event));
+EventQueue::EventQueue()
+	: m_events()
+{
 }
 
-void EventQueue::removeEvent(size_t emitterId) {
-	std::lock_guard<std::mutex> lock(m_mutex);
+EventQueue::~EventQueue() = default;
+
 
-	const auto ite = std::remove_if(
-		m_pendingEvents.begin(), m_pendingEvents.end(),
-		[emitterId] (const auto& event) -> bool {
-			return event.first == emitterId;
-		}
-	);
 
-	m_pendingEvents.erase(ite, m_pendingEvents.cend());
+void EventQueue::addEvent(size_t emitterId, EventCallback event, bool coalesce) {
+	m_events.push(new Node{ 
+		coalesce ? NodeType::coalescedEvent : NodeType::event, 
+		emitterId, 
+		std::move(event), 
+		nullptr 
+	});
+}
+
+void EventQueue::removeEvent(size_t emitterId) {
+	//Pending events can not be accessed without locking, so a removal mark 
+	//is added instead. All the previous events of the emitter will be 
+	//discarded when processing it
+	m_events.push(new Node{ NodeType::removal, emitterId, EventCallback(), nullptr });
 }
 
 void EventQueue::process() {
-	//Populate the processing event list
-	{
-		std::lock_guard<std::mutex> lock(m_mutex);
-		std::swap(m_processingEvents, m_pendingEvents);
-		assert(m_pendingEvents.size() == 0);
+	//Take all the pending events at once. They're listed from the newest to the oldest
+	Node* list = filter(m_events.popAll());
+
+	//Call all events. As they've been taken out of the queue no deadlocks will occur
+	while(list) {
+		std::unique_ptr<Node> node(list);
+		list = node->next;
+		Utils::invokeIf(node->event);
+	}
+}
+
+
+
+EventQueue::Node* EventQueue::filter(Node* list) {
+	Node* result = nullptr;
+	m_removedEmitters.clear();
+	m_coalescedEmitters.clear();
+
+	//Traverse the list from the newest to the oldest. This way, only the latest 
+	//coalesced event of each emitter is kept and the events prior to a removal 
+	//are discarded. As the kept events are pushed at the front of the result, it
+	//ends up in chronological order
+	while(list) {
+		std::unique_ptr<Node> node(list);
+		list = node->next;
+
+		bool keep;
+		switch(node->type) {
+		case NodeType::removal:
+			insertEmitter(m_removedEmitters, node->emitterId);
+			keep = false;
+			break;
+
+		case NodeType::coalescedEvent:
+			keep = 	!std::binary_search(m_removedEmitters.cbegin(), m_removedEmitters.cend(), node->emitterId) &&
+					insertEmitter(m_coalescedEmitters, node->emitterId);
+			break;
+
+		default: //NodeType::event
+			keep = !std::binary_search(m_removedEmitters.cbegin(), m_removedEmitters.cend(), node->emitterId);
+			break;
+		}
+
+		if(keep) {
+			node->next = result;
+			result = node.release();
+		}
 	}
 
-	//Call all events. In order to avoid deadlocks we'll work on a copy
-	for(const auto& event : m_processingEvents) {
-		Utils::invokeIf(event.second);
+	return result;
+}
+
+bool EventQueue::insertEmitter(std::vector<size_t>& emitters, size_t emitterId) {
+	//Keep it sorted for binary searches. Returns true if it was not present
+	const auto ite = std::lower_bound(emitters.cbegin(), emitters.cend(), emitterId);
+	const bool result = (ite == emitters.cend()) || (*ite != emitterId);
+
+	if(result) {
+		emitters.insert(ite, emitterId);
 	}
-	m_processingEvents.clear();
+
+	return result;
 }
 
-}
\ No newline at end of file
+}
@@ -1,8 +1,9 @@
 #pragma once
 
+#include "IntrusiveStack.h"
+
 #include <vector>
 #include <functional>
-#include <mutex>
 
 namespace Zuazo::Timing {
 
@@ -10,20 +11,40 @@ class EventQueue {
 public:
 	using EventCallback = std::function<void()>;
 
-	EventQueue() = default;
-	~EventQueue() = default;
+	EventQueue();
+	EventQueue(const EventQueue& other) = delete;
+	~EventQueue();
+
+	EventQueue&					operator=(const EventQueue& other) = delete;
 
-	void 						addEvent(size_t emitterId, EventCallback event);
+	void 						addEvent(size_t emitterId, EventCallback event, bool coalesce = false);
+	//Does not wait for the events being processed. process() must be serialized
+	//with the caller to guarantee that none of the emitter's events runs afterwards
 	void						removeEvent(size_t emitterId);
 	void 						process();
 
 private:
-	using Event = std::pair<size_t, EventCallback>;
+	enum class NodeType {
+		event,
+		coalescedEvent,
+		removal
+	};
+
+	struct Node {
+		NodeType					type;
+		size_t						emitterId;
+		EventCallback				event;
+		Node*						next;
+	};
+
+	IntrusiveStack<Node>		m_events;
+
+	std::vector<size_t>			m_removedEmitters;
+	std::vector<size_t>			m_coalescedEmitters;
 
-	std::mutex					m_mutex;
-	std::vector<Event>			m_pendingEvents;
-	std::vector<Event>			m_processingEvents;
+	Node*						filter(Node* list);
+	static bool					insertEmitter(std::vector<size_t>& emitters, size_t emitterId);
 
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+
+namespace Zuazo::Timing {
+
+/**
+ * Lock-free multi-producer stack of heap allocated nodes, linked through their
+ * next member. The consumer takes all of them at once, newest first. Nodes are
+ * owned by the stack until taken.
+ */
+template<typename T>
+class IntrusiveStack {
+public:
+	using Node = T;
+
+	IntrusiveStack() noexcept;
+	IntrusiveStack(const IntrusiveStack& other) = delete;
+	~IntrusiveStack();
+
+	IntrusiveStack&				operator=(const IntrusiveStack& other) = delete;
+
+	void						push(Node* node) noexcept;
+	Node*						popAll() noexcept;
+
+	static Node*				reverse(Node* list) noexcept;
+	static void					destroy(Node* list) noexcept;
+
+private:
+	std::atomic<Node*>			m_head;
+
+};
+
+}
+
+#include "IntrusiveStack.inl"
\ No newline at end of file
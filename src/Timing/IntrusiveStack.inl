@@ -0,0 +1,57 @@
+#include "IntrusiveStack.h"
+
+#include <memory>
+
+namespace Zuazo::Timing {
+
+template<typename T>
+inline IntrusiveStack<T>::IntrusiveStack() noexcept
+	: m_head(nullptr)
+{
+}
+
+template<typename T>
+inline IntrusiveStack<T>::~IntrusiveStack() {
+	destroy(popAll());
+}
+
+
+
+template<typename T>
+inline void IntrusiveStack<T>::push(Node* node) noexcept {
+	//Push it at the front of the list. No locks are involved, so that
+	//producers never wait for the consumer nor for each other
+	node->next = m_head.load(std::memory_order_relaxed);
+	while(!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template<typename T>
+inline typename IntrusiveStack<T>::Node* IntrusiveStack<T>::popAll() noexcept {
+	return m_head.exchange(nullptr, std::memory_order_acquire);
+}
+
+
+
+template<typename T>
+inline typename IntrusiveStack<T>::Node* IntrusiveStack<T>::reverse(Node* list) noexcept {
+	Node* result = nullptr;
+
+	while(list) {
+		Node* next = list->next;
+		list->next = result;
+		result = list;
+		list = next;
+	}
+
+	return result;
+}
+
+template<typename T>
+inline void IntrusiveStack<T>::destroy(Node* list) noexcept {
+	while(list) {
+		std::unique_ptr<Node> node(list);
+		list = node->next;
+	}
+}
+
+}
\ No newline at end of file
@@ -2,19 +2,41 @@
 
 #include "Scheduler.h"
 
+#include <zuazo/Utils/Functions.h>
+
+#include <algorithm>
+
+#if defined(__linux__)
+	#include <pthread.h>
+	#include <sched.h>
+	#include <sys/resource.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
 namespace Zuazo::Timing {
 
-MainLoop::MainLoop(Scheduler& scheduler, std::mutex& mutex)
+MainLoop::MainLoop(Scheduler& scheduler, std::mutex& mutex, std::atomic<size_t>& lockRequests)
 	: m_scheduler(scheduler)
 	, m_mutex(mutex)
+	, m_lockRequests(lockRequests)
 	, m_exit(false)
+	, m_mode(Mode::realTime)
+	, m_resync(false)
+	, m_spinDuration(Duration::zero())
+	, m_jitterHistogram{}
+	, m_jitterMutex()
+	, m_condition()
+	, m_threadId(0)
 	, m_thread(&MainLoop::threadFunc, this)
 {
 }
 
 MainLoop::~MainLoop() {
 	//Indicate the main thread to finish
+	++m_lockRequests;
 	std::unique_lock<std::mutex> lock(m_mutex);
+	--m_lockRequests;
 	m_exit = true;
 	interrupt();
 	lock.unlock();
@@ -23,33 +45,234 @@ MainLoop::~MainLoop() {
 	m_thread.join();
 }
 
+
+
+void MainLoop::setMode(Mode mode) {
+	//The caller holds m_mutex, so the loop is either waiting on the condition
+	//variable or spinning with it released (and re-checks the mode afterwards)
+	if(mode != m_mode.load()) {
+		//When going back to real time, the virtual clock may be way off
+		m_resync = (mode == Mode::realTime);
+		m_mode.store(mode);
+		interrupt();
+	}
+}
+
+MainLoop::Mode MainLoop::getMode() const noexcept {
+	return m_mode.load();
+}
+
+
+
+void MainLoop::step() {
+	//Advance the virtual clock until the next event. If there are no events, update at the same time point
+	const auto remaining = m_scheduler.getTimeForNextEvent();
+	if(remaining == Duration::max()) {
+		const auto newTime = m_scheduler.getTime();
+		m_scheduler.setEpoch(newTime);
+		m_scheduler.gotoTime(newTime);
+	} else {
+		m_scheduler.gotoTime(m_scheduler.getTime() + remaining);
+	}
+}
+
 void MainLoop::interrupt() {
 	m_condition.notify_all();
 }
 
+
+
+void MainLoop::setSpinDuration(Duration duration) noexcept {
+	m_spinDuration = std::max(duration, Duration::zero());
+}
+
+Duration MainLoop::getSpinDuration() const noexcept {
+	return m_spinDuration;
+}
+
+
+bool MainLoop::setThreadScheduling(ThreadPolicy policy, int priority) noexcept {
+#if defined(__linux__)
+	//Obtain the native policy and its static priority. For the normal 
+	//policy the priority is interpreted as a nice value
+	int nativePolicy;
+	sched_param param = {};
+	switch(policy) {
+	case ThreadPolicy::fifo: 		nativePolicy = SCHED_FIFO; param.sched_priority = priority; break;
+	case ThreadPolicy::roundRobin: 	nativePolicy = SCHED_RR; param.sched_priority = priority; break;
+	default: 						nativePolicy = SCHED_OTHER; param.sched_priority = 0; break;
+	}
+
+	if(pthread_setschedparam(m_thread.native_handle(), nativePolicy, &param) != 0) {
+		return false;
+	}
+
+	if(policy == ThreadPolicy::normal) {
+		//Nice values are per thread on Linux. Wait until the thread has published its id
+		int threadId;
+		while((threadId = m_threadId.load()) == 0) {
+			std::this_thread::yield();
+		}
+
+		if(setpriority(PRIO_PROCESS, static_cast<id_t>(threadId), priority) != 0) {
+			return false;
+		}
+	}
+
+	return true;
+#else
+	Utils::ignore(policy, priority);
+	return false;
+#endif
+}
+
+bool MainLoop::setThreadAffinity(Utils::BufferView<const size_t> cpus) noexcept {
+#if defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+
+	if(cpus.empty()) {
+		//Allow all the CPUs
+		for(size_t i = 0; i < CPU_SETSIZE; ++i) {
+			CPU_SET(i, &cpuSet);
+		}
+	} else {
+		for(const auto cpu : cpus) {
+			if(cpu >= CPU_SETSIZE) {
+				return false;
+			}
+			CPU_SET(cpu, &cpuSet);
+		}
+	}
+
+	return pthread_setaffinity_np(m_thread.native_handle(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+	Utils::ignore(cpus);
+	return false;
+#endif
+}
+
+
+MainLoop::JitterHistogram MainLoop::getJitterHistogram() const {
+	//The histogram has its own lock, so that it can be read while the loop is running
+	std::lock_guard<std::mutex> lock(m_jitterMutex);
+	return m_jitterHistogram;
+}
+
+void MainLoop::clearJitterHistogram() {
+	std::lock_guard<std::mutex> lock(m_jitterMutex);
+	m_jitterHistogram.fill(0);
+}
+
+
+
 void MainLoop::threadFunc() {
+#if defined(__linux__)
+	m_threadId.store(static_cast<int>(syscall(SYS_gettid)));
+#endif
+
 	std::unique_lock<std::mutex> lock(m_mutex);
 
 	while(!m_exit) {
-		const auto remaining = m_scheduler.getTimeForNextEvent();
-		if(remaining == Duration::max()) {
-			//No events ahead
+		switch(m_mode.load()) {
+		case Mode::realTime:
+			realTimeIteration(lock);
+			break;
+
+		case Mode::virtualTime:
+			virtualTimeIteration(lock);
+			break;
+
+		default: //Mode::manual
+			//Updates are made by step(). Sleep until the mode changes
 			m_condition.wait(lock);
+			break;
+		}
+	}
+}
+
+void MainLoop::realTimeIteration(std::unique_lock<std::mutex>& lock) {
+	if(m_resync) {
+		//Coming back from a virtual clock. Start over at the current time
+		const auto newTime = now();
+		m_scheduler.setEpoch(newTime);
+		m_scheduler.gotoTime(newTime);
+		m_resync = false;
+		return;
+	}
+
+	const auto remaining = m_scheduler.getTimeForNextEvent();
+	if(remaining == Duration::max()) {
+		//No events ahead
+		m_condition.wait(lock);
 
-			//Update the time after sleeping for that much
+		//Update the time after sleeping for that much
+		if(!m_exit && m_mode == Mode::realTime) {
 			const auto newTime = now();
 			m_scheduler.setEpoch(newTime);
 			m_scheduler.gotoTime(newTime); //Will update everything
-		} else {
-			const auto newTime = m_scheduler.getTime() + remaining;
+		}
+	} else {
+		const auto newTime = m_scheduler.getTime() + remaining;
 
-			//Wait until the moment arises
-			if(m_condition.wait_until(lock, newTime) == std::cv_status::timeout) {
-				//Waiting was not interrupted. Update the scheduler
-				m_scheduler.gotoTime(newTime);
+		//Sleep until the moment arises. If requested, wake up a bit earlier and spin 
+		//the remaining time, as sleeping is not accurate enough
+		if(m_condition.wait_until(lock, newTime - m_spinDuration) == std::cv_status::timeout) {
+			//Waiting was not interrupted
+			if(m_spinDuration > Duration::zero()) {
+				lock.unlock();
+				waitUntil(newTime);
+				lock.lock();
+
+				if(m_exit || m_mode != Mode::realTime) {
+					return; //Things have changed while spinning
+				}
 			}
+
+			//Update the scheduler
+			recordJitter(now() - newTime);
+			m_scheduler.gotoTime(newTime);
+		}
+	}
+}
+
+void MainLoop::virtualTimeIteration(std::unique_lock<std::mutex>& lock) {
+	const auto remaining = m_scheduler.getTimeForNextEvent();
+	if(remaining == Duration::max()) {
+		//No events ahead. Nothing to render until something changes
+		m_condition.wait(lock);
+
+		if(!m_exit && m_mode == Mode::virtualTime) {
+			step();
+		}
+	} else {
+		//Do not wait, jump straight to the next event
+		step();
+
+		//Let the threads waiting for the lock acquire it between updates.
+		//Otherwise this thread would relock it before they wake up
+		lock.unlock();
+		while(m_lockRequests.load() > 0) {
+			std::this_thread::yield();
 		}
+		lock.lock();
 	}
 }
 
+void MainLoop::waitUntil(TimePoint tp) {
+	while(now() < tp) {
+		std::this_thread::yield();
+	}
+}
+
+void MainLoop::recordJitter(Duration jitter) {
+	const auto index = std::min(
+		static_cast<size_t>(std::max(jitter, Duration::zero()) / JITTER_HISTOGRAM_RESOLUTION),
+		m_jitterHistogram.size() - 1
+	);
+
+	std::lock_guard<std::mutex> lock(m_jitterMutex);
+	++m_jitterHistogram[index];
+}
+
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <zuazo/Chrono.h>
+#include <zuazo/JitterHistogram.h>
+
+#include <zuazo/Utils/BufferView.h>
 
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 
 namespace Zuazo::Timing {
 
@@ -12,23 +16,65 @@ class Scheduler;
 
 class MainLoop {
 public:
-	MainLoop(Scheduler& scheduler, std::mutex& mutex);
+	enum class Mode {
+		realTime,
+		virtualTime,
+		manual
+	};
+
+	enum class ThreadPolicy {
+		normal,
+		fifo,
+		roundRobin
+	};
+
+	using JitterHistogram = Zuazo::JitterHistogram;
+
+	MainLoop(Scheduler& scheduler, std::mutex& mutex, std::atomic<size_t>& lockRequests);
 	MainLoop(const MainLoop& other) = delete;
 	~MainLoop();
 
 	MainLoop&				operator=(const MainLoop& other) = delete;
 
+	void					setMode(Mode mode);
+	Mode					getMode() const noexcept;
+
+	void					step();
 	void					interrupt();
+
+	void					setSpinDuration(Duration duration) noexcept;
+	Duration				getSpinDuration() const noexcept;
+
+	bool					setThreadScheduling(ThreadPolicy policy, int priority) noexcept;
+	bool					setThreadAffinity(Utils::BufferView<const size_t> cpus) noexcept;
+
+	JitterHistogram			getJitterHistogram() const;
+	void					clearJitterHistogram();
+
 private:
 	Scheduler& 				m_scheduler;
 	std::mutex&				m_mutex;
+	std::atomic<size_t>&	m_lockRequests;
 
+	//m_mode and m_resync are written with m_mutex held. m_mode is atomic so
+	//that it can be queried from any thread
 	bool					m_exit;
+	std::atomic<Mode>		m_mode;
+	bool					m_resync;
+	Duration				m_spinDuration;
+	JitterHistogram			m_jitterHistogram;
+	mutable std::mutex		m_jitterMutex;
 
-	std::thread 			m_thread;
+	//The condition variable must be constructed before the thread starts waiting on it
 	std::condition_variable m_condition;
+	std::atomic<int>		m_threadId;
+	std::thread 			m_thread;
 
 	void 					threadFunc();
+	void					waitUntil(TimePoint tp);
+	void					recordJitter(Duration jitter);
+	void					realTimeIteration(std::unique_lock<std::mutex>& lock);
+	void					virtualTimeIteration(std::unique_lock<std::mutex>& lock);
 };
 
-}
\ No newline at end of file
+}
@@ -5,11 +5,18 @@
 #include <map>
 #include <algorithm>
 #include <numeric>
+#include <cassert>
 
 namespace Zuazo::Timing {
 
 void Scheduler::setEpoch(TimePoint tp) noexcept  {
 	m_epoch = tp;
+
+	//All the periods start over at the new epoch
+	for(auto& deadline : m_deadlines) {
+		deadline.first = m_epoch;
+	}
+	std::make_heap(m_deadlines.begin(), m_deadlines.end(), compareDeadlines);
 }
 
 TimePoint Scheduler::getEpoch() const noexcept  {
@@ -22,41 +29,34 @@ void Scheduler::gotoTime(TimePoint tp)  {
 		m_deltaT = tp - m_currTime;
 		m_currTime = tp;
 
-		//Clear the update set to start over
-		m_calls.clear();
-
-		//Insert the regular updates
-		m_calls.insert(
-			m_calls.cend(), 
-			m_regularCallbacks.cbegin(), 
-			m_regularCallbacks.cend()
-		);
-
-		//Insert the periodic callbacks
-		for(const auto& period : m_periodicCallbacks){
-			if((m_currTime - m_epoch) % period.first == Duration::zero()){
-				//This period needs to be updated
-				m_calls.insert(
-					m_calls.cend(),
-					period.second.cbegin(), 
-					period.second.cend()
-				);
-			}
+		//Gather the already sorted callback sets that need to be called
+		m_activeRanges.clear();
+		m_activeRanges.emplace_back(m_regularCallbacks.cbegin(), m_regularCallbacks.cend());
+
+		while(!m_deadlines.empty() && m_deadlines.front().first <= m_currTime) {
+			//This period needs to be updated. Take it out of the heap
+			std::pop_heap(m_deadlines.begin(), m_deadlines.end(), compareDeadlines);
+			auto& deadline = m_deadlines.back();
+			const auto& period = *(deadline.second);
+			m_activeRanges.emplace_back(period.second.cbegin(), period.second.cend());
+
+			//Reschedule it. Deadlines are always computed from the epoch, so that
+			//rounding errors are not accumulated. Missed deadlines are skipped
+			deadline.first = getNextDeadline(period.first, m_currTime);
+			assert(deadline.first > m_currTime);
+			std::push_heap(m_deadlines.begin(), m_deadlines.end(), compareDeadlines);
 		}
 
-		//Sort the callbacks from higher priorities to lower ones
-		std::stable_sort(
-			m_calls.begin(), 
-			m_calls.end(), 
-			[](const auto& a, const auto& b) -> bool {
-				return a.first > b.first;
-			}
-		);
+		//Merge them into the call list. No sorting is needed
+		mergeActiveRanges();
 
 		//Call all
-		for(const auto& c : m_calls){
-			const Callback& callback = c.second;
-			Utils::invokeIf(callback);
+		if(m_profilingEnabled) {
+			const auto begin = Clock::now();
+			invokeCalls();
+			profileTick(std::chrono::duration_cast<Duration>(Clock::now() - begin));
+		} else {
+			invokeCalls();
 		}
 }
 
@@ -70,69 +70,60 @@ Duration Scheduler::getDeltaT() const noexcept {
 
 
 Duration Scheduler::getTimeForNextEvent() const noexcept {
-	//Calculate the minumum remaining time
+	//The closest deadline is at the top of the heap
 	auto result = Duration::max();
 
-	for(const auto& period : m_periodicCallbacks) {
-		const auto nextUpdate = ((m_currTime - m_epoch) / period.first + 1) * period.first + m_epoch;
-		const auto remaining = nextUpdate - m_currTime;
-
-		if(remaining < result){
-			result = remaining;
-		}
+	if(!m_deadlines.empty()) {
+		result = std::max(m_deadlines.front().first - m_currTime, Duration::zero());
 	}
 
 	return result;
 }
 
 void Scheduler::addRegularCallback(const Callback& cbk, Priority prior) {
-	m_regularCallbacks.emplace_back(prior, cbk);
+	insertCallback(m_regularCallbacks, cbk, prior);
+
+	if(m_profilingEnabled) {
+		m_profiles.try_emplace(&cbk);
+	}
 }
 
 void Scheduler::removeRegularCallback(const Callback& cbk) {
-	const auto end = std::remove_if(
-		m_regularCallbacks.begin(), 
-		m_regularCallbacks.end(), 
-		[&] (const auto& e) -> bool {
-			return &(e.second.get()) == &cbk;
-		}
-	);
-
-	m_regularCallbacks.erase(end, m_regularCallbacks.end());
+	eraseCallback(m_regularCallbacks, cbk);
+	m_profiles.erase(&cbk);
 }
 
 
 void Scheduler::addPeriodicCallback(const Callback& cbk, Priority prior, Duration period) {
-	auto ite = m_periodicCallbacks.find(period);
+	insertPeriodicCallback(cbk, prior, Period(period.count()));
+}
 
-	if(ite == m_periodicCallbacks.cend()){
-		//Period does not exist. Create it.
-		m_periodicCallbacks.emplace(
-			period, 
-			CallbackSet{ CallbackSet::value_type(prior, cbk) } //Compare callback's pointers
-		);			
-	} else {
-		ite->second.emplace_back(prior, cbk);
-	}
+void Scheduler::addPeriodicCallback(const Callback& cbk, Priority prior, Rate rate) {
+	//Obtain the period in Duration units
+	const Rate ticksPerSecond(Duration::period::den, Duration::period::num);
+	insertPeriodicCallback(cbk, prior, Period(ticksPerSecond / rate));
 }
 
 void Scheduler::removePeriodicCallback(const Callback& cbk) {
+	m_profiles.erase(&cbk);
 	auto ite = m_periodicCallbacks.begin();
 
 	while(ite != m_periodicCallbacks.end()) {
 		//Erase it
-		const auto end = std::remove_if(
-			ite->second.begin(), 
-			ite->second.end(), 
-			[&] (const auto& e) -> bool {
-				return &(e.second.get()) == &cbk; //Compare callback's pointers
-			}
-		);
-
-		ite->second.erase(end, ite->second.end());
+		eraseCallback(ite->second, cbk);
 
 		if(ite->second.size() == 0){
-			//No more callbacks of this period
+			//No more callbacks of this period. Remove also its deadline
+			const auto deadline = std::find_if(
+				m_deadlines.cbegin(), m_deadlines.cend(),
+				[ite] (const Deadline& d) -> bool {
+					return d.second == ite;
+				}
+			);
+			assert(deadline != m_deadlines.cend());
+			m_deadlines.erase(deadline);
+			std::make_heap(m_deadlines.begin(), m_deadlines.end(), compareDeadlines);
+
 			ite = m_periodicCallbacks.erase(ite);
 		} else {
 			++ite; //Advance
@@ -140,4 +131,244 @@ void Scheduler::removePeriodicCallback(const Callback& cbk) {
 	}
 }
 
+
+void Scheduler::insertPeriodicCallback(const Callback& cbk, Priority prior, const Period& period) {
+	assert(period > Period());
+	auto ite = m_periodicCallbacks.find(period);
+
+	if(ite == m_periodicCallbacks.end()){
+		//Period does not exist. Create it and schedule its first deadline
+		m_deadlines.reserve(m_deadlines.size() + 1);
+		ite = m_periodicCallbacks.emplace(period, CallbackSet()).first;
+		m_deadlines.emplace_back(getNextDeadline(period, m_currTime), ite);
+		std::push_heap(m_deadlines.begin(), m_deadlines.end(), compareDeadlines);
+	}
+
+	insertCallback(ite->second, cbk, prior);
+
+	if(m_profilingEnabled) {
+		m_profiles.try_emplace(&cbk);
+	}
+}
+
+TimePoint Scheduler::getNextDeadline(const Period& period, TimePoint tp) const noexcept {
+	//The n-th deadline of a period is located at epoch + floor(n * period). Find the
+	//first n such that the deadline is after tp. Computations are split into quotient
+	//and remainder in order to avoid overflows
+	const auto num = period.getNumerator();
+	const auto den = period.getDenominator();
+	assert(num > 0 && den > 0);
+
+	Duration::rep index = 0;
+	const auto elapsed = (tp - m_epoch).count() + 1;
+	if(elapsed > 0) {
+		index = (elapsed / num) * den + ((elapsed % num) * den + num - 1) / num;
+	}
+
+	const auto result = m_epoch + Duration((index / den) * num + ((index % den) * num) / den);
+	assert(result > tp);
+	return result;
+}
+
+
+
+void Scheduler::setWorkerThreadCount(size_t count) {
+	if(count != getWorkerThreadCount()) {
+		m_workers.reset(); //Wait for the old threads before spawning the new ones
+		if(count > 0) {
+			m_workers = Utils::makeUnique<WorkerPool>(count);
+		}
+	}
+
+	assert(getWorkerThreadCount() == count);
+}
+
+size_t Scheduler::getWorkerThreadCount() const noexcept {
+	return m_workers ? m_workers->getThreadCount() : 0;
+}
+
+
+void Scheduler::setProfilingEnabled(bool ena) {
+	if(ena != m_profilingEnabled) {
+		clearProfiles();
+		m_profiles.clear();
+
+		if(ena) {
+			//Create the profiles in advance, so that the map is not
+			//modified when callbacks are executed concurrently
+			for(const auto& c : m_regularCallbacks) {
+				m_profiles.try_emplace(&(c.second.get()));
+			}
+
+			for(const auto& period : m_periodicCallbacks) {
+				for(const auto& c : period.second) {
+					m_profiles.try_emplace(&(c.second.get()));
+				}
+			}
+		}
+
+		m_profilingEnabled = ena;
+	}
+}
+
+bool Scheduler::getProfilingEnabled() const noexcept {
+	return m_profilingEnabled;
+}
+
+const CallbackProfile* Scheduler::getCallbackProfile(const Callback& cbk) const noexcept {
+	const auto ite = m_profiles.find(&cbk);
+	return (ite != m_profiles.cend()) ? &(ite->second) : nullptr;
+}
+
+size_t Scheduler::getTickCount() const noexcept {
+	return m_tickCount;
+}
+
+size_t Scheduler::getDeadlineMissCount() const noexcept {
+	return m_deadlineMissCount;
+}
+
+void Scheduler::clearProfiles() noexcept {
+	for(auto& profile : m_profiles) {
+		profile.second.clear();
+	}
+
+	m_tickCount = 0;
+	m_deadlineMissCount = 0;
+}
+
+
+
+void Scheduler::mergeActiveRanges() {
+	//Clear the call list to start over. Capacity is preserved, so usually no allocations are made
+	m_calls.clear();
+
+	if(m_activeRanges.size() == 1) {
+		//Trivial case, only the regular callbacks. Simply copy them
+		m_calls.insert(m_calls.cend(), m_activeRanges.front().first, m_activeRanges.front().second);
+	} else {
+		//Merge all the sorted ranges. As there are just a few active ranges 
+		//at once, a linear search for the highest priority is used
+		while(true) {
+			auto best = m_activeRanges.end();
+
+			for(auto ite = m_activeRanges.begin(); ite != m_activeRanges.end(); ++ite) {
+				if(ite->first != ite->second) {
+					//Only replace on strictly higher priorities, so that 
+					//callbacks with the same priority keep the order of the ranges
+					if(best == m_activeRanges.end() || ite->first->first > best->first->first) {
+						best = ite;
+					}
+				}
+			}
+
+			if(best == m_activeRanges.end()) {
+				break; //All ranges have been consumed
+			}
+
+			m_calls.push_back(*(best->first));
+			++(best->first);
+		}
+	}
+}
+
+void Scheduler::invokeCalls() {
+	if(m_workers) {
+		//Callbacks of the same priority are executed concurrently. The
+		//next priority band does not start until the previous one ends
+		auto bandBegin = m_calls.cbegin();
+		while(bandBegin != m_calls.cend()) {
+			const auto bandEnd = std::find_if(
+				bandBegin, m_calls.cend(),
+				[prior = bandBegin->first] (const auto& c) -> bool {
+					return c.first != prior;
+				}
+			);
+
+			const auto bandSize = static_cast<size_t>(std::distance(bandBegin, bandEnd));
+			if(bandSize > 1) {
+				m_workers->parallelFor(
+					bandSize,
+					[this, bandBegin] (size_t i) {
+						invoke((bandBegin + i)->second);
+					}
+				);
+			} else {
+				invoke(bandBegin->second);
+			}
+
+			bandBegin = bandEnd;
+		}
+	} else {
+		//Serial execution
+		for(const auto& c : m_calls){
+			invoke(c.second);
+		}
+	}
+}
+
+void Scheduler::invoke(const Callback& cbk) {
+	if(m_profilingEnabled) {
+		const auto begin = Clock::now();
+		Utils::invokeIf(cbk);
+		const auto elapsed = std::chrono::duration_cast<Duration>(Clock::now() - begin);
+
+		//Profile should have been created in advance
+		const auto ite = m_profiles.find(&cbk);
+		if(ite != m_profiles.end()) {
+			ite->second.record(elapsed);
+		}
+	} else {
+		Utils::invokeIf(cbk);
+	}
+}
+
+void Scheduler::profileTick(Duration elapsed) noexcept {
+	++m_tickCount;
+
+	//Consider a deadline missed if the update takes longer than the fastest period
+	if(!m_periodicCallbacks.empty()) {
+		const auto& fastestPeriod = m_periodicCallbacks.cbegin()->first;
+		if(elapsed > Duration(static_cast<Duration::rep>(static_cast<Period::Integer>(fastestPeriod)))) {
+			++m_deadlineMissCount;
+		}
+	}
+}
+
+void Scheduler::insertCallback(CallbackSet& set, const Callback& cbk, Priority prior) {
+	//Insert it after the last element with the same priority, so that insertion order is kept
+	const auto pos = std::upper_bound(
+		set.cbegin(), set.cend(),
+		prior,
+		[] (Priority p, const auto& e) -> bool {
+			return p > e.first;
+		}
+	);
+
+	set.emplace(pos, prior, cbk);
+	assert(std::is_sorted(
+		set.cbegin(), set.cend(),
+		[](const auto& a, const auto& b) -> bool {
+			return a.first > b.first;
+		}
+	));
+}
+
+bool Scheduler::compareDeadlines(const Deadline& a, const Deadline& b) noexcept {
+	//Used for a min-heap. In case of a tie, shorter periods come first
+	return (a.first != b.first) ? (a.first > b.first) : (b.second->first < a.second->first);
+}
+
+void Scheduler::eraseCallback(CallbackSet& set, const Callback& cbk) {
+	const auto end = std::remove_if(
+		set.begin(), 
+		set.end(), 
+		[&] (const auto& e) -> bool {
+			return &(e.second.get()) == &cbk; //Compare callback's pointers
+		}
+	);
+
+	set.erase(end, set.end());
+}
+
 }
\ No newline at end of file
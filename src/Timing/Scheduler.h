@@ -1,5 +1,8 @@
 #pragma once
 
+#include "WorkerPool.h"
+#include "CallbackProfile.h"
+
 #include <zuazo/Chrono.h>
 
 #include <limits>
@@ -7,6 +10,8 @@
 #include <utility>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <memory>
 
 namespace Zuazo::Timing {
 
@@ -36,19 +41,66 @@ public:
 	void					removeRegularCallback(const Callback& cbk);
 
 	void					addPeriodicCallback(const Callback& cbk, Priority prior, Duration period);
+	void					addPeriodicCallback(const Callback& cbk, Priority prior, Rate rate);
 	void					removePeriodicCallback(const Callback& cbk);
 
+	/**
+	 * Callbacks of the same priority are executed concurrently when there are
+	 * worker threads, so they must not depend on each other nor modify the 
+	 * scheduler. See Instance::setWorkerThreadCount()
+	 */
+	void					setWorkerThreadCount(size_t count);
+	size_t					getWorkerThreadCount() const noexcept;
+
+	void					setProfilingEnabled(bool ena);
+	bool					getProfilingEnabled() const noexcept;
+	const CallbackProfile*	getCallbackProfile(const Callback& cbk) const noexcept;
+	size_t					getTickCount() const noexcept;
+	size_t					getDeadlineMissCount() const noexcept;
+	void					clearProfiles() noexcept;
+
 private:
+	//All CallbackSets are kept sorted from higher to lower priorities
 	using CallbackSet = std::vector<std::pair<Priority, std::reference_wrapper<const Callback>>>;
-	using PeriodMap = std::map<Duration, CallbackSet>;
+	using CallbackRange = std::pair<CallbackSet::const_iterator, CallbackSet::const_iterator>;
+	using CallbackRanges = std::vector<CallbackRange>;
+
+	//Periods are expressed exactly in Duration units, so that non-integer 
+	//periods, such as the ones of NTSC frame rates, do not accumulate drift
+	using Period = Math::Rational<Duration::rep>;
+	using PeriodMap = std::map<Period, CallbackSet>;
+	using Deadline = std::pair<TimePoint, PeriodMap::iterator>;
+	using DeadlineHeap = std::vector<Deadline>;
+	using ProfileMap = std::unordered_map<const Callback*, CallbackProfile>;
 
 	TimePoint				m_epoch;
 	TimePoint 				m_currTime;
 	Duration 				m_deltaT;
 	CallbackSet 			m_calls;
+	CallbackRanges			m_activeRanges;
 
 	CallbackSet 			m_regularCallbacks;
 	PeriodMap 				m_periodicCallbacks;
+	DeadlineHeap			m_deadlines;
+
+	std::unique_ptr<WorkerPool> m_workers;
+
+	bool					m_profilingEnabled = false;
+	ProfileMap				m_profiles;
+	size_t					m_tickCount = 0;
+	size_t					m_deadlineMissCount = 0;
+
+	void					insertPeriodicCallback(const Callback& cbk, Priority prior, const Period& period);
+	TimePoint				getNextDeadline(const Period& period, TimePoint tp) const noexcept;
+
+	void					mergeActiveRanges();
+	void					invokeCalls();
+	void					invoke(const Callback& cbk);
+	void					profileTick(Duration elapsed) noexcept;
+
+	static void				insertCallback(CallbackSet& set, const Callback& cbk, Priority prior);
+	static void				eraseCallback(CallbackSet& set, const Callback& cbk);
+	static bool				compareDeadlines(const Deadline& a, const Deadline& b) noexcept;
 	
 };
 
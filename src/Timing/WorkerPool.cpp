@@ -0,0 +1,122 @@
+#include "WorkerPool.h"
+
+#include <cassert>
+#include <utility>
+
+namespace Zuazo::Timing {
+
+WorkerPool::WorkerPool(size_t threadCount)
+	: m_threads()
+	, m_mutex()
+	, m_startCondition()
+	, m_finishCondition()
+	, m_exit(false)
+	, m_generation(0)
+	, m_busyThreads(0)
+	, m_task(nullptr)
+	, m_count(0)
+	, m_next(0)
+	, m_exception()
+{
+	m_threads.reserve(threadCount);
+	for(size_t i = 0; i < threadCount; ++i) {
+		m_threads.emplace_back(&WorkerPool::threadFunc, this);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	//Indicate all the workers to finish
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_exit = true;
+	m_startCondition.notify_all();
+	lock.unlock();
+
+	//Wait for them to return
+	for(auto& thread : m_threads) {
+		thread.join();
+	}
+}
+
+
+
+size_t WorkerPool::getThreadCount() const noexcept {
+	return m_threads.size();
+}
+
+
+
+void WorkerPool::parallelFor(size_t count, const Task& task) {
+	//Publish the job and wake up the workers
+	std::unique_lock<std::mutex> lock(m_mutex);
+	assert(m_busyThreads == 0);
+	m_task = &task;
+	m_count = count;
+	m_next.store(0);
+	m_busyThreads = m_threads.size();
+	++m_generation;
+	m_startCondition.notify_all();
+	lock.unlock();
+
+	//This thread also contributes to the job
+	execute();
+
+	//Wait until all the workers have finished. This acts as a barrier
+	lock.lock();
+	m_finishCondition.wait(lock, [this] { return m_busyThreads == 0; });
+	m_task = nullptr;
+
+	//Propagate the failure to the caller, as if it had been executed serially
+	if(m_exception) {
+		std::rethrow_exception(std::exchange(m_exception, nullptr));
+	}
+}
+
+
+
+void WorkerPool::execute() noexcept {
+	assert(m_task);
+
+	//Grab indices until all of them are consumed. This way idle threads 
+	//take the remaining work from the busy ones
+	size_t index;
+	while((index = m_next.fetch_add(1)) < m_count) {
+		try {
+			(*m_task)(index);
+		} catch(...) {
+			//Keep the first exception and stop handing out indices
+			m_next.store(m_count);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(!m_exception) {
+				m_exception = std::current_exception();
+			}
+		}
+	}
+}
+
+void WorkerPool::threadFunc() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	size_t generation = 0; //Initial generation. Do not read it, as a job could be already published
+
+	while(true) {
+		//Wait for a new job
+		m_startCondition.wait(lock, [this, generation] { return m_exit || m_generation != generation; });
+		if(m_exit) {
+			break;
+		}
+		generation = m_generation;
+
+		//Work on it
+		lock.unlock();
+		execute();
+		lock.lock();
+
+		//Notify when the last worker ends
+		assert(m_busyThreads > 0);
+		if(--m_busyThreads == 0) {
+			m_finishCondition.notify_all();
+		}
+	}
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+namespace Zuazo::Timing {
+
+class WorkerPool {
+public:
+	using Task = std::function<void(size_t)>;
+
+	explicit WorkerPool(size_t threadCount);
+	WorkerPool(const WorkerPool& other) = delete;
+	~WorkerPool();
+
+	WorkerPool&					operator=(const WorkerPool& other) = delete;
+
+	size_t						getThreadCount() const noexcept;
+
+	/**
+	 * Invokes task for each index in [0, count) using the workers and the calling
+	 * thread. Returns once all of them have finished. If a task throws, the remaining
+	 * indices are not started and the first exception is rethrown here.
+	 */
+	void						parallelFor(size_t count, const Task& task);
+
+private:
+	std::vector<std::thread>	m_threads;
+
+	std::mutex					m_mutex;
+	std::condition_variable		m_startCondition;
+	std::condition_variable		m_finishCondition;
+	bool						m_exit;
+	size_t						m_generation;
+	size_t						m_busyThreads;
+
+	const Task*					m_task;
+	size_t						m_count;
+	std::atomic<size_t>			m_next;
+	std::exception_ptr			m_exception;
+
+	void						execute() noexcept;
+	void						threadFunc();
+
+};
+
+}
@@ -0,0 +1,550 @@
+#include <zuazo/VideoLayer.h>
+
+#include <zuazo/Graphics/UniformRing.h>
+#include <zuazo/Graphics/VulkanConversions.h>
+#include <zuazo/Math/Transformations.h>
+#include <zuazo/Utils/StaticId.h>
+#include <zuazo/Utils/Hasher.h>
+
+#include <unordered_map>
+#include <mutex>
+#include <array>
+#include <memory>
+#include <tuple>
+#include <cassert>
+
+#include "../shaders/video_layer.h"
+
+namespace Zuazo {
+
+/*
+ * VideoLayer::Impl
+ */
+
+struct VideoLayer::Impl {
+	using PipelineKey = std::tuple<	vk::PipelineLayout,
+									bool, //Bindless
+									BlendingMode,
+									RenderingLayer,
+									uint32_t >;
+
+	/*
+	 * Matches LayerDataBlock in the shaders (std140)
+	 */
+	struct LayerData {
+		Math::Mat4x4f										modelMatrix;
+		float												opacity;
+		uint32_t											frameIndex;
+	};
+
+	/*
+	 * Stored per render pass with LayerBase::setRenderPassState()
+	 */
+	struct RenderPassState {
+		PipelineKey											key;
+		vk::Pipeline										pipeline;
+	};
+
+	std::reference_wrapper<const Graphics::Vulkan>		vulkan;
+	Math::Vec2f											size;
+	ScalingFilter										scalingFilter;
+	Video												video;
+
+	LayerData											layerData;
+	bool												layerDataChanged;
+	uint32_t											layerDataOffset;
+	Graphics::UniformRing								uniformRing;
+	Graphics::Vulkan::PooledDescriptorSet				descriptorSet;
+
+	Impl(	const Graphics::Vulkan& vulkan,
+			Math::Vec2f size )
+		: vulkan(vulkan)
+		, size(size)
+		, scalingFilter(ScalingFilter::linear)
+		, video()
+		, layerData()
+		, layerDataChanged(true)
+		, layerDataOffset(0)
+		, uniformRing(vulkan, sizeof(LayerData))
+		, descriptorSet(allocateDescriptorSet(vulkan, uniformRing))
+	{
+	}
+
+	~Impl() = default;
+
+
+	void setup(VideoLayer& layer) {
+		using namespace std::placeholders;
+
+		layer.setTransformCallback(std::bind(&Impl::transformCallback, std::ref(*this), _1, _2));
+		layer.setOpacityCallback(std::bind(&Impl::opacityCallback, std::ref(*this), _1, _2));
+		layer.setHasAlphaCallback(std::bind(&Impl::hasAlphaCallback, std::ref(*this), _1));
+		layer.setDrawCallback(std::bind(&Impl::drawCallback, std::ref(*this), _1, _2, _3));
+		layer.setRenderPassCallback(std::bind(&Impl::renderPassCallback, std::ref(*this), _1, _2));
+		layer.setStateKeyCallback(std::bind(&Impl::stateKeyCallback, std::ref(*this), _1, _2));
+
+		//Write the initial values
+		updateModelMatrix(layer.getTransform());
+		updateOpacity(layer.getOpacity());
+	}
+
+
+	const Graphics::Vulkan& getVulkan() const noexcept {
+		return vulkan;
+	}
+
+
+	void setSize(const LayerBase& base, Math::Vec2f s) {
+		if(size != s) {
+			size = s;
+			updateModelMatrix(base.getTransform());
+		}
+	}
+
+	Math::Vec2f getSize() const noexcept {
+		return size;
+	}
+
+
+	void setScalingFilter(ScalingFilter filter) {
+		scalingFilter = filter;
+	}
+
+	ScalingFilter getScalingFilter() const noexcept {
+		return scalingFilter;
+	}
+
+
+	void setVideo(Video v) {
+		video = std::move(v);
+	}
+
+	const Video& getVideo() const noexcept {
+		return video;
+	}
+
+private:
+	void transformCallback(LayerBase&, const Math::Transformf& transform) {
+		updateModelMatrix(transform);
+	}
+
+	void opacityCallback(LayerBase&, float opacity) {
+		updateOpacity(opacity);
+	}
+
+	void renderPassCallback(LayerBase& base, vk::RenderPass renderPass) {
+		//Called only when there is no state cached for this render pass.
+		//The pipeline is created on the first draw, as it also depends
+		//on the frame
+		if(renderPass) {
+			static_cast<VideoLayer&>(base).setRenderPassState(std::make_shared<RenderPassState>());
+		}
+	}
+
+	bool hasAlphaCallback(const LayerBase&) const {
+		return video && hasAlpha(video->getDescriptor()->getColorFormat());
+	}
+
+	size_t stateKeyCallback(const LayerBase& base, const RendererBase&) const {
+		//Use the pipeline of the last draw. 0 if not created yet
+		const auto* state = getRenderPassState(base);
+		return (state && state->pipeline) ? Utils::Hasher<vk::Pipeline>()(state->pipeline) : 0;
+	}
+
+	void drawCallback(const LayerBase& base, const RendererBase&, Graphics::CommandBuffer& cmd) {
+		auto* state = getRenderPassState(base);
+		if(!video || !state) {
+			return; //Nothing to draw
+		}
+
+		//Sample the frame through the bindless table when available, so 
+		//that changing it only requires updating the index
+		const Graphics::Frame& frame = *video;
+		const bool bindless = vulkan.get().getBindlessSupport();
+		const auto pipelineLayout = getPipelineLayout(
+			vulkan, 
+			bindless ? vulkan.get().getBindlessDescriptorSetLayout() : frame.getDescriptorSetLayout(scalingFilter)
+		);
+		const PipelineKey key(
+			pipelineLayout,
+			bindless,
+			base.getBlendingMode(),
+			base.getRenderingLayer(),
+			frame.getSamplingMode(scalingFilter)
+		);
+
+		//Only look up the pipeline again when the configuration has changed
+		if(!state->pipeline || state->key != key) {
+			state->pipeline = createPipeline(vulkan, base.getRenderPass(), key);
+			state->key = key;
+		}
+		assert(state->pipeline);
+
+		if(bindless) {
+			const auto frameIndex = frame.getBindlessIndex(scalingFilter);
+			if(layerData.frameIndex != frameIndex) {
+				layerData.frameIndex = frameIndex;
+				layerDataChanged = true;
+			}
+		}
+
+		//Write the layer data into the next region of the ring when it has changed.
+		//Leaving the current region marks it as used until the pending batch, so 
+		//that it is not overwritten while the draws using it are in flight
+		if(layerDataChanged) {
+			uniformRing.advance(vulkan);
+			layerDataOffset = uniformRing.write(&layerData, sizeof(layerData));
+			uniformRing.flush(vulkan);
+			layerDataChanged = false;
+		}
+
+		cmd.bindPipeline(
+			vk::PipelineBindPoint::eGraphics,			//Pipeline bind point
+			state->pipeline								//Pipeline
+		);
+
+		cmd.bindDescriptorSets(
+			vk::PipelineBindPoint::eGraphics,			//Pipeline bind point
+			pipelineLayout,								//Pipeline layout
+			vl_LAYER_DESCRIPTOR_SET,					//First index
+			*descriptorSet,								//Descriptor sets
+			layerDataOffset								//Dynamic offsets
+		);
+
+		if(bindless) {
+			Graphics::Frame::bindBindless(cmd, pipelineLayout, vl_FRAME_DESCRIPTOR_SET);
+		} else {
+			frame.bind(cmd, pipelineLayout, vl_FRAME_DESCRIPTOR_SET, scalingFilter);
+		}
+
+		//Keep the frame alive while the command buffer uses its descriptors
+		const std::array dependencies = {
+			Graphics::CommandBuffer::Dependency(video)
+		};
+		cmd.addDependencies(dependencies);
+
+		cmd.draw(vl_VERTEX_COUNT, 1, 0, 0);
+	}
+
+
+	void updateModelMatrix(const Math::Transformf& transform) {
+		//Scale the unit square to the requested size before transforming it
+		layerData.modelMatrix = Math::scale(transform.calculateMatrix(), Math::Vec3f(size.x, size.y, 1.0f));
+		layerDataChanged = true;
+	}
+
+	void updateOpacity(float opacity) {
+		layerData.opacity = opacity;
+		layerDataChanged = true;
+	}
+
+
+	static RenderPassState* getRenderPassState(const LayerBase& base) noexcept {
+		return static_cast<RenderPassState*>(static_cast<const VideoLayer&>(base).getRenderPassState().get());
+	}
+
+	static Utils::BufferView<const vk::DescriptorPoolSize> getDescriptorPoolSizes() noexcept {
+		static const std::array descriptorPoolSizes = {
+			vk::DescriptorPoolSize(
+				vk::DescriptorType::eUniformBufferDynamic,
+				1
+			)
+		};
+
+		return descriptorPoolSizes;
+	}
+
+	static vk::DescriptorSetLayout getDescriptorSetLayout(const Graphics::Vulkan& vulkan) {
+		static const Utils::StaticId id;
+
+		auto result = vulkan.createDescriptorSetLayout(id);
+		if(!result) {
+			//Create the bindings
+			const std::array bindings = {
+				vk::DescriptorSetLayoutBinding(	//Layer data UBO binding
+					vl_LAYER_DATA_BINDING,							//Binding
+					vk::DescriptorType::eUniformBufferDynamic,		//Type
+					1,												//Count
+					vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, //Shader stage
+					nullptr											//Immutable samplers
+				)
+			};
+
+			const vk::DescriptorSetLayoutCreateInfo createInfo(
+				{},
+				bindings.size(), bindings.data()
+			);
+
+			result = vulkan.createDescriptorSetLayout(id, createInfo);
+		}
+
+		assert(result);
+		return result;
+	}
+
+	static Graphics::Vulkan::PooledDescriptorSet allocateDescriptorSet(	const Graphics::Vulkan& vulkan,
+																		const Graphics::UniformRing& uniformRing )
+	{
+		auto result = vulkan.allocateDescriptorSet(getDescriptorSetLayout(vulkan), getDescriptorPoolSizes());
+		assert(result);
+
+		//Recycled sets keep their previous contents, so always write it
+		uniformRing.writeDescriptorSet(vulkan, *result, vl_LAYER_DATA_BINDING, sizeof(LayerData));
+
+		return result;
+	}
+
+	static vk::PipelineLayout getPipelineLayout(const Graphics::Vulkan& vulkan,
+												vk::DescriptorSetLayout frameDescriptorSetLayout )
+	{
+		static std::unordered_map<vk::DescriptorSetLayout, const Utils::StaticId> ids;
+		static std::mutex idsMutex;
+
+		const Utils::StaticId* id;
+		{
+			std::lock_guard<std::mutex> lock(idsMutex);
+			id = &ids[frameDescriptorSetLayout];
+		}
+
+		auto result = vulkan.createPipelineLayout(*id);
+		if(!result) {
+			static_assert(vl_RENDERER_DESCRIPTOR_SET == RendererBase::DESCRIPTOR_SET, "Renderer descriptor set index mismatch");
+			static_assert(vl_PROJECTION_MATRIX_BINDING == RendererBase::DESCRIPTOR_BINDING_PROJECTION_MATRIX, "Projection matrix binding mismatch");
+			const std::array layouts = {
+				RendererBase::getDescriptorSetLayout(vulkan),
+				getDescriptorSetLayout(vulkan),
+				frameDescriptorSetLayout
+			};
+
+			//No push constants, so that it is compatible with the base pipeline layout
+			const vk::PipelineLayoutCreateInfo createInfo(
+				{},													//Flags
+				layouts.size(), layouts.data(),						//Descriptor set layouts
+				0, nullptr											//Push constants
+			);
+
+			result = vulkan.createPipelineLayout(*id, createInfo);
+		}
+
+		assert(result);
+		return result;
+	}
+
+	static vk::Pipeline createPipeline(	const Graphics::Vulkan& vulkan,
+										vk::RenderPass renderPass,
+										const PipelineKey& key )
+	{
+		using Index = std::tuple<vk::RenderPass, PipelineKey>;
+		static std::unordered_map<Index, const Utils::StaticId, Utils::Hasher<Index>> ids;
+		static std::mutex idsMutex;
+
+		const Utils::StaticId* id;
+		{
+			std::lock_guard<std::mutex> lock(idsMutex);
+			id = &ids[Index(renderPass, key)];
+		}
+
+		auto result = vulkan.createGraphicsPipeline(*id);
+		if(!result) {
+			const auto [pipelineLayout, bindless, blendingMode, renderingLayer, samplingMode] = key;
+
+			static //So that its ptr can be used as an identifier
+			#include <video_layer_vert.h>
+			static
+			#include <video_layer_frag.h>
+			static
+			#include <video_layer_bindless_frag.h>
+			const size_t vertId = reinterpret_cast<uintptr_t>(video_layer_vert);
+			const auto fragCode = bindless ? 
+				Utils::BufferView<const uint32_t>(video_layer_bindless_frag) : 
+				Utils::BufferView<const uint32_t>(video_layer_frag) ;
+			const size_t fragId = reinterpret_cast<uintptr_t>(fragCode.data());
+
+			//Try to retrive shader modules from cache
+			auto vertexShader = vulkan.createShaderModule(vertId);
+			if(!vertexShader) {
+				//Module isn't in cache. Create it
+				vertexShader = vulkan.createShaderModule(vertId, video_layer_vert);
+			}
+
+			auto fragmentShader = vulkan.createShaderModule(fragId);
+			if(!fragmentShader) {
+				//Module isn't in cache. Create it
+				fragmentShader = vulkan.createShaderModule(fragId, fragCode);
+			}
+
+			assert(vertexShader);
+			assert(fragmentShader);
+
+
+			//Specialization constants
+			const std::array fragmentShaderSpecializationMap = {
+				vk::SpecializationMapEntry(
+					vl_SAMPLE_MODE_ID,							//Constant id
+					0,											//Offset
+					sizeof(samplingMode)						//Size
+				)
+			};
+			const vk::SpecializationInfo fragmentShaderSpecialization(
+				fragmentShaderSpecializationMap.size(), fragmentShaderSpecializationMap.data(),
+				sizeof(samplingMode), &samplingMode
+			);
+
+			constexpr auto SHADER_ENTRY_POINT = "main";
+			const std::array shaderStages = {
+				vk::PipelineShaderStageCreateInfo(
+					{},											//Flags
+					vk::ShaderStageFlagBits::eVertex,			//Shader type
+					vertexShader,								//Shader handle
+					SHADER_ENTRY_POINT,							//Shader entry point
+					nullptr										//Specialization constants
+				),
+				vk::PipelineShaderStageCreateInfo(
+					{},											//Flags
+					vk::ShaderStageFlagBits::eFragment,			//Shader type
+					fragmentShader,								//Shader handle
+					SHADER_ENTRY_POINT,							//Shader entry point
+					&fragmentShaderSpecialization				//Specialization constants
+				),
+			};
+
+			constexpr vk::PipelineVertexInputStateCreateInfo vertexInput(
+				{},
+				0, nullptr,										//Vertex bindings
+				0, nullptr										//Vertex attributes
+			);
+
+			constexpr vk::PipelineInputAssemblyStateCreateInfo inputAssembly(
+				{},												//Flags
+				vk::PrimitiveTopology::eTriangleStrip,			//Topology
+				false											//Restart enable
+			);
+
+			constexpr vk::PipelineViewportStateCreateInfo viewport(
+				{},												//Flags
+				1, nullptr,										//Viewports (dynamic)
+				1, nullptr										//Scissors (dynamic)
+			);
+
+			constexpr vk::PipelineRasterizationStateCreateInfo rasterizer(
+				{},												//Flags
+				false, 											//Depth clamp enabled
+				false,											//Rasterizer discard enable
+				vk::PolygonMode::eFill,							//Polygon mode
+				vk::CullModeFlagBits::eNone, 					//Cull faces
+				vk::FrontFace::eClockwise,						//Front face direction
+				false, 0.0f, 0.0f, 0.0f,						//Depth bias
+				1.0f											//Line width
+			);
+
+			constexpr vk::PipelineMultisampleStateCreateInfo multisample(
+				{},												//Flags
+				vk::SampleCountFlagBits::e1,					//Sample count
+				false, 1.0f,									//Sample shading enable, min sample shading
+				nullptr,										//Sample mask
+				false, false									//Alpha to coverage, alpha to 1 enable
+			);
+
+			const auto depthStencil = Graphics::getDepthStencilConfiguration(renderingLayer);
+
+			const std::array colorBlendAttachments = {
+				Graphics::getBlendingConfiguration(blendingMode)
+			};
+
+			const vk::PipelineColorBlendStateCreateInfo colorBlend(
+				{},												//Flags
+				false,											//Enable logic operation
+				vk::LogicOp::eCopy,								//Logic operation
+				colorBlendAttachments.size(), colorBlendAttachments.data() //Blend attachments
+			);
+
+			constexpr std::array dynamicStates = {
+				vk::DynamicState::eViewport,
+				vk::DynamicState::eScissor
+			};
+
+			const vk::PipelineDynamicStateCreateInfo dynamicState(
+				{},												//Flags
+				dynamicStates.size(), dynamicStates.data()		//Dynamic states
+			);
+
+			const vk::GraphicsPipelineCreateInfo createInfo(
+				{},												//Flags
+				shaderStages.size(), shaderStages.data(),		//Shader stages
+				&vertexInput,									//Vertex input
+				&inputAssembly,									//Vertex assembly
+				nullptr,										//Tesselation
+				&viewport,										//Viewports
+				&rasterizer,									//Rasterizer
+				&multisample,									//Multisampling
+				&depthStencil,									//Depth / Stencil tests
+				&colorBlend,									//Color blending
+				&dynamicState,									//Dynamic states
+				pipelineLayout,									//Pipeline layout
+				renderPass, 0,									//Renderpasses
+				nullptr, 0										//Inherit
+			);
+
+			result = vulkan.createGraphicsPipeline(*id, createInfo);
+		}
+
+		assert(result);
+		return result;
+	}
+
+};
+
+
+
+/*
+ * VideoLayer
+ */
+
+VideoLayer::VideoLayer(	const Graphics::Vulkan& vulkan,
+						Math::Vec2f size )
+	: LayerBase()
+	, m_impl({}, vulkan, size)
+{
+	m_impl->setup(*this);
+}
+
+VideoLayer::VideoLayer(VideoLayer&& other) = default;
+
+VideoLayer::~VideoLayer() = default;
+
+VideoLayer& VideoLayer::operator=(VideoLayer&& other) = default;
+
+
+
+const Graphics::Vulkan& VideoLayer::getVulkan() const noexcept {
+	return m_impl->getVulkan();
+}
+
+
+void VideoLayer::setSize(Math::Vec2f size) {
+	m_impl->setSize(*this, size);
+}
+
+Math::Vec2f VideoLayer::getSize() const noexcept {
+	return m_impl->getSize();
+}
+
+
+void VideoLayer::setScalingFilter(ScalingFilter filter) {
+	m_impl->setScalingFilter(filter);
+}
+
+ScalingFilter VideoLayer::getScalingFilter() const noexcept {
+	return m_impl->getScalingFilter();
+}
+
+
+void VideoLayer::setVideo(Video video) {
+	m_impl->setVideo(std::move(video));
+}
+
+const Video& VideoLayer::getVideo() const noexcept {
+	return m_impl->getVideo();
+}
+
+}
\ No newline at end of file
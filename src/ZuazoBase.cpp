@@ -21,9 +21,12 @@ struct ZuazoBase::Impl {
 
 	using UpdateCallbacks = std::array<UpdateCallback, COUNT>;
 
+	ZuazoBase*						owner; //Updated when moved
 	Instance& 						instance;
 
 	bool							opened;
+	bool							scheduled;
+	bool							updateOnChange;
 
 	//Callbacks
 	MoveCallback					moveCallback;
@@ -32,22 +35,30 @@ struct ZuazoBase::Impl {
 	CloseCallback					closeCallback;
 	AsyncCloseCallback				asyncCloseCallback;
 	UpdateCallbacks					updateCallbacks;
+	UpdateCallback					scheduledCallback;
+	HasChangedCallback				hasChangedCallback;
 
-	Impl(	Instance& instance, 
+	Impl(	ZuazoBase& owner,
+			Instance& instance, 
 			MoveCallback moveCbk,
 			OpenCallback openCbk,
 			AsyncOpenCallback asyncOpenCbk,
 			CloseCallback closeCbk,
 			AsyncCloseCallback asyncCloseCbk,
 			UpdateCallback updateCbk ) noexcept
-		: instance(instance)
+		: owner(&owner)
+		, instance(instance)
 		, opened(false)
+		, scheduled(false)
+		, updateOnChange(false)
 		, moveCallback(std::move(moveCbk))
 		, openCallback(std::move(openCbk))
 		, asyncOpenCallback(std::move(asyncOpenCbk))
 		, closeCallback(std::move(closeCbk))
 		, asyncCloseCallback(std::move(asyncCloseCbk))
 		, updateCallbacks{ UpdateCallback(), std::move(updateCbk), UpdateCallback() }
+		, scheduledCallback(std::bind(&Impl::update, std::cref(*this)))
+		, hasChangedCallback()
 	{
 	}
 
@@ -55,9 +66,19 @@ struct ZuazoBase::Impl {
 		//Just in case upper class has not unsubscribed from updates
 		disableRegularUpdate();
 		disablePeriodicUpdate();
+		unscheduleLayout();
 	}
 
 	void moved(ZuazoBase& base) {
+		//The layout has been moved, so update the execution plan
+		if(scheduled) {
+			unscheduleLayout();
+			owner = &base;
+			scheduleLayout();
+		} else {
+			owner = &base;
+		}
+
 		Utils::invokeIf(moveCallback, base);
 	}
 
@@ -65,6 +86,7 @@ struct ZuazoBase::Impl {
 	void open(ZuazoBase& base) {
 		if(opened == false) {
 			Utils::invokeIf(openCallback, base);
+			scheduleLayout();
 			opened = true;
 
 			ZUAZO_BASE_LOG(base, Severity::verbose, "Opened");
@@ -84,6 +106,7 @@ struct ZuazoBase::Impl {
 			} else {
 				Utils::invokeIf(openCallback, base);
 			}
+			scheduleLayout();
 			opened = true;
 
 			ZUAZO_BASE_LOG(base, Severity::verbose, "Opened asynchronously");
@@ -97,6 +120,7 @@ struct ZuazoBase::Impl {
 
 	void close(ZuazoBase& base) {
 		if(opened == true) {
+			unscheduleLayout();
 			Utils::invokeIf(closeCallback, base);
 			opened = false;
 
@@ -112,6 +136,7 @@ struct ZuazoBase::Impl {
 		assert(lock.owns_lock());
 
 		if(opened == true) {
+			unscheduleLayout();
 			if(asyncCloseCallback) {
 				asyncCloseCallback(base, lock);
 			} else {
@@ -194,38 +219,84 @@ struct ZuazoBase::Impl {
 
 
 
+	void setUpdateOnChange(bool ena) noexcept {
+		updateOnChange = ena;
+	}
+
+	bool getUpdateOnChange() const noexcept {
+		return updateOnChange;
+	}
+
+	void setHasChangedCallback(HasChangedCallback cbk) noexcept {
+		hasChangedCallback = std::move(cbk);
+	}
+
+	const HasChangedCallback& getHasChangedCallback() const noexcept {
+		return hasChangedCallback;
+	}
+
+
+
 	void update() const noexcept {
+		//Unchanged elements keep their last outputs
+		if(updateOnChange && !hasChanged()) {
+			return;
+		}
+
 		for(const auto& cbk : updateCallbacks) {
 			Utils::invokeIf(cbk);
 		}
 	}
 
+	Instance::CallbackStatistics getUpdateStatistics() const noexcept {
+		return getInstance().getCallbackStatistics(scheduledCallback);
+	}
+
+	//A single callback is scheduled, so that the pre-update, update and 
+	//post-update stages of an element are never executed concurrently
 	void enableRegularUpdate(Instance::Priority prior) const {
-		for(const auto& cbk : updateCallbacks) {
-			getInstance().addRegularCallback(cbk, prior);
-		}
+		getInstance().addRegularCallback(scheduledCallback, prior);
 	}
 
 	void disableRegularUpdate() const noexcept {
-		for(const auto& cbk : updateCallbacks) {
-			getInstance().removeRegularCallback(cbk);
-		}
+		getInstance().removeRegularCallback(scheduledCallback);
 	}
 
 	void enablePeriodicUpdate(	Instance::Priority prior, 
 								Duration period) const 
 	{
-		for(const auto& cbk : updateCallbacks) {
-			getInstance().addPeriodicCallback(cbk, prior, period);
-		}
+		getInstance().addPeriodicCallback(scheduledCallback, prior, period);
+	}
+
+	void enablePeriodicUpdate(	Instance::Priority prior, 
+								Rate rate) const 
+	{
+		getInstance().addPeriodicCallback(scheduledCallback, prior, rate);
 	}
 
 	void disablePeriodicUpdate() const noexcept {
-		for(const auto& cbk : updateCallbacks) {
-			getInstance().removePeriodicCallback(cbk);
+		getInstance().removePeriodicCallback(scheduledCallback);
+	}
+
+	//The outputs of opened elements are evaluated by the instance's execution plan
+	void scheduleLayout() {
+		assert(!scheduled);
+		getInstance().scheduleLayout(*owner);
+		scheduled = true;
+	}
+
+	void unscheduleLayout() noexcept {
+		if(scheduled) {
+			getInstance().unscheduleLayout(*owner);
+			scheduled = false;
 		}
 	}
 
+	bool hasChanged() const {
+		assert(owner);
+		return owner->inputsHaveChanged() || (hasChangedCallback && hasChangedCallback(*owner));
+	}
+
 };
 
 
@@ -244,7 +315,7 @@ ZuazoBase::ZuazoBase(	Instance& instance,
 						AsyncCloseCallback asyncCloseCbk,
 						UpdateCallback updateCbk )
 	: Signal::Layout(std::move(name), pads.begin(), pads.end())
-	, m_impl({}, instance, std::move(moveCbk), std::move(openCbk), std::move(asyncOpenCbk), std::move(closeCbk), std::move(asyncCloseCbk), std::move(updateCbk))
+	, m_impl({}, *this, instance, std::move(moveCbk), std::move(openCbk), std::move(asyncOpenCbk), std::move(closeCbk), std::move(asyncCloseCbk), std::move(updateCbk))
 {
 	ZUAZO_BASE_LOG(*this, Severity::verbose, "Constructed");
 }
@@ -334,6 +405,12 @@ const ZuazoBase::UpdateCallback& ZuazoBase::getPostUpdateCallback() const noexce
 
 
 
+Instance::CallbackStatistics ZuazoBase::getUpdateStatistics() const noexcept {
+	return m_impl->getUpdateStatistics();
+}
+
+
+
 void ZuazoBase::setMoveCallback(MoveCallback cbk) noexcept {
 	m_impl->setMoveCallback(std::move(cbk));
 }
@@ -362,6 +439,24 @@ const ZuazoBase::CloseCallback& ZuazoBase::getCloseCallback() const noexcept {
 
 
 
+void ZuazoBase::setUpdateOnChange(bool ena) noexcept {
+	m_impl->setUpdateOnChange(ena);
+}
+
+bool ZuazoBase::getUpdateOnChange() const noexcept {
+	return m_impl->getUpdateOnChange();
+}
+
+void ZuazoBase::setHasChangedCallback(HasChangedCallback cbk) noexcept {
+	m_impl->setHasChangedCallback(std::move(cbk));
+}
+
+const ZuazoBase::HasChangedCallback& ZuazoBase::getHasChangedCallback() const noexcept {
+	return m_impl->getHasChangedCallback();
+}
+
+
+
 void ZuazoBase::update() const noexcept {
 	m_impl->update();
 }
@@ -380,6 +475,12 @@ void ZuazoBase::enablePeriodicUpdate(	Instance::Priority prior,
 	m_impl->enablePeriodicUpdate(prior, period);
 }
 
+void ZuazoBase::enablePeriodicUpdate(	Instance::Priority prior, 
+										Rate rate) const 
+{
+	m_impl->enablePeriodicUpdate(prior, rate);
+}
+
 void ZuazoBase::disablePeriodicUpdate() const noexcept {
 	m_impl->disablePeriodicUpdate();
 }